@@ -1517,6 +1517,120 @@ eval_l_getter (purc_variant_t root, size_t nr_args, purc_variant_t *argv,
             (call_flags & PCVRT_CALL_FLAG_SILENTLY));
 }
 
+/* the type of a packed array given by the optional argument at `idx`:
+   'f64' (the default), 'i64', or 'u64' */
+static bool
+get_packed_type (size_t nr_args, purc_variant_t *argv, size_t idx,
+        pcvrnt_packed_type_k *type)
+{
+    *type = PCVRNT_PACKED_TYPE_F64;
+    if (nr_args <= idx)
+        return true;
+
+    const char *name = purc_variant_get_string_const (argv[idx]);
+    if (name == NULL) {
+        purc_set_error (PURC_ERROR_WRONG_DATA_TYPE);
+        return false;
+    }
+
+    if (strcmp (name, "f64") == 0)
+        *type = PCVRNT_PACKED_TYPE_F64;
+    else if (strcmp (name, "i64") == 0)
+        *type = PCVRNT_PACKED_TYPE_I64;
+    else if (strcmp (name, "u64") == 0)
+        *type = PCVRNT_PACKED_TYPE_U64;
+    else {
+        purc_set_error (PURC_ERROR_INVALID_VALUE);
+        return false;
+    }
+
+    return true;
+}
+
+static purc_variant_t
+internal_reduce_getter (pcvrnt_reduce_op_k op, size_t nr_args,
+        purc_variant_t *argv)
+{
+    double number = 0.0;
+
+    GET_PARAM_NUMBER(1);
+
+    /* a byte sequence is a packed array */
+    if (purc_variant_is_bsequence (argv[0])) {
+        pcvrnt_packed_type_k type;
+        if (!get_packed_type (nr_args, argv, 1, &type) ||
+                !purc_variant_packed_reduce (argv[0], type, op, &number))
+            return PURC_VARIANT_INVALID;
+    }
+    else if (!purc_variant_numeric_reduce (argv[0], op, &number))
+        return PURC_VARIANT_INVALID;
+
+    return purc_variant_make_number (number);
+}
+
+static purc_variant_t
+sum_getter (purc_variant_t root, size_t nr_args, purc_variant_t *argv,
+        unsigned call_flags)
+{
+    UNUSED_PARAM(root);
+    UNUSED_PARAM(call_flags);
+
+    return internal_reduce_getter(PCVRNT_REDUCE_OP_SUM, nr_args, argv);
+}
+
+static purc_variant_t
+min_getter (purc_variant_t root, size_t nr_args, purc_variant_t *argv,
+        unsigned call_flags)
+{
+    UNUSED_PARAM(root);
+    UNUSED_PARAM(call_flags);
+
+    return internal_reduce_getter(PCVRNT_REDUCE_OP_MIN, nr_args, argv);
+}
+
+static purc_variant_t
+max_getter (purc_variant_t root, size_t nr_args, purc_variant_t *argv,
+        unsigned call_flags)
+{
+    UNUSED_PARAM(root);
+    UNUSED_PARAM(call_flags);
+
+    return internal_reduce_getter(PCVRNT_REDUCE_OP_MAX, nr_args, argv);
+}
+
+static purc_variant_t
+avg_getter (purc_variant_t root, size_t nr_args, purc_variant_t *argv,
+        unsigned call_flags)
+{
+    UNUSED_PARAM(root);
+    UNUSED_PARAM(call_flags);
+
+    return internal_reduce_getter(PCVRNT_REDUCE_OP_MEAN, nr_args, argv);
+}
+
+static purc_variant_t
+dot_getter (purc_variant_t root, size_t nr_args, purc_variant_t *argv,
+        unsigned call_flags)
+{
+    UNUSED_PARAM(root);
+    UNUSED_PARAM(call_flags);
+
+    double number = 0.0;
+
+    GET_PARAM_NUMBER(2);
+
+    if (purc_variant_is_bsequence (argv[0])) {
+        pcvrnt_packed_type_k type;
+        if (!get_packed_type (nr_args, argv, 2, &type) ||
+                !purc_variant_packed_dot (argv[0], argv[1], type, &number))
+            return PURC_VARIANT_INVALID;
+    }
+    else if (!purc_variant_numeric_dot (argv[0], argv[1], &number))
+        return PURC_VARIANT_INVALID;
+
+    return purc_variant_make_number (number);
+}
+
 static void * map_copy_key(const void *key)
 {
     return (void*)key;
@@ -1666,6 +1780,11 @@ static purc_variant_t pcdvobjs_create_math (void)
         {"sub",     sub_getter, NULL},
         {"mul",     mul_getter, NULL},
         {"div",     div_getter, NULL},
+        {"sum",     sum_getter, NULL},
+        {"min",     min_getter, NULL},
+        {"max",     max_getter, NULL},
+        {"avg",     avg_getter, NULL},
+        {"dot",     dot_getter, NULL},
     };
 
     return purc_dvobj_make_from_methods (method, PCA_TABLESIZE(method));
@@ -498,6 +498,98 @@ curator_getter(purc_variant_t root,
     return purc_variant_make_ulongint(cor->curator);
 }
 
+static const char *sched_class_names[] = {
+    PURC_SCHED_CLASS_NAME_INTERACTIVE,
+    PURC_SCHED_CLASS_NAME_NORMAL,
+    PURC_SCHED_CLASS_NAME_BATCH,
+};
+
+/* Make sure the number of class names matches the number of classes */
+#define _COMPILE_TIME_ASSERT(name, x)               \
+       typedef int _dummy_ ## name[(x) * 2 - 1]
+_COMPILE_TIME_ASSERT(sched_classes,
+        PCA_TABLESIZE(sched_class_names) == PURC_NR_SCHED_CLASSES);
+#undef _COMPILE_TIME_ASSERT
+
+static purc_variant_t
+sched_class_getter(purc_variant_t root,
+        size_t nr_args, purc_variant_t *argv, unsigned call_flags)
+{
+    UNUSED_PARAM(nr_args);
+    UNUSED_PARAM(argv);
+    UNUSED_PARAM(call_flags);
+
+    pcintr_coroutine_t cor = hvml_ctrl_coroutine(root);
+    return purc_variant_make_string_static(
+            sched_class_names[cor->sched_class], false);
+}
+
+static purc_variant_t
+sched_class_setter(purc_variant_t root,
+        size_t nr_args, purc_variant_t *argv, unsigned call_flags)
+{
+    const char *name;
+    if (nr_args < 1) {
+        purc_set_error(PURC_ERROR_ARGUMENT_MISSED);
+        goto failed;
+    }
+
+    if ((name = purc_variant_get_string_const(argv[0])) == NULL) {
+        purc_set_error(PURC_ERROR_WRONG_DATA_TYPE);
+        goto failed;
+    }
+
+    pcintr_coroutine_t cor = hvml_ctrl_coroutine(root);
+    for (size_t i = 0; i < PCA_TABLESIZE(sched_class_names); i++) {
+        if (strcmp(name, sched_class_names[i]) == 0) {
+            purc_coroutine_set_sched_class(cor, (purc_sched_class_k)i);
+            return purc_variant_make_boolean(true);
+        }
+    }
+
+    purc_set_error(PURC_ERROR_INVALID_VALUE);
+
+failed:
+    if (call_flags & PCVRT_CALL_FLAG_SILENTLY)
+        return purc_variant_make_boolean(false);
+    return PURC_VARIANT_INVALID;
+}
+
+static purc_variant_t
+sched_stat_getter(purc_variant_t root,
+        size_t nr_args, purc_variant_t *argv, unsigned call_flags)
+{
+    UNUSED_PARAM(nr_args);
+    UNUSED_PARAM(argv);
+    UNUSED_PARAM(call_flags);
+
+    pcintr_coroutine_t cor = hvml_ctrl_coroutine(root);
+    struct purc_coroutine_sched_stat *stat = &cor->sched_stat;
+
+    purc_variant_t ret = purc_variant_make_object(0,
+            PURC_VARIANT_INVALID, PURC_VARIANT_INVALID);
+    if (ret == PURC_VARIANT_INVALID)
+        return PURC_VARIANT_INVALID;
+
+    static const char *keys[] = {
+        "ready_time", "max_ready_time", "run_time", "nr_slices" };
+    purc_variant_t vals[] = {
+        purc_variant_make_number(stat->ready_time),
+        purc_variant_make_number(stat->max_ready_time),
+        purc_variant_make_number(stat->run_time),
+        purc_variant_make_ulongint(stat->nr_slices),
+    };
+
+    for (size_t i = 0; i < PCA_TABLESIZE(vals); i++) {
+        if (vals[i]) {
+            purc_variant_object_set_by_static_ckey(ret, keys[i], vals[i]);
+            purc_variant_unref(vals[i]);
+        }
+    }
+
+    return ret;
+}
+
 purc_variant_t
 purc_dvobj_coroutine_new(pcintr_coroutine_t cor)
 {
@@ -518,6 +610,8 @@ purc_dvobj_coroutine_new(pcintr_coroutine_t cor)
         { "uri",     uri_getter,     NULL },
         { "token",   token_getter,   token_setter },
         { "curator", curator_getter, NULL },
+        { "sched_class", sched_class_getter, sched_class_setter },
+        { "sched_stat",  sched_stat_getter,  NULL },
     };
 
     retv = purc_dvobj_make_from_methods(method, PCA_TABLESIZE(method));
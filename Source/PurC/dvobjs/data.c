@@ -131,6 +131,17 @@ arith_getter(purc_variant_t root, size_t nr_args, purc_variant_t *argv,
         goto failed;
     }
 
+    /* element-wise on whole arrays, tuples, or packed arrays of longints */
+    if (purc_variant_is_array(argv[1]) || purc_variant_is_tuple(argv[1]) ||
+            purc_variant_is_bsequence(argv[1]) ||
+            purc_variant_is_array(argv[2]) || purc_variant_is_tuple(argv[2]) ||
+            purc_variant_is_bsequence(argv[2])) {
+        purc_variant_t retv = pcvariant_numeric_arith(op[0], argv[1], argv[2]);
+        if (retv == PURC_VARIANT_INVALID)
+            goto failed;
+        return retv;
+    }
+
     int64_t l_operand, r_operand;
     if (!purc_variant_cast_to_longint(argv[1], &l_operand, true) ||
             !purc_variant_cast_to_longint(argv[2], &r_operand, true)) {
@@ -1930,13 +1941,16 @@ shuffle_getter(purc_variant_t root, size_t nr_args, purc_variant_t *argv,
         goto failed;
     }
 
+    if (purc_variant_is_frozen(argv[0])) {
+        purc_set_error(PURC_ERROR_ACCESS_DENIED);
+        goto failed;
+    }
+
     if (purc_variant_is_array(argv[0])) {
         ssize_t sz = purc_variant_array_get_size(argv[0]);
 
         if (sz > 1) {
-            struct pcutils_array_list *al = variant_array_get_data(argv[0]);
-            struct pcutils_array_list_node *p;
-            array_list_for_each(al, p) {
+            for (ssize_t idx = 0; idx < sz; idx++) {
 
                 size_t new_idx;
                 if (sz < RAND_MAX) {
@@ -1947,8 +1961,8 @@ shuffle_getter(purc_variant_t root, size_t nr_args, purc_variant_t *argv,
                     new_idx = new_idx * sz / RAND_MAX;
                 }
 
-                if (new_idx != p->idx)
-                    pcutils_array_list_swap(al, p->idx, new_idx);
+                if (new_idx != (size_t)idx)
+                    pcvariant_array_swap(argv[0], idx, new_idx);
             }
         }
     }
@@ -2167,13 +2181,18 @@ sort_getter(purc_variant_t root, size_t nr_args, purc_variant_t *argv,
     }
 
     /* use the default variant comparison function */
+    int ret;
     if (purc_variant_is_array(argv[0])) {
-        pcvariant_array_sort(argv[0], (void *)sort_opt, NULL);
+        ret = pcvariant_array_sort(argv[0], (void *)sort_opt, NULL);
     }
     else {
-        pcvariant_set_sort(argv[0], (void *)sort_opt, NULL);
+        ret = pcvariant_set_sort(argv[0], (void *)sort_opt, NULL);
     }
 
+    /* a frozen container cannot be sorted */
+    if (ret < 0)
+        goto failed;
+
 done:
     return purc_variant_ref(argv[0]);
 
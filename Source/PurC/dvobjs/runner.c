@@ -247,6 +247,60 @@ failed:
     return PURC_VARIANT_INVALID;
 }
 
+static purc_variant_t
+chansel_getter(purc_variant_t root, size_t nr_args, purc_variant_t *argv,
+        unsigned call_flags)
+{
+    UNUSED_PARAM(root);
+
+    pcchan_t *chans = NULL;
+    if (nr_args < 1) {
+        pcinst_set_error(PURC_ERROR_ARGUMENT_MISSED);
+        goto failed;
+    }
+
+    chans = malloc(sizeof(pcchan_t) * nr_args);
+    if (chans == NULL) {
+        pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
+        goto failed;
+    }
+
+    for (size_t i = 0; i < nr_args; i++) {
+        const char *chan_name;
+        chan_name = purc_variant_get_string_const(argv[i]);
+        if (chan_name == NULL) {
+            pcinst_set_error(PURC_ERROR_WRONG_DATA_TYPE);
+            goto failed;
+        }
+
+        chans[i] = pcchan_retrieve(chan_name);
+        if (chans[i] == NULL) {
+            // error set by pcchan_retrieve()
+            goto failed;
+        }
+    }
+
+    pcchan_t chan = pcchan_select(chans, nr_args, call_flags);
+    free(chans);
+    if (chan) {
+        return purc_variant_make_string(chan->name, false);
+    }
+
+    if (purc_get_last_error() == PURC_ERROR_AGAIN) {
+        return PURC_VARIANT_INVALID;
+    }
+    chans = NULL;
+
+failed:
+    if (chans)
+        free(chans);
+
+    if (call_flags & PCVRT_CALL_FLAG_SILENTLY)
+        return purc_variant_make_undefined();
+
+    return PURC_VARIANT_INVALID;
+}
+
 purc_variant_t
 purc_dvobj_runner_new(void)
 {
@@ -259,6 +313,7 @@ purc_dvobj_runner_new(void)
         { "rid",    rid_getter,     NULL },
         { "uri",    uri_getter,     NULL },
         { "chan",   chan_getter,    chan_setter },
+        { "chansel", chansel_getter, NULL },
 #if ENABLE(CHINESE_NAMES)
         { "用户",   user_getter,    user_setter },
         { "应用名", app_getter,     NULL },
@@ -266,6 +321,7 @@ purc_dvobj_runner_new(void)
         { "行者标识符", rid_getter,     NULL },
         { "统一资源标识符",    uri_getter,     NULL },
         { "通道",   chan_getter,    chan_setter },
+        { "通道选择", chansel_getter, NULL },
 #endif
     };
 
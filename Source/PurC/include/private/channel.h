@@ -36,15 +36,19 @@ struct pcchan {
     /* the name of the channel */
     char           *name;
 
-    /* size of the circular queue */
+    /* capability of the channel */
     unsigned int    qsize;
     /* total variants in the queue */
     unsigned int    qcount;
 
+    /* mask of the ring buffer; the ring has (mask + 1) slots, which is
+       the smallest power of two not less than the capability. */
+    unsigned int    mask;
+
     /* reference count: the channel entity variants bound to this channel */
     unsigned int    refc;
 
-    /* indices to send and receive */
+    /* free-running indices to send and receive; the slot is (x & mask). */
     unsigned int    sendx;
     unsigned int    recvx;
 
@@ -54,7 +58,10 @@ struct pcchan {
     /* list of coroutines waiting to receive */
     struct list_head recv_crtns;
 
-    /* the buffer for variants. */
+    /* list of coroutines waiting to receive from this or other channels */
+    struct list_head selectors;
+
+    /* the ring buffer for variants. */
     purc_variant_t  *data;
 };
 
@@ -77,6 +84,13 @@ pcchan_destroy(pcchan_t chan) WTF_INTERNAL;
 purc_variant_t
 pcchan_make_entity(pcchan_t chan) WTF_INTERNAL;
 
+/* Returns the first channel in @chans which has data to receive. If there is
+   no such channel, stops the current coroutine until one of them has data,
+   and returns NULL with the error PURC_ERROR_AGAIN. */
+pcchan_t
+pcchan_select(pcchan_t *chans, size_t nr_chans,
+        unsigned call_flags) WTF_INTERNAL;
+
 static inline unsigned int
 pcchan_capability(pcchan_t chan) {
     return chan->qsize;
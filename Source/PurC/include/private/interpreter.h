@@ -40,6 +40,7 @@
 #include "private/vdom.h"
 #include "private/timer.h"
 #include "private/sorted-array.h"
+#include "private/timer-wheel.h"
 
 #define PCINTR_MOVE_BUFFER_SIZE 64
 #define CRTN_TOKEN_LEN          15
@@ -117,6 +118,29 @@ struct pcintr_cancel {
     struct list_head             node;
 };
 
+/* the element contexts are cached in size classes of PCINTR_CTXT_GRAIN */
+#define PCINTR_CTXT_GRAIN           32
+#define PCINTR_CTXT_NR_CLASSES      16
+#define PCINTR_CTXT_POOL_DEPTH      32
+/* the max number of released stack frames kept by a stack for reuse */
+#define PCINTR_FRAME_POOL_DEPTH     16
+/* the number of the resolved named variables cached by a stack */
+#define PCINTR_NR_VAR_SLOTS         64
+
+/* the default time slices (in seconds) of the scheduling classes */
+#define PCINTR_TIME_SLICE_INTERACTIVE   0.002
+#define PCINTR_TIME_SLICE_NORMAL        0.005
+#define PCINTR_TIME_SLICE_BATCH         0.010
+/* a ready coroutine gains one class of priority per this period (seconds) */
+#define PCINTR_SCHED_AGING_PERIOD       0.020
+
+struct pcintr_alloc_stat {
+    size_t              nr_frames_allocated;
+    size_t              nr_frames_reused;
+    size_t              nr_ctxts_allocated;
+    size_t              nr_ctxts_reused;
+};
+
 struct pcintr_heap {
     // owner instance
     struct pcinst      *owner;
@@ -126,13 +150,45 @@ struct pcintr_heap {
 
     struct list_head    crtns;
     struct list_head    stopped_crtns;
-    struct sorted_array *wait_timeout_crtns;
+
+    // wait timeouts of coroutines and the timers in $TIMERS and <sleep>
+    struct pcutils_twheel timer_wheel;
+
+    // coroutines in READY state per scheduling class;
+    // linked by pcintr_coroutine::ln_ready
+    struct list_head    ready_crtns[PURC_NR_SCHED_CLASSES];
+    // the time slices of the scheduling classes in seconds
+    double              time_slices[PURC_NR_SCHED_CLASSES];
+    // coroutines having pending messages or tasks;
+    // linked by pcintr_coroutine::ln_event
+    struct list_head    event_crtns;
+    // coroutines observing the idle event;
+    // linked by pcintr_coroutine::ln_idle
+    struct list_head    idle_crtns;
+    // the number of the idle observers of all coroutines
+    size_t              nr_idle_observers;
+    // coroutines observing expression variables;
+    // linked by pcintr_coroutine::ln_vcm_ev
+    struct list_head    vcm_ev_crtns;
+    // the number of the observers of expression variables of all coroutines
+    size_t              nr_vcm_ev_observers;
 
     pcutils_map        *name_chan_map;  // name to channel map.
     pcutils_map        *token_crtn_map; // token to crtn map.
 
     purc_atom_t         move_buff;
-    pcintr_timer_t     *event_timer;    // 10ms
+    // re-evaluates the observed expression variables every 10ms;
+    // exists only while there are such observers
+    pcintr_timer_t     *event_timer;
+
+    // the fd of renderer connection monitored to wake up the scheduler
+    int                 conn_fd;
+    uintptr_t           conn_monitor;
+
+    // released element contexts kept for reuse; see pcintr_ctxt_alloc()
+    struct list_head    ctxt_pool[PCINTR_CTXT_NR_CLASSES];
+    size_t              nr_pooled_ctxts[PCINTR_CTXT_NR_CLASSES];
+    struct pcintr_alloc_stat alloc_stat;
 
     purc_cond_handler   cond_handler;
     unsigned int        keep_alive:1;
@@ -189,11 +245,48 @@ struct pcintr_exception {
     struct pcdebug_backtrace  *bt;
 };
 
+#define PCINTR_MIN_OBSERVER_BUCKETS     8
+
+/* the observers of a stack bucketed by the atom of the event type;
+   the bucket table is allocated on demand and doubles in size when the
+   number of bucketed observers exceeds twice the number of buckets */
+struct pcintr_observer_index {
+    struct list_head             *buckets;
+    /* the number of buckets: zero or a power of two */
+    size_t                        nr_buckets;
+    size_t                        nr_bucketed;
+    /* not zero while dispatching an event; the table is not grown then */
+    unsigned                      dispatching;
+    /* the observers using a customized matching function */
+    struct list_head              wildcard;
+};
+
+static inline struct list_head *
+pcintr_observer_index_bucket(struct pcintr_observer_index *index,
+        purc_atom_t type_atom)
+{
+    if (index->nr_buckets == 0)
+        return NULL;
+    return &index->buckets[type_atom & (index->nr_buckets - 1)];
+}
+
 struct pcintr_stack {
     struct list_head              frames;
     // the number of stack frames.
     size_t                        nr_frames;
 
+    // popped normal frames kept for reuse; linked by pcintr_stack_frame::node
+    struct list_head              frame_pool;
+    size_t                        nr_pooled_frames;
+
+    // the resolutions of named variables indexed by the site;
+    // see pcintr_find_named_var_at_site()
+    struct pcintr_var_slot       *var_slots;
+
+    // anchor -> the innermost frame having the anchor;
+    // see pcintr_find_anchor_symbolized_var()
+    pcutils_map                  *anchor_index;
+
     // the pointer to the vDOM tree.
     purc_vdom_t                   vdom;
     purc_document_t               doc;
@@ -214,10 +307,14 @@ struct pcintr_stack {
     uint32_t volatile             last_msg_sent:1;
     uint32_t volatile             last_msg_read:1;
     /* uint32_t                   paused:1; */
-    uint32_t                      observe_idle:1;
     uint32_t                      terminated:1;
     uint32_t                      inherit:1;
 
+    // the number of observers of the idle event on $CRTN
+    size_t                        nr_idle_observers;
+    // the number of observers of expression variables
+    size_t                        nr_vcm_ev_observers;
+
     // error or except info
     // valid only when except == 1
     struct pcintr_exception       exception;
@@ -245,6 +342,11 @@ struct pcintr_stack {
     /* create by hvml <observe on...> */
     struct list_head              hvml_observers;
 
+    /* the observers above indexed by the event type */
+    struct pcintr_observer_index  intr_observer_index;
+    struct pcintr_observer_index  hvml_observer_index;
+    unsigned long                 observer_seq;
+
     // async request ids (array)
     purc_variant_t                async_request_ids;
 
@@ -306,6 +408,10 @@ struct pcintr_coroutine {
 
     struct rb_node              node;     /* heap::coroutines */
     struct list_head            ln;       /* heap::crtns, stopped_crtns */
+    struct list_head            ln_ready; /* heap::ready_crtns */
+    struct list_head            ln_event; /* heap::event_crtns */
+    struct list_head            ln_idle;  /* heap::idle_crtns */
+    struct list_head            ln_vcm_ev; /* heap::vcm_ev_crtns */
 
     struct list_head            children; /* struct pcintr_coroutine_child */
 
@@ -315,6 +421,11 @@ struct pcintr_coroutine {
 
     enum pcintr_coroutine_stage stage;
     enum pcintr_coroutine_state state;
+
+    purc_sched_class_k          sched_class;
+    /* the time when the coroutine became ready */
+    struct timespec             ready_since;
+    struct purc_coroutine_sched_stat sched_stat;
     int                         waits;  /* FIXME: nr of registered events */
 
     struct list_head            ln_stopped;
@@ -353,6 +464,7 @@ struct pcintr_coroutine {
     void                       *user_data;
     unsigned long               run_idx;
     time_t                      stopped_timeout;
+    struct pcutils_twheel_node  timeout_node; /* heap::timer_wheel */
 
     uint32_t                    is_main:1;
 };
@@ -453,8 +565,17 @@ struct pcintr_stack_frame {
     /* element id attr value */
     purc_variant_t    elem_id;
 
+    /* the constant anchor (without `#`) indexed in
+       pcintr_stack::anchor_index; `anchor_shadowed` is the outer frame
+       indexed by the same anchor */
+    const char                 *anchor;
+    struct pcintr_stack_frame  *anchor_shadowed;
+
     unsigned int       silently:1;
     unsigned int       must_yield:1;
+    unsigned int       anchor_indexed:1;
+    /* the anchor is not constant; it is evaluated at every lookup */
+    unsigned int       anchor_dynamic:1;
 
     enum pcintr_stack_frame_eval_step eval_step;
     enum pcintr_element_step elem_step;
@@ -485,6 +606,12 @@ enum pcintr_observer_source {
 
 struct pcintr_observer {
     struct list_head            node;
+    /* pcintr_observer_index::buckets or pcintr_observer_index::wildcard */
+    struct list_head            ln_index;
+    /* whether ln_index is linked in a bucket */
+    bool                        bucketed;
+    /* the order of registration in the stack */
+    unsigned long               seq;
 
     enum pcintr_observer_source source;
     int                         cor_stage;
@@ -517,6 +644,10 @@ struct pcintr_observer {
     observer_handle_fn  handle;
     void               *handle_data;
     bool                auto_remove;
+    // whether this observer observes the idle event on $CRTN
+    bool                observe_idle;
+    // whether this observer observes an expression variable
+    bool                observe_vcm_ev;
     uint64_t            timestamp;
 };
 
@@ -532,6 +663,11 @@ struct pcintr_heap* pcintr_get_heap(void);
 
 pcintr_stack_t pcintr_get_stack(void);
 pcintr_coroutine_t pcintr_get_coroutine(void);
+
+/* allocate a zeroed element context of `size` bytes from the cache of
+   the current interpreter heap; release it with pcintr_ctxt_free(). */
+void *pcintr_ctxt_alloc(size_t size) WTF_INTERNAL;
+void pcintr_ctxt_free(void *ctxt, size_t size) WTF_INTERNAL;
 // NOTE: null if current thread not initialized with purc_init
 purc_runloop_t pcintr_get_runloop(void);
 
@@ -540,6 +676,8 @@ void pcintr_stop_coroutine(pcintr_coroutine_t crtn,
         const struct timespec *timeout) WTF_INTERNAL;
 /* resume the specific coroutine */
 void pcintr_resume_coroutine(pcintr_coroutine_t crtn) WTF_INTERNAL;
+/* resume the coroutine whose wait timed out; used by the timer wheel */
+void pcintr_on_coroutine_timeout(struct pcutils_twheel_node *node) WTF_INTERNAL;
 
 void pcintr_check_after_execution(void);
 void pcintr_set_current_co_with_location(pcintr_coroutine_t co,
@@ -642,6 +780,31 @@ pcintr_get_scope_variable(purc_coroutine_t cor, pcvdom_element_t elem,
 purc_variant_t
 pcintr_find_named_var(pcintr_stack_t stack, const char* name);
 
+#define PCINTR_VAR_SLOT_NAME_MAX    31
+
+/* the resolution of a named variable referred by a `getVariable` VCM node
+   (the site); it is valid as long as no variable is bound or unbound in
+   the thread (see pcvarmgr_binding_epoch()) and the scope walk from
+   the bottom frame visits the same vDOM elements. */
+struct pcintr_var_slot {
+    const void             *site;
+    unsigned long           epoch;
+    // the first element of the scope walk
+    pcvdom_element_t        start;
+    // the number of the elements visited by the scope walk
+    size_t                  depth;
+    // the variable is bound at the scope level or not
+    bool                    in_scope;
+    pcvarmgr_t              mgr;
+    char                    name[PCINTR_VAR_SLOT_NAME_MAX + 1];
+};
+
+/* the same as pcintr_find_named_var(), but the resolution for the `site`
+   is cached in the variable slots of the stack and reused. */
+purc_variant_t
+pcintr_find_named_var_at_site(pcintr_stack_t stack, const char* name,
+        const void *site);
+
 purc_variant_t
 pcintr_get_symbolized_var (pcintr_stack_t stack, unsigned int number,
         char symbol);
@@ -650,6 +813,11 @@ purc_variant_t
 pcintr_find_anchor_symbolized_var(pcintr_stack_t stack, const char *anchor,
         char symbol);
 
+/* remove the anchor of a frame to be popped from the anchor index */
+void
+pcintr_unindex_frame_anchor(pcintr_stack_t stack,
+        struct pcintr_stack_frame *frame);
+
 int
 pcintr_unbind_named_var(pcintr_stack_t stack, const char *name);
 
@@ -719,6 +887,10 @@ void
 pcintr_revoke_observer_ex(pcintr_stack_t stack, purc_variant_t observed,
         purc_atom_t msg_type_atom, const char *sub_type);
 
+void
+pcintr_observe_vcm_ev(pcintr_stack_t stack, struct pcintr_observer* observer,
+        purc_variant_t var, struct purc_native_ops *ops);
+
 bool
 pcintr_load_dynamic_variant(pcintr_coroutine_t cor,
     const char *name, size_t len);
@@ -805,6 +977,24 @@ pcintr_coroutine_get_uri(pcintr_coroutine_t co)
 void
 pcintr_schedule(void *ctxt);
 
+/* wake up the scheduler of the instance which owns the runloop when
+ * the file descriptor becomes readable */
+uintptr_t
+pcintr_monitor_fd_for_scheduler(purc_runloop_t runloop, int fd);
+
+/* the monotonic time in milliseconds used by the timer wheel of the heap */
+time_t
+pcintr_monotonic_time_ms(void);
+
+/* put the coroutine to the pending event queue of the heap */
+void
+pcintr_coroutine_mark_event_pending(pcintr_coroutine_t co);
+
+/* append the message to the queue of the coroutine and mark
+ * the coroutine as having pending events */
+int
+pcintr_coroutine_append_msg(pcintr_coroutine_t co, pcrdr_msg *msg);
+
 void
 pcintr_coroutine_set_result(pcintr_coroutine_t co, purc_variant_t result);
 
@@ -30,6 +30,7 @@
 #include "config.h"
 
 #include <stdatomic.h>
+#include <stddef.h>
 
 #include "private/list.h"
 #include "purc-pcrdr.h"
@@ -39,18 +40,47 @@
 #define MSG_QS_EVENT    0x40000000
 #define MSG_QS_VOID     0x80000000
 
+/* the initial number of buckets of the event index; must be power of 2 */
+#define MSG_QUEUE_EVENT_BUCKETS_MIN     16
+
 struct pcinst_msg_hdr {
     atomic_uint             owner;
-    struct list_head        ln;
+    union {
+        struct list_head    ln;
+        /* the next message in the lock-free inbox of the queue */
+        struct pcinst_msg_hdr *_Atomic next;
+    };
+    /* the bucket of the event index if the message is in `event_msgs` */
+    struct list_head        ln_hash;
 };
 
+/*
+ * When ENABLE(LOCKFREE_MSG_QUEUE), the producers push the messages to
+ * an intrusive MPSC inbox (Dmitry Vyukov's algorithm) without any lock,
+ * and the consumer moves them to the lists in batch before it takes or
+ * counts messages. Only the owner of the queue can prepend, take, or count
+ * messages then.
+ */
 struct pcinst_msg_queue {
+#if ENABLE(LOCKFREE_MSG_QUEUE)
+    struct pcinst_msg_hdr *_Atomic inbox_head;
+    struct pcinst_msg_hdr *inbox_tail;
+    struct pcinst_msg_hdr  inbox_stub;
+#else
     struct purc_rwlock  lock;
+#endif
     struct list_head    req_msgs;
     struct list_head    res_msgs;
     struct list_head    event_msgs;
     struct list_head    void_msgs;
 
+    /* the messages in `event_msgs` hashed by (target, targetValue,
+       eventName, elementValue) to find the event to reduce;
+       the order in a bucket follows the order in `event_msgs`. */
+    struct list_head   *event_buckets;
+    size_t              nr_event_buckets;
+    size_t              nr_events;
+
     uint64_t            state;
     size_t              nr_msgs;
 };
@@ -62,6 +92,8 @@ _COMPILE_TIME_ASSERT(onwer_atom,
         sizeof(atomic_uint) == sizeof(purc_atom_t));
 _COMPILE_TIME_ASSERT(list_head,
         sizeof(struct list_head) == (sizeof(void *) * 2));
+_COMPILE_TIME_ASSERT(msg_hdr,
+        sizeof(struct pcinst_msg_hdr) <= offsetof(pcrdr_msg, type));
 #undef _COMPILE_TIME_ASSERT
 
 PCA_EXTERN_C_BEGIN
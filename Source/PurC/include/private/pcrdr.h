@@ -105,6 +105,11 @@ pcrdr_check_operation(const char *op)
     return purc_atom_try_string_ex(ATOM_BUCKET_RDROP, op);
 }
 
+/* resolve the event type atom and the sub type offset of an event message
+   from its `eventName`; returns the atom, 0 for an unknown event type. */
+purc_atom_t
+pcrdr_msg_resolve_event_type(pcrdr_msg *msg) WTF_INTERNAL;
+
 int
 pcrdr_save_page_handle(struct pcrdr_conn *conn, const char *workspace_name,
         const char *group_name, const char *page_name, pcrdr_page_type_k page_type,
@@ -0,0 +1,102 @@
+/**
+ * @file timer-wheel.h
+ * @date 2026/10/16
+ * @brief The hearder file for hierarchical timing wheel.
+ *
+ * Copyright (C) 2021 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef PURC_PRIVATE_TIMER_WHEEL_H
+#define PURC_PRIVATE_TIMER_WHEEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "private/list.h"
+
+/* 5 levels of 64 slots in milliseconds cover about 12 days;
+   the nodes expiring later are re-placed when the top level wraps. */
+#define PCUTILS_TWHEEL_LEVEL_BITS       6
+#define PCUTILS_TWHEEL_LEVEL_SIZE       (1 << PCUTILS_TWHEEL_LEVEL_BITS)
+#define PCUTILS_TWHEEL_NR_LEVELS        5
+
+struct pcutils_twheel_node;
+typedef void (*pcutils_twheel_expired_fn)(struct pcutils_twheel_node *node);
+
+/* embed this structure in the owner and use container_of() in the callback */
+struct pcutils_twheel_node {
+    struct list_head            ln;
+    /* the absolute expiration time in milliseconds */
+    uint64_t                    expires;
+    pcutils_twheel_expired_fn   on_expired;
+    int                         level;
+};
+
+struct pcutils_twheel {
+    /* the next tick (in milliseconds) which is not processed yet */
+    uint64_t            current;
+    size_t              nr_nodes;
+    size_t              nr_level_nodes[PCUTILS_TWHEEL_NR_LEVELS];
+    struct list_head    slots[PCUTILS_TWHEEL_NR_LEVELS]
+                             [PCUTILS_TWHEEL_LEVEL_SIZE];
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* initialize a timing wheel starting from the tick `now` */
+void pcutils_twheel_init(struct pcutils_twheel *wheel, uint64_t now);
+
+/* initialize a node; the node is not in any wheel after this */
+void pcutils_twheel_node_init(struct pcutils_twheel_node *node,
+        pcutils_twheel_expired_fn on_expired);
+
+/* add (or re-add) a node expiring at the absolute time `expires`; O(1). */
+void pcutils_twheel_add(struct pcutils_twheel *wheel,
+        struct pcutils_twheel_node *node, uint64_t expires);
+
+/* remove a node from the wheel if it is pending; O(1). */
+void pcutils_twheel_remove(struct pcutils_twheel *wheel,
+        struct pcutils_twheel_node *node);
+
+static inline bool
+pcutils_twheel_node_is_pending(const struct pcutils_twheel_node *node)
+{
+    return !list_empty(&node->ln);
+}
+
+/* advance the wheel to `now` and call `on_expired` of all expired nodes
+   in one batch; returns the number of expired nodes. */
+size_t pcutils_twheel_expire(struct pcutils_twheel *wheel, uint64_t now);
+
+/* return a lower bound of the earliest expiration time,
+   or -1 if there is no pending node. */
+int64_t pcutils_twheel_next_expiry(struct pcutils_twheel *wheel);
+
+static inline size_t
+pcutils_twheel_count(const struct pcutils_twheel *wheel)
+{
+    return wheel->nr_nodes;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* PURC_PRIVATE_TIMER_WHEEL_H */
@@ -43,6 +43,12 @@ pcintr_timer_t
 pcintr_timer_create(purc_runloop_t runloop, const char* id,
         pcintr_timer_fire_func func, void *data);
 
+/* create a timer driven by the timer wheel of the current interpreter heap;
+   falls back to a RunLoop timer if there is no interpreter heap. */
+pcintr_timer_t
+pcintr_wheel_timer_create(const char* id,
+        pcintr_timer_fire_func func, void *data);
+
 void
 pcintr_timer_set_interval(pcintr_timer_t timer, uint32_t interval);
 
@@ -36,6 +36,13 @@
 extern "C" {
 #endif  /* __cplusplus */
 
+typedef void (*pcutils_casefold_cb)(void *ctxt, uint32_t uc);
+
+/* Folds the case of a null-terminated UTF-8 string in the same way as
+   pcutils_strncasecmp() does, and calls `cb` for every folded character. */
+void pcutils_utf8_casefold(const char *str,
+        pcutils_casefold_cb cb, void *ctxt);
+
 #ifdef __cplusplus
 }
 #endif  /* __cplusplus */
@@ -42,6 +42,10 @@ struct pcvarmgr {
 
     struct rb_node            node;
     struct pcvdom_node       *vdom_node;
+
+    /* the variables of a VCM evaluation frame, which are not visible to
+       the named variable resolution of the interpreter */
+    unsigned int              transient:1;
 };
 
 
@@ -68,6 +72,11 @@ static inline bool pcvarmgr_remove(pcvarmgr_t mgr, const char* name)
 bool pcvarmgr_dispatch_except(pcvarmgr_t mgr, const char* name,
         const char* except);
 
+/* the binding epoch of the current thread; it changes when a variable is
+   bound to or unbound from a non-transient manager, or such a manager
+   is destroyed. */
+unsigned long pcvarmgr_binding_epoch(void);
+
 PCA_EXTERN_C_END
 
 #endif /* not defined PURC_PRIVATE_VAR_MGR_H */
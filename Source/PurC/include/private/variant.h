@@ -40,6 +40,8 @@ PCA_EXTERN_C_BEGIN
 #define PCVRNT_FLAG_NOFREE          PCVRNT_FLAG_CONSTANT
 #define PCVRNT_FLAG_EXTRA_SIZE      (0x01 << 1)  // when use extra space
 #define PCVRNT_FLAG_STRING_STATIC   (0x01 << 2)  // make_string_static
+#define PCVRNT_FLAG_FROZEN          (0x01 << 3)  // deep-immutable and shared
+#define PCVRNT_FLAG_EXTRA_CACHED    (0x01 << 4)  // extra space from cache
 
 #define PVT(t)          (PURC_VARIANT_TYPE##t)
 #define IS_CONTAINER(t) (t == PURC_VARIANT_TYPE_OBJECT || \
@@ -50,10 +52,17 @@ PCA_EXTERN_C_BEGIN
 #ifndef NDEBUG
 // VW (NOTE): use 0 for debug for easy finding memory leaks.
 #define MAX_RESERVED_VARIANTS   0
+#define MAX_CACHED_BLOCKS       0
 #else
 #define MAX_RESERVED_VARIANTS   32
+#define MAX_CACHED_BLOCKS       256     // per size class
 #endif
 
+// the size classes of the block cache: 16, 32, ..., 256 bytes
+#define CACHE_CLASS_SHIFT       4
+#define CACHE_NR_CLASSES        16
+#define CACHE_MAX_BLOCK_SIZE    (CACHE_NR_CLASSES << CACHE_CLASS_SHIFT)
+
 #define DEF_EMBEDDED_LEVELS     64
 #define MAX_EMBEDDED_LEVELS     1024
 
@@ -211,6 +220,11 @@ struct pcvariant_heap {
 #else
     struct list_head    v_reserved;
 #endif
+
+    // the free blocks cached by the block cache, linked by their
+    // first word; one list per size class.
+    void               *cache_free[CACHE_NR_CLASSES];
+    size_t              cache_nr_free[CACHE_NR_CLASSES];
 };
 
 // internal interfaces for moving variant.
@@ -219,12 +233,33 @@ purc_variant_t pcvariant_move_heap_out(purc_variant_t v) WTF_INTERNAL;
 
 void pcvariant_use_move_heap(void) WTF_INTERNAL;
 void pcvariant_use_norm_heap(void) WTF_INTERNAL;
+bool pcvariant_is_using_move_heap(void) WTF_INTERNAL;
 
 purc_variant *pcvariant_alloc(void) WTF_INTERNAL;
 purc_variant *pcvariant_alloc_0(void) WTF_INTERNAL;
 void pcvariant_free(purc_variant *v) WTF_INTERNAL;
 
+/* The block cache: per-instance free lists in front of malloc() for
+   variant headers, container nodes and small string payloads. Blocks are
+   allocated one by one, so a block released by another instance (after
+   the variant was moved) simply joins the cache of that instance. Blocks
+   larger than CACHE_MAX_BLOCK_SIZE bypass the cache. */
+
+/* the size actually allocated for a block of `size` bytes: the size of its
+   class, so that the block can be reused for any size in the class. */
+static inline size_t pcvariant_cache_block_size(size_t size)
+{
+    if (size == 0 || size > CACHE_MAX_BLOCK_SIZE)
+        return size;
+    return (((size - 1) >> CACHE_CLASS_SHIFT) + 1) << CACHE_CLASS_SHIFT;
+}
+
+void *pcvariant_cache_alloc(size_t size) WTF_INTERNAL;
+void *pcvariant_cache_alloc_0(size_t size) WTF_INTERNAL;
+void pcvariant_cache_free(void *block, size_t size) WTF_INTERNAL;
+
 struct pcinst;
+struct arr_node;
 struct tuple_node;
 
 struct pcvar_rev_update_edge {
@@ -245,7 +280,7 @@ struct set_node {
     struct rb_node                       rbnode;
     struct pcutils_array_list_node       alnode;
     purc_variant_t   val;  // actual variant-element
-    char             md5[33];
+    uint64_t         hash; // pcvariant_hash_by_set()
 };
 
 struct variant_set {
@@ -256,6 +291,11 @@ struct variant_set {
     struct rb_root          elems;  // multiple-variant-elements stored in set
     struct pcutils_array_list al;    // struct set_node
 
+    // open-addressing index of the elements by hash (linear probing);
+    // NULL if out of memory, then the elements are looked up in `elems`.
+    struct set_node       **slots;
+    size_t                  nr_slots;
+
     // key: arr_node/obj_node/set_node
     // val: parent
     pcutils_map                     *rev_update_chain;
@@ -265,15 +305,37 @@ struct variant_set {
 typedef struct variant_obj      *variant_obj_t;
 
 struct obj_node {
-    struct rb_node   node;
+    // linked in the order of insertion
+    struct obj_node *prev;
+    struct obj_node *next;
     purc_variant_t   key;
     purc_variant_t   val;
+    uint32_t         hash;  // cached hash of the key
 };
 
+// the objects holding no more than this number of nodes are searched
+// linearly by comparing the cached hashes; larger ones are indexed.
+#define OBJ_MAX_LINEAR_NODES    8
+// the number of nodes in the first block, allocated on the first insertion
+#define OBJ_NR_FIRST_NODES      4
+
+struct obj_node_block;
+
 struct variant_obj {
-    struct rb_root          kvs;  // struct obj_node*
+    struct obj_node        *first;
+    struct obj_node        *last;
     size_t                  size;
 
+    // open-addressing index with linear probing; NULL for small objects
+    struct obj_node       **slots;
+    size_t                  nr_slots;   // always a power of two
+
+    // nodes are carved from blocks which never move, so the addresses
+    // of the nodes are stable for the reverse update chains.
+    struct obj_node_block  *blocks;
+    struct obj_node        *free_nodes; // linked by obj_node::next
+    size_t                  nr_nodes;   // in all blocks
+
     // key: arr_node/obj_node/set_node
     // val: parent
     pcutils_map                     *rev_update_chain;
@@ -282,13 +344,16 @@ struct variant_obj {
 // internal struct used by variant-arr
 typedef struct variant_arr      *variant_arr_t;
 
-struct arr_node {
-    struct pcutils_array_list_node       node;
-    purc_variant_t   val;
-};
-
 struct variant_arr {
-    struct pcutils_array_list     al;  // struct arr_node*
+    // the members are stored contiguously and located by their positions
+    purc_variant_t                *members;
+    size_t                         nr_members;
+    size_t                         sz_members;
+
+    // the tokens which locate the members in the reverse update chains of
+    // the members, in parallel with `members`; only allocated when
+    // the array belongs to a set.
+    struct arr_node              **edges;
 
     // key: arr_node/obj_node/set_node
     // val: parent
@@ -312,6 +377,16 @@ struct variant_tuple {
 #define PCVRNT_SORT_ASC             0x00000000
 #define PCVRNT_CMPOPT_MASK          0x0000FFFF
 
+int pcvariant_array_swap(purc_variant_t value, size_t i, size_t j);
+
+/* Applies the integer arithmetic operator `op` ('+', '-', '*', '/', '%',
+   or '^') element-wise; either operand can be an array/tuple, a packed
+   array of longints (a bsequence), or a scalar which is broadcast.
+   Returns a new packed array of longints if either operand is packed,
+   otherwise a new array of longints. */
+purc_variant_t
+pcvariant_numeric_arith(int op, purc_variant_t l, purc_variant_t r);
+
 int pcvariant_array_sort(purc_variant_t value, void *ud,
         int (*cmp)(purc_variant_t l, purc_variant_t r, void *ud));
 int pcvariant_set_sort(purc_variant_t value, void *ud,
@@ -441,14 +516,15 @@ pcvariant_md5(char *md5, purc_variant_t val)
     pcvariant_md5_ex(md5, val, salt, caseless, serialize_flags);
 }
 
-// md5 shall be at least 33 bytes long
-void
-pcvariant_md5_by_set(char *md5, purc_variant_t val,
-        purc_variant_t set) WTF_INTERNAL;
+// a 64-bit hash of the variant (or the values of its unique keys) which is
+// consistent with the comparison used by the set: the members regarded as
+// the same have the same hash.
+uint64_t
+pcvariant_hash_by_set(purc_variant_t val, purc_variant_t set) WTF_INTERNAL;
 
-int
-pcvariant_diff_by_set(const char *md5l, purc_variant_t l,
-        const char *md5r, purc_variant_t r, purc_variant_t set);
+// a cheap hash of the variant which is consistent with
+// purc_variant_is_equal_to(): the equal variants have the same hash.
+size_t pcvariant_shallow_hash(purc_variant_t v);
 
 bool
 pcvariant_is_sorted_array(purc_variant_t v);
@@ -497,67 +573,53 @@ do {                                            \
  *  in an interation.
  */
 
-// purc_variant_t _arr;
-#define variant_array_get_data(_arr)        \
-    &(((variant_arr_t)_arr->sz_ptr[1])->al)
-
-// purc_variant_t _arr;
-// struct arr_node *_p;
-#define foreach_in_variant_array(_arr, _p)                               \
-    array_list_for_each_entry(variant_array_get_data(_arr),              \
-            _p, node)
-
-// purc_variant_t _arr;
-// struct arr_node *_p, *_n;
-#define foreach_in_variant_array_safe(_arr, _p, _n)                      \
-    array_list_for_each_entry_safe(variant_array_get_data(_arr),         \
-            _p, _n, node)
-
-// purc_variant_t _arr;
-// struct arr_node *_p;
-#define foreach_in_variant_array_reverse(_arr, _p)                       \
-    array_list_for_each_entry_reverse(variant_array_get_data(_arr),      \
-            _p, node)
-
-// purc_variant_t _arr;
-// struct arr_node *_p, *_n;
-#define foreach_in_variant_array_reverse_safe(_arr, _p, _n)              \
-    array_list_for_each_entry_reverse_safe(variant_array_get_data(_arr), \
-            _p, _n, node)
-
 #define foreach_value_in_variant_array(_arr, _val, _idx)              \
     do {                                                              \
-        struct arr_node *_p;                                          \
-        foreach_in_variant_array(_arr, _p) {                          \
-            _val = _p->val;                                           \
-            _idx = _p->node.idx;                                      \
+        variant_arr_t _data;                                          \
+        size_t _i;                                                    \
+        _data = (variant_arr_t)_arr->sz_ptr[1];                       \
+        for (_i = 0; _i < _data->nr_members; _i++) {                  \
+            _val = _data->members[_i];                                \
+            _idx = _i;                                                \
      /* } */                                                          \
  /* } while (0) */
 
+/* the current member may be removed in the body */
 #define foreach_value_in_variant_array_safe(_arr, _val, _idx)      \
     do {                                                           \
-        struct arr_node *_p, *_n;                                  \
-        foreach_in_variant_array_safe(_arr, _p, _n) {              \
-            _val = _p->val;                                        \
-            _idx = _p->node.idx;                                   \
+        variant_arr_t _data;                                       \
+        size_t _i, _nr;                                            \
+        _data = (variant_arr_t)_arr->sz_ptr[1];                    \
+        for (_i = 0;                                               \
+             ({ _nr = _data->nr_members; _i < _nr; });             \
+             _i = (_data->nr_members < _nr) ? _i : _i + 1) {       \
+            _val = _data->members[_i];                             \
+            _idx = _i;                                             \
      /* } */                                                       \
  /* } while (0) */
 
 #define foreach_value_in_variant_array_reverse(_arr, _val, _idx)      \
     do {                                                              \
-        struct arr_node *_p;                                          \
-        foreach_in_variant_array_reverse(_arr, _p) {                  \
-            _val = _p->val;                                           \
-            _idx = _p->node.idx;                                      \
+        variant_arr_t _data;                                          \
+        size_t _i;                                                    \
+        _data = (variant_arr_t)_arr->sz_ptr[1];                       \
+        for (_i = _data->nr_members; _i > 0; _i--) {                  \
+            _val = _data->members[_i - 1];                            \
+            _idx = _i - 1;                                            \
      /* } */                                                          \
  /* } while (0) */
 
+/* the current member may be removed in the body */
 #define foreach_value_in_variant_array_reverse_safe(_arr, _val, _idx)   \
     do {                                                                \
-        struct arr_node *_p, *_n;                                       \
-        foreach_in_variant_array_reverse_safe(_arr, _p, _n) {           \
-            _val = _p->val;                                             \
-            _idx = _p->node.idx;                                        \
+        variant_arr_t _data;                                            \
+        size_t _i;                                                      \
+        _data = (variant_arr_t)_arr->sz_ptr[1];                         \
+        for (_i = _data->nr_members; _i > 0;                            \
+             _i = (_i - 1 < _data->nr_members) ?                        \
+                    _i - 1 : _data->nr_members) {                       \
+            _val = _data->members[_i - 1];                              \
+            _idx = _i - 1;                                              \
      /* } */                                                            \
  /* } while (0) */
 
@@ -565,12 +627,9 @@ do {                                            \
     do {                                                            \
         variant_obj_t _data;                                        \
         _data = (variant_obj_t)_obj->sz_ptr[1];                     \
-        struct rb_root *_root = &_data->kvs;                        \
-        struct rb_node *_p = pcutils_rbtree_first(_root);           \
-        for (; _p; _p = pcutils_rbtree_next(_p))                    \
+        struct obj_node *_node = _data->first;                      \
+        for (; _node; _node = _node->next)                          \
         {                                                           \
-            struct obj_node *_node;                                 \
-            _node = container_of(_p, struct obj_node, node);        \
             _val = _node->val;                                      \
      /* } */                                                        \
  /* } while (0) */
@@ -579,12 +638,9 @@ do {                                            \
     do {                                                            \
         variant_obj_t _data;                                        \
         _data = (variant_obj_t)_obj->sz_ptr[1];                     \
-        struct rb_root *_root = &_data->kvs;                        \
-        struct rb_node *_p = pcutils_rbtree_first(_root);           \
-        for (; _p; _p = pcutils_rbtree_next(_p))                    \
+        struct obj_node *_node = _data->first;                      \
+        for (; _node; _node = _node->next)                          \
         {                                                           \
-            struct obj_node *_node;                                 \
-            _node = container_of(_p, struct obj_node, node);        \
             _key = _node->key;                                      \
             _val = _node->val;                                      \
      /* } */                                                        \
@@ -594,14 +650,11 @@ do {                                            \
     do {                                                            \
         variant_obj_t _data;                                        \
         _data = (variant_obj_t)_obj->sz_ptr[1];                     \
-        struct rb_root *_root = &_data->kvs;                        \
-        struct rb_node *_p, *_next;                                 \
-        for (_p = pcutils_rbtree_first(_root);                      \
-            ({_next = _p ? pcutils_rbtree_next(_p) : NULL; _p;});   \
-            _p = _next)                                             \
+        struct obj_node *_node, *_next;                             \
+        for (_node = _data->first;                                  \
+            ({_next = _node ? _node->next : NULL; _node;});         \
+            _node = _next)                                          \
         {                                                           \
-            struct obj_node *_node;                                 \
-            _node = container_of(_p, struct obj_node, node);        \
             _key = _node->key;                                      \
             _val = _node->val;                                      \
      /* } */                                                        \
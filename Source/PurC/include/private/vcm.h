@@ -259,6 +259,11 @@ char *pcvcm_node_serialize(struct pcvcm_node *node, size_t *nr_bytes);
  */
 void pcvcm_node_destroy(struct pcvcm_node *root);
 
+/*
+ * Makes a deep copy of the node and its children.
+ */
+struct pcvcm_node *pcvcm_node_clone(struct pcvcm_node *node);
+
 
 typedef purc_variant_t(*find_var_fn) (void *ctxt, const char *name);
 
@@ -96,6 +96,18 @@ pcvdom_document_unref(struct pcvdom_document *doc);
 struct pcvdom_document*
 pcvdom_document_create(void);
 
+// Returns the document derived from @doc and cached under @key, or NULL.
+// The returned document is kept alive by @doc.
+struct pcvdom_document*
+pcvdom_document_find_derived(struct pcvdom_document *doc, const char *key);
+
+// Caches the document @derived under @key in @doc. If another document
+// was cached under the same key meanwhile, @derived is released and
+// the cached one is returned. On failure, @derived is released as well.
+struct pcvdom_document*
+pcvdom_document_cache_derived(struct pcvdom_document *doc, const char *key,
+        struct pcvdom_document *derived);
+
 struct pcvdom_element*
 pcvdom_element_create(pcvdom_tag_id tag);
 
@@ -220,6 +232,13 @@ pcvdom_element_is_hvml_operation(struct pcvdom_element *element);
 struct pcvdom_attr*
 pcvdom_element_find_attr(struct pcvdom_element *element, const char *key);
 
+/* get the attribute giving the anchor of the element (`idd-by` for the verb
+   and template elements, `id` for the others); `*static_anchor` is set to
+   the value if the attribute is a constant string, or NULL. */
+struct pcvdom_attr*
+pcvdom_element_anchor_attr(struct pcvdom_element *element,
+        const char **static_anchor);
+
 bool
 pcvdom_element_is_silently(struct pcvdom_element *element);
 
@@ -244,6 +263,10 @@ void pcvdom_node_remove(struct pcvdom_node *node);
 
 void pcvdom_node_destroy(struct pcvdom_node *node);
 
+// Makes a deep copy of an element, content, or comment node, including
+// the attributes and the VCM trees.
+struct pcvdom_node* pcvdom_node_clone(struct pcvdom_node *node);
+
 // traverse all vdom_node
 typedef int (*vdom_node_traverse_f)(struct pcvdom_node *top,
     struct pcvdom_node *node, void *ctx);
@@ -661,13 +661,20 @@ typedef enum
 #define PCRDR_MSG_EVENT_REDUCE_OPT_NR     \
     (PCRDR_MSG_EVENT_REDUCE_OPT_LAST - PCRDR_MSG_EVENT_REDUCE_OPT_FIRST + 1)
 
-/** the renderer message structure */
+/**
+ * The renderer message structure.
+ *
+ * Note that the layout changed after PurC 0.9.5 (see RELEASE-NOTES.md);
+ * the code embedding or allocating this structure must be rebuilt.
+ */
 struct pcrdr_msg
 {
     unsigned int            __refcnt;
     purc_atom_t             __origin;
     void                   *__padding1; // reserved for struct list_head
     void                   *__padding2; // reserved for struct list_head
+    void                   *__padding3; // reserved for struct list_head
+    void                   *__padding4; // reserved for struct list_head
 
     pcrdr_msg_type          type;
     pcrdr_msg_target        target;
@@ -688,6 +695,15 @@ struct pcrdr_msg
     uint64_t        targetValue;
     uint64_t        resultValue;
 
+    /**
+     * The atom of the event type (the part of `eventName` before
+     * the separator) and the offset of the sub type in `eventName`
+     * (zero for no sub type). Both are resolved once when the event name
+     * is set, so dispatching the event needs no allocation or atom lookup.
+     */
+    purc_atom_t     eventTypeAtom;
+    unsigned int    eventSubTypeOffset;
+
 #define PCRDR_NR_MSG_VARIANTS   6
     /* The aliase for managing the variants easily, totally 6 now.
        make sure `PCRDR_NR_MSG_VARIANTS` has the correct value. */
@@ -1045,6 +1061,42 @@ pcrdr_read_and_dispatch_message(pcrdr_conn* conn);
 PCA_EXPORT int
 pcrdr_wait_and_dispatch_message(pcrdr_conn* conn, int timeout_ms);
 
+/**
+ * Drain and dispatch the messages available on the renderer connection.
+ *
+ * @param conn: the pointer to the renderer connection.
+ * @param budget: the maximal number of messages to dispatch in this call.
+ *
+ * This function reads and dispatches all messages already available on
+ * the connection without blocking, until there is no more message or
+ * the number of the dispatched messages reaches @budget. The frames
+ * received in a burst are parsed from the read-ahead buffer, and the
+ * pending requests are checked for timeout only once for the whole batch.
+ *
+ * Returns: -1 for error; otherwise the number of the dispatched messages.
+ *
+ * Since: 0.9.6
+ */
+PCA_EXPORT int
+pcrdr_drain_and_dispatch_messages(pcrdr_conn* conn, size_t budget);
+
+/**
+ * Check whether there is input buffered in the renderer connection.
+ *
+ * @param conn: the pointer to the renderer connection.
+ *
+ * The frames already read into the read-ahead buffer of the connection
+ * do not make the file descriptor readable again; the caller should
+ * call pcrdr_drain_and_dispatch_messages() again without waiting on
+ * the file descriptor while this function returns %true.
+ *
+ * Returns: %true if there is buffered input, otherwise %false.
+ *
+ * Since: 0.9.6
+ */
+PCA_EXPORT bool
+pcrdr_conn_has_buffered_input(pcrdr_conn* conn);
+
 /**
  * Wait the response for the specified request identifier.
  *
@@ -1295,11 +1347,33 @@ purc_inst_destroy_move_buffer(void);
  * in the message will be moved as well. Hence, the subsequent call to
  * `pcrdr_release_message()` in the current thread will do nothing.
  *
+ * When broadcasting to more than one instance, the variants in the message
+ * are frozen (see purc_variant_freeze()) and shared by all receivers
+ * instead of being cloned by the sender for every receiver; a receiver
+ * clones the containers in the message only when it takes the message away.
+ *
  * Since: 0.1.0
  */
 PCA_EXPORT size_t
 purc_inst_move_message(purc_atom_t inst_to, pcrdr_msg *msg);
 
+/**
+ * Move a batch of messages to the move buffer of the specified instance.
+ *
+ * @param inst_to: the atom on behalf of the instance who will take owner
+ *      of the messages; see purc_inst_move_message().
+ * @param msgs: the pointer to the array of the messages.
+ * @param count: the number of the messages in @msgs.
+ *
+ * Returns: the number of messages moved (including the cloned ones).
+ *  When moving to a single instance, the first messages are moved in order
+ *  until the move buffer is full, and the owner instance is woken up once.
+ *
+ * Since: 0.9.6
+ */
+PCA_EXPORT size_t
+purc_inst_move_messages(purc_atom_t inst_to, pcrdr_msg **msgs, size_t count);
+
 /**
  * Get the number of messages holding in the move buffer of the current
  * instance.
@@ -1338,13 +1412,33 @@ purc_inst_retrieve_message(size_t index);
  * Returns: the pointer to the message; @NULL if there is no any message
  *  in the move buffer or @index is out of the valid range.
  *
- * Note that the variants in the message will be moved as well.
+ * Note that the variants in the message will be moved as well, and they
+ * are mutable: a frozen container in the message (e.g., the payload of
+ * a message broadcast to more than one instance, shared with the other
+ * receivers until then) is replaced by a clone owned by the caller.
  *
  * Since: 0.1.0
  */
 PCA_EXPORT pcrdr_msg *
 purc_inst_take_away_message(size_t index);
 
+/**
+ * Take the first messages away from the move buffer of the current instance.
+ *
+ * @param msgs: the buffer to receive the pointers to the messages.
+ * @param max: the maximal number of messages to take.
+ *
+ * Returns: the number of messages taken away; 0 if there is no any message
+ *  in the move buffer.
+ *
+ * Note that the variants in the messages will be moved as well; see
+ * purc_inst_take_away_message() for the variants of broadcast messages.
+ *
+ * Since: 0.9.6
+ */
+PCA_EXPORT size_t
+purc_inst_take_away_messages(pcrdr_msg **msgs, size_t max);
+
 
 /**@}*/
 
@@ -134,6 +134,36 @@ PCA_EXPORT
 void purc_runloop_set_idle_func(purc_runloop_t runloop, purc_runloop_func func,
         void *ctxt);
 
+/**
+ * Suspend the idle function of the runloop. This function should be called
+ * in the idle function; after the idle function returns, it will not be
+ * called again until purc_runloop_resume_idle_func() is called or
+ * the timeout elapses.
+ *
+ * @param runloop: the runloop.
+ * @param timeout_ms: the timeout in milliseconds; a negative value means
+ *      no timeout.
+ *
+ * Returns: void
+ *
+ * Since: 0.9.6
+ */
+PCA_EXPORT
+void purc_runloop_suspend_idle_func(purc_runloop_t runloop, long timeout_ms);
+
+/**
+ * Resume the suspended idle function of the runloop. This function can be
+ * called in any thread.
+ *
+ * @param runloop: the runloop.
+ *
+ * Returns: void
+ *
+ * Since: 0.9.6
+ */
+PCA_EXPORT
+void purc_runloop_resume_idle_func(purc_runloop_t runloop);
+
 typedef bool (*purc_runloop_io_callback)(int fd,
         purc_runloop_io_event event, void *ctxt);
 
@@ -3151,6 +3151,10 @@ struct purc_variant_stat {
     size_t sz_total_mem;
     size_t nr_reserved;
     size_t nr_max_reserved;
+    /* the free blocks kept by the block cache */
+    size_t nr_blocks_cached;
+    size_t sz_blocks_cached;
+    size_t nr_max_blocks_cached;
 };
 
 /**
@@ -3180,6 +3184,157 @@ purc_variant_usage_stat(void);
 PCA_EXPORT double
 purc_variant_numerify(purc_variant_t value);
 
+typedef enum pcvrnt_reduce_op {
+    PCVRNT_REDUCE_OP_SUM,
+    PCVRNT_REDUCE_OP_MIN,
+    PCVRNT_REDUCE_OP_MAX,
+    PCVRNT_REDUCE_OP_MEAN,
+} pcvrnt_reduce_op_k;
+
+/**
+ * purc_variant_numeric_reduce:
+ *
+ * @container: An array or a tuple variant whose members are numbers.
+ * @op: The reduce operation, one of the following values:
+ *      - PCVRNT_REDUCE_OP_SUM: the sum of all members.
+ *      - PCVRNT_REDUCE_OP_MIN: the minimum of all members.
+ *      - PCVRNT_REDUCE_OP_MAX: the maximum of all members.
+ *      - PCVRNT_REDUCE_OP_MEAN: the arithmetic mean of all members.
+ * @result: The pointer to a double buffer to receive the result.
+ *
+ * Reduces the members of a linear container to a single number. The members
+ * are cast to numbers as purc_variant_cast_to_number() does without forcing.
+ *
+ * Returns: %true on success, otherwise %false with the error code set:
+ *  - %PURC_ERROR_WRONG_DATA_TYPE: @container is not an array or a tuple,
+ *      or a member can not be cast to a number.
+ *  - %PURC_ERROR_INVALID_VALUE: @container is empty and @op is not
+ *      %PCVRNT_REDUCE_OP_SUM.
+ *
+ * Since: 0.9.6
+ */
+PCA_EXPORT bool
+purc_variant_numeric_reduce(purc_variant_t container,
+        pcvrnt_reduce_op_k op, double *result);
+
+/**
+ * purc_variant_numeric_dot:
+ *
+ * @c1: An array or a tuple variant whose members are numbers.
+ * @c2: Another array or tuple variant having the same size as @c1.
+ * @result: The pointer to a double buffer to receive the dot product.
+ *
+ * Calculates the dot product of two linear containers.
+ *
+ * Returns: %true on success, otherwise %false with the error code set:
+ *  - %PURC_ERROR_WRONG_DATA_TYPE: @c1 or @c2 is not an array or a tuple,
+ *      or a member can not be cast to a number.
+ *  - %PURC_ERROR_INVALID_VALUE: the sizes of @c1 and @c2 differ.
+ *
+ * Since: 0.9.6
+ */
+PCA_EXPORT bool
+purc_variant_numeric_dot(purc_variant_t c1, purc_variant_t c2,
+        double *result);
+
+/*
+ * A packed array is a byte sequence holding numbers of the same type
+ * contiguously, in the native byte order; it is the same as the result of
+ * `$DATA.pack('f64:<N>', ...)` for %PCVRNT_PACKED_TYPE_F64. A number in
+ * a packed array is boxed into a variant only when it is fetched.
+ */
+typedef enum pcvrnt_packed_type {
+    PCVRNT_PACKED_TYPE_F64,
+    PCVRNT_PACKED_TYPE_I64,
+    PCVRNT_PACKED_TYPE_U64,
+} pcvrnt_packed_type_k;
+
+/**
+ * purc_variant_make_packed_array:
+ *
+ * @type: The type of the numbers in the packed array.
+ * @container: An array or a tuple variant whose members are numbers.
+ *
+ * Packs the members of a linear container into a new packed array.
+ * The members are cast to the type as purc_variant_cast_to_number(),
+ * purc_variant_cast_to_longint(), or purc_variant_cast_to_ulongint() do
+ * without forcing.
+ *
+ * Returns: A bsequence variant holding the packed numbers on success,
+ *  otherwise %PURC_VARIANT_INVALID with the error code set:
+ *  - %PURC_ERROR_WRONG_DATA_TYPE: @container is not an array or a tuple,
+ *      or a member can not be cast to a number.
+ *  - %PURC_ERROR_INVALID_VALUE: @type is invalid.
+ *
+ * Since: 0.9.6
+ */
+PCA_EXPORT purc_variant_t
+purc_variant_make_packed_array(pcvrnt_packed_type_k type,
+        purc_variant_t container);
+
+/**
+ * purc_variant_packed_array_get:
+ *
+ * @packed: A bsequence variant holding a packed array.
+ * @type: The type of the numbers in the packed array.
+ * @idx: The index of the number to fetch.
+ *
+ * Boxes the number at the index @idx of a packed array into a number,
+ * longint, or ulongint variant according to @type.
+ *
+ * Returns: The boxed number on success, otherwise %PURC_VARIANT_INVALID
+ *  with the error code set:
+ *  - %PURC_ERROR_WRONG_DATA_TYPE: @packed is not a bsequence.
+ *  - %PURC_ERROR_INVALID_VALUE: @type is invalid, or the size of @packed
+ *      is not a multiple of the size of the numbers.
+ *  - %PURC_ERROR_OVERFLOW: @idx is out of the range.
+ *
+ * Since: 0.9.6
+ */
+PCA_EXPORT purc_variant_t
+purc_variant_packed_array_get(purc_variant_t packed,
+        pcvrnt_packed_type_k type, size_t idx);
+
+/**
+ * purc_variant_packed_reduce:
+ *
+ * @packed: A bsequence variant holding a packed array.
+ * @type: The type of the numbers in the packed array.
+ * @op: The reduce operation; see purc_variant_numeric_reduce().
+ * @result: The pointer to a double buffer to receive the result.
+ *
+ * Reduces the numbers of a packed array to a single number without boxing
+ * them.
+ *
+ * Returns: %true on success, otherwise %false with the error code set
+ *  as purc_variant_packed_array_get() and purc_variant_numeric_reduce() do.
+ *
+ * Since: 0.9.6
+ */
+PCA_EXPORT bool
+purc_variant_packed_reduce(purc_variant_t packed, pcvrnt_packed_type_k type,
+        pcvrnt_reduce_op_k op, double *result);
+
+/**
+ * purc_variant_packed_dot:
+ *
+ * @p1: A bsequence variant holding a packed array.
+ * @p2: Another packed array having the same size as @p1.
+ * @type: The type of the numbers in both packed arrays.
+ * @result: The pointer to a double buffer to receive the dot product.
+ *
+ * Calculates the dot product of two packed arrays without boxing
+ * the numbers.
+ *
+ * Returns: %true on success, otherwise %false with the error code set
+ *  as purc_variant_packed_array_get() and purc_variant_numeric_dot() do.
+ *
+ * Since: 0.9.6
+ */
+PCA_EXPORT bool
+purc_variant_packed_dot(purc_variant_t p1, purc_variant_t p2,
+        pcvrnt_packed_type_k type, double *result);
+
 /**
  * purc_variant_booleanize:
  *
@@ -3401,6 +3556,43 @@ purc_variant_container_clone(purc_variant_t ctnr);
 PCA_EXPORT purc_variant_t
 purc_variant_container_clone_recursively(purc_variant_t ctnr);
 
+/**
+ * purc_variant_freeze:
+ *
+ * @value: The source variant.
+ *
+ * Makes a frozen copy of a variant. A frozen variant is deep-immutable:
+ * it and all of its descendants can not be changed, and no listener can be
+ * registered on them. Its reference count is maintained atomically, so
+ * a frozen variant can be shared by pointer among instances; moving
+ * a frozen variant between instances does not copy it, but a frozen
+ * container in a message taken away from a move buffer is cloned
+ * (see purc_inst_take_away_message()).
+ *
+ * If @value is already frozen, this function returns a new reference of it.
+ * Dynamic and native variants can not be frozen.
+ *
+ * Returns: The frozen variant on success, or %PURC_VARIANT_INVALID on failure.
+ *
+ * Since: 0.9.6
+ */
+PCA_EXPORT purc_variant_t
+purc_variant_freeze(purc_variant_t value);
+
+/**
+ * purc_variant_is_frozen:
+ *
+ * @value: The variant to check.
+ *
+ * Checks whether a variant is frozen.
+ *
+ * Returns: @true if @value is frozen, otherwise @false.
+ *
+ * Since: 0.9.6
+ */
+PCA_EXPORT bool
+purc_variant_is_frozen(purc_variant_t value);
+
 struct purc_ejson_parsing_tree;
 
 /**
@@ -650,6 +650,132 @@ purc_coroutine_get_variable(purc_coroutine_t cor, const char *name);
 PCA_EXPORT int
 purc_coroutine_dump_stack(purc_coroutine_t cor, purc_rwstream_t stm);
 
+/** The scheduling classes of coroutines, in the order of priority. */
+typedef enum {
+#define PURC_SCHED_CLASS_NAME_INTERACTIVE   "interactive"
+    /** The latency-sensitive coroutines, e.g., handling user inputs. */
+    PURC_SCHED_CLASS_INTERACTIVE = 0,
+#define PURC_SCHED_CLASS_NAME_NORMAL        "normal"
+    /** The default class of a new coroutine. */
+    PURC_SCHED_CLASS_NORMAL,
+#define PURC_SCHED_CLASS_NAME_BATCH         "batch"
+    /** The CPU-heavy background coroutines. */
+    PURC_SCHED_CLASS_BATCH,
+} purc_sched_class_k;
+
+#define PURC_NR_SCHED_CLASSES   (PURC_SCHED_CLASS_BATCH + 1)
+
+/**
+ * purc_coroutine_set_sched_class:
+ *
+ * @cor: The pointer to a coroutine structure which representing a coroutine.
+ * @sched_class: The new scheduling class of the coroutine.
+ *
+ * Changes the scheduling class of the specified coroutine. A coroutine
+ * returned by @purc_schedule_vdom is in %PURC_SCHED_CLASS_NORMAL class;
+ * call this function before running the instance to change it.
+ *
+ * The ready coroutines of a higher class run first, and each class has its
+ * own time slice (see @purc_set_sched_time_slice). A ready coroutine gains
+ * one class of priority for every 20 milliseconds it waits, so that
+ * the coroutines of a lower class will not starve.
+ *
+ * Returns: 0 for success, -1 for an invalid class.
+ *
+ * Since 0.9.6
+ */
+PCA_EXPORT int
+purc_coroutine_set_sched_class(purc_coroutine_t cor,
+        purc_sched_class_k sched_class);
+
+/**
+ * purc_coroutine_get_sched_class:
+ *
+ * @cor: The pointer to a coroutine structure which representing a coroutine.
+ *
+ * Gets the scheduling class of the specified coroutine.
+ *
+ * Returns: The scheduling class of the coroutine.
+ *
+ * Since 0.9.6
+ */
+PCA_EXPORT purc_sched_class_k
+purc_coroutine_get_sched_class(purc_coroutine_t cor);
+
+/**
+ * purc_set_sched_time_slice:
+ *
+ * @sched_class: The scheduling class.
+ * @seconds: The time slice in seconds; must be greater than 0.
+ *
+ * Sets the time slice of a scheduling class for the current instance.
+ * A ready coroutine keeps running steps until it is used up, then
+ * the scheduler switches to the next ready coroutine.
+ *
+ * Returns: 0 for success, -1 for failure.
+ *
+ * Since 0.9.6
+ */
+PCA_EXPORT int
+purc_set_sched_time_slice(purc_sched_class_k sched_class, double seconds);
+
+/** The scheduling statistics of a coroutine; all times are in seconds. */
+struct purc_coroutine_sched_stat {
+    /** The total time the coroutine was ready but not running. */
+    double          ready_time;
+    /** The longest time the coroutine was ready but not running. */
+    double          max_ready_time;
+    /** The total time the coroutine was running. */
+    double          run_time;
+    /** The number of the time slices the coroutine was given. */
+    unsigned long   nr_slices;
+};
+
+/**
+ * purc_coroutine_get_sched_stat:
+ *
+ * @cor: The pointer to a coroutine structure which representing a coroutine.
+ * @stat: The buffer to return the statistics.
+ *
+ * Gets the scheduling statistics of the specified coroutine.
+ *
+ * Returns: 0 for success, -1 for failure.
+ *
+ * Since 0.9.6
+ */
+PCA_EXPORT int
+purc_coroutine_get_sched_stat(purc_coroutine_t cor,
+        struct purc_coroutine_sched_stat *stat);
+
+/** The allocation statistics of the interpreter of an instance. */
+struct purc_intr_alloc_stat {
+    /** The number of stack frames allocated afresh. */
+    size_t          nr_frames_allocated;
+    /** The number of stack frames reused from the frame pools. */
+    size_t          nr_frames_reused;
+    /** The number of element contexts allocated afresh. */
+    size_t          nr_ctxts_allocated;
+    /** The number of element contexts reused from the context pool. */
+    size_t          nr_ctxts_reused;
+    /** The number of element contexts currently kept in the pool. */
+    size_t          nr_pooled_ctxts;
+};
+
+/**
+ * purc_get_intr_alloc_stat:
+ *
+ * @stat: The buffer to return the statistics.
+ *
+ * Gets the statistics of the stack frames and the element contexts
+ * allocated by the interpreter of the current instance.
+ *
+ * Returns: 0 for success, -1 for failure.
+ *
+ * Since 0.9.6
+ */
+PCA_EXPORT int
+purc_get_intr_alloc_stat(struct purc_intr_alloc_stat *stat);
+
 struct purc_cor_run_info {
     unsigned long   run_idx;
     purc_variant_t  result;
@@ -29,13 +29,13 @@
 
 #include "purc-pcrdr.h"
 #include "purc-errors.h"
+#include "purc-runloop.h"
 
 /* this feature needs C11 (stdatomic.h) or above */
 #if HAVE(STDATOMIC_H)
 
 #include "private/instance.h"
 #include "private/list.h"
-#include "private/sorted-array.h"
 #include "private/utils.h"
 #include "private/ports.h"
 #include "private/debug.h"
@@ -49,13 +49,65 @@
 
 #define NR_DEF_MAX_MSGS     4
 
+/* the number of move buffers in a segment of the slot table;
+   must be a power of two */
+#define NR_MOVE_BUFFER_SLOTS    1024
+#define MOVE_BUFFER_SLOT_MASK   (NR_MOVE_BUFFER_SLOTS - 1)
+
+/* the number of receivers of a broadcast held on the stack */
+#define NR_HELD_ON_STACK        32
+
+enum {
+    MB_STATE_UNUSED = 0,    /* never used; terminates a lookup */
+    MB_STATE_ALIVE,
+    MB_STATE_CLOSING,
+    MB_STATE_DEAD,          /* destroyed; can be reused by a new buffer */
+};
+
+struct mb_cell {
+    atomic_size_t       seq;
+    pcrdr_msg          *msg;
+    /* the message is an envelope shared by the receivers of a broadcast */
+    bool                shared;
+};
+
+/*
+ * A move buffer is a bounded MPSC ring (after Dmitry Vyukov's bounded
+ * queue): any instance pushes messages into the ring without a lock, and
+ * only the owner instance pops them. The owner drains the ready cells of
+ * the ring into the local list `msgs` when it counts, retrieves, or takes
+ * away messages; a cell still being filled by a producer is left for the
+ * next time, the producer resuming the runloop of the owner once done.
+ *
+ * The move buffers live in a slot table which is never freed; the table
+ * grows by segments when all slots are in use. Other instances look up a
+ * buffer without a lock, then hold it with the reader lock of `hold`
+ * before checking the state and the atom of the slot. The owner takes
+ * the writer lock to wait for the producers before it frees the ring.
+ */
 struct pcinst_move_buffer {
-    struct purc_rwlock  lock;
-    struct list_head    msgs;
+    atomic_uint         state;
+    atomic_uint         atom;
+    /* initialized when the slot is used for the first time */
+    struct purc_rwlock  hold;
 
     unsigned int        flags;
     size_t              max_nr_msgs;
-    size_t              nr_msgs;
+
+    /* the number of messages reserved by producers, bounded by max_nr_msgs */
+    atomic_size_t       nr_reserved;
+
+    struct mb_cell     *cells;
+    size_t              mask;
+    atomic_size_t       enqueue_pos;
+
+    /* the fields only accessed by the owner */
+    size_t              dequeue_pos;
+    struct list_head    msgs;
+    size_t              nr_local;
+
+    /* the runloop of the owner instance to wake up on new messages */
+    purc_runloop_t      runloop;
 };
 
 /* the header of the struct pcrdr_msg */
@@ -72,10 +124,22 @@ _COMPILE_TIME_ASSERT(onwer_atom,
         sizeof(atomic_uint) == sizeof(unsigned int));
 _COMPILE_TIME_ASSERT(list_head,
         sizeof(struct list_head) == (sizeof(void *) * 2));
+_COMPILE_TIME_ASSERT(atom,
+        sizeof(atomic_uint) == sizeof(purc_atom_t));
 #undef _COMPILE_TIME_ASSERT
 
-static struct purc_rwlock      mb_lock;
-static struct sorted_array    *mb_atom2buff_map;
+struct mb_segment {
+    /* appended with `mb_lock` held; never removed until exiting */
+    _Atomic(struct mb_segment *) next;
+    struct pcinst_move_buffer   slots[NR_MOVE_BUFFER_SLOTS];
+};
+
+#define foreach_mb_segment(seg)                                         \
+    for (seg = mb_segments; seg; seg = atomic_load(&seg->next))
+
+/* serializes the creation and the destruction of move buffers */
+static struct purc_rwlock          mb_lock;
+static struct mb_segment          *mb_segments;
 
 static void mvbuf_cleanup_once(void)
 {
@@ -84,10 +148,20 @@ static void mvbuf_cleanup_once(void)
         mb_lock.native_impl = NULL;
     }
 
-    if (mb_atom2buff_map) {
-        pcutils_sorted_array_destroy(mb_atom2buff_map);
-        mb_atom2buff_map = NULL;
+    struct mb_segment *seg = mb_segments;
+    while (seg) {
+        struct mb_segment *next = atomic_load(&seg->next);
+        for (size_t i = 0; i < NR_MOVE_BUFFER_SLOTS; i++) {
+            struct pcinst_move_buffer *mb = seg->slots + i;
+            if (mb->cells)
+                free(mb->cells);
+            if (mb->hold.native_impl)
+                purc_rwlock_clear(&mb->hold);
+        }
+        free(seg);
+        seg = next;
     }
+    mb_segments = NULL;
 }
 
 static int mvbuf_init_once(void)
@@ -97,10 +171,10 @@ static int mvbuf_init_once(void)
     if (mb_lock.native_impl == NULL)
         goto fail_lock;
 
-    mb_atom2buff_map = pcutils_sorted_array_create(SAFLAG_DEFAULT, 0,
-            NULL, NULL);
-    if (mb_atom2buff_map == NULL)
-        goto fail_map;
+    /* all zero means all slots are in MB_STATE_UNUSED */
+    mb_segments = calloc(1, sizeof(*mb_segments));
+    if (mb_segments == NULL)
+        goto fail_slots;
 
     r = atexit(mvbuf_cleanup_once);
     if (r)
@@ -109,15 +183,205 @@ static int mvbuf_init_once(void)
     return 0;
 
 fail_atexit:
-    pcutils_sorted_array_destroy(mb_atom2buff_map);
+    free(mb_segments);
+    mb_segments = NULL;
 
-fail_map:
+fail_slots:
     purc_rwlock_clear(&mb_lock);
 
 fail_lock:
     return -1;
 }
 
+static inline size_t
+mb_hash(purc_atom_t atom)
+{
+    return (size_t)(atom * 2654435761U) & MOVE_BUFFER_SLOT_MASK;
+}
+
+/* find the alive move buffer of the atom; only safe for the owner or
+   with `mb_lock` held. */
+static struct pcinst_move_buffer *
+mb_find(purc_atom_t atom)
+{
+    size_t idx = mb_hash(atom);
+    struct mb_segment *seg;
+
+    foreach_mb_segment(seg) {
+        for (size_t i = 0; i < NR_MOVE_BUFFER_SLOTS; i++) {
+            struct pcinst_move_buffer *mb;
+            mb = seg->slots + ((idx + i) & MOVE_BUFFER_SLOT_MASK);
+
+            unsigned int state = atomic_load(&mb->state);
+            if (state == MB_STATE_UNUSED)
+                break;
+
+            if (state == MB_STATE_ALIVE && atomic_load(&mb->atom) == atom)
+                return mb;
+        }
+    }
+
+    return NULL;
+}
+
+/* hold a buffer against destruction; fails if it is being destroyed. */
+static bool
+mb_hold(struct pcinst_move_buffer *mb)
+{
+    if (!purc_rwlock_reader_trylock(&mb->hold))
+        return false;
+
+    if (atomic_load(&mb->state) == MB_STATE_ALIVE)
+        return true;
+
+    purc_rwlock_reader_unlock(&mb->hold);
+    return false;
+}
+
+/* find the alive move buffer of the atom and hold it against destruction;
+   call mb_put() after using it. */
+static struct pcinst_move_buffer *
+mb_get(purc_atom_t atom)
+{
+    struct pcinst_move_buffer *mb = mb_find(atom);
+    if (mb == NULL || !mb_hold(mb))
+        return NULL;
+
+    if (atomic_load(&mb->atom) == atom)
+        return mb;
+
+    /* destroyed and reused in the meantime */
+    purc_rwlock_reader_unlock(&mb->hold);
+    return NULL;
+}
+
+static inline void
+mb_put(struct pcinst_move_buffer *mb)
+{
+    purc_rwlock_reader_unlock(&mb->hold);
+}
+
+/* reserve room for up to `nr` messages; returns the number reserved. */
+static size_t
+mb_reserve(struct pcinst_move_buffer *mb, size_t nr)
+{
+    size_t old = atomic_fetch_add(&mb->nr_reserved, nr);
+    size_t avail = (old < mb->max_nr_msgs) ? mb->max_nr_msgs - old : 0;
+
+    if (avail < nr) {
+        atomic_fetch_sub(&mb->nr_reserved, nr - avail);
+        return avail;
+    }
+
+    return nr;
+}
+
+/* push reserved messages; the ring never overflows since the number of
+   reserved messages does not exceed its capacity. */
+static void
+mb_push(struct pcinst_move_buffer *mb, pcrdr_msg **msgs, size_t nr,
+        bool shared)
+{
+    size_t pos = atomic_fetch_add_explicit(&mb->enqueue_pos, nr,
+            memory_order_relaxed);
+
+    for (size_t i = 0; i < nr; i++, pos++) {
+        struct mb_cell *cell = mb->cells + (pos & mb->mask);
+
+        /* the owner may not have recycled the cell yet */
+        while (atomic_load_explicit(&cell->seq, memory_order_acquire) != pos)
+            ;
+
+        cell->msg = msgs[i];
+        cell->shared = shared;
+        atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+    }
+
+    purc_runloop_resume_idle_func(mb->runloop);
+}
+
+/* pop a message from the ring; called by the owner only. */
+static pcrdr_msg *
+mb_pop(struct pcinst_move_buffer *mb, bool *shared)
+{
+    size_t pos = mb->dequeue_pos;
+    struct mb_cell *cell = mb->cells + (pos & mb->mask);
+
+    if (atomic_load_explicit(&cell->seq, memory_order_acquire) != pos + 1)
+        return NULL;
+
+    pcrdr_msg *msg = cell->msg;
+    *shared = cell->shared;
+    atomic_store_explicit(&cell->seq, pos + mb->mask + 1,
+            memory_order_release);
+    mb->dequeue_pos = pos + 1;
+    return msg;
+}
+
+/* make a private copy of a shared envelope for the current instance;
+   the payload is frozen, so the variants are shared by reference until
+   the message is taken away (see do_take_message()). */
+static pcrdr_msg *
+copy_shared_message(pcrdr_msg *shared)
+{
+    pcrdr_msg *msg = pcinst_get_message();
+    if (msg) {
+        struct pcrdr_msg_hdr *hdr = (struct pcrdr_msg_hdr *)msg;
+        hdr->origin = ((struct pcrdr_msg_hdr *)shared)->origin;
+
+        memcpy(&msg->type, &shared->type,
+                sizeof(pcrdr_msg) - offsetof(pcrdr_msg, type));
+        for (int i = 0; i < PCRDR_NR_MSG_VARIANTS; i++) {
+            if (msg->variants[i])
+                purc_variant_ref(msg->variants[i]);
+        }
+    }
+
+    pcinst_put_message(shared);
+    return msg;
+}
+
+/* move the ready messages in the ring to the local list, stopping at
+   a cell which a producer is still filling: mb_push() resumes the runloop
+   of the owner when it is done. Called by the owner only. */
+static void
+mb_drain(struct pcinst_move_buffer *mb)
+{
+    bool shared;
+    pcrdr_msg *msg;
+
+    while ((msg = mb_pop(mb, &shared))) {
+        if (shared && (msg = copy_shared_message(msg)) == NULL) {
+            PC_ERROR("failed to copy a broadcast message; dropped\n");
+            atomic_fetch_sub(&mb->nr_reserved, 1);
+            continue;
+        }
+
+        struct pcrdr_msg_hdr *hdr = (struct pcrdr_msg_hdr *)msg;
+        list_add_tail(&hdr->ln, &mb->msgs);
+        mb->nr_local++;
+    }
+}
+
+/* make sure the local list holds more than `index` messages if possible;
+   returns false if there are not so many messages ready. */
+static bool
+mb_fetch(struct pcinst_move_buffer *mb, size_t index)
+{
+    if (mb->nr_local <= index)
+        mb_drain(mb);
+
+    return mb->nr_local > index;
+}
+
+/* account for `nr` messages taken away from the local list. */
+static void
+mb_count_taken(struct pcinst_move_buffer *mb, size_t nr)
+{
+    atomic_fetch_sub(&mb->nr_reserved, nr);
+    mb->nr_local -= nr;
+}
+
 pcrdr_msg *
 pcinst_get_message(void)
 {
@@ -186,47 +450,85 @@ purc_inst_create_move_buffer(unsigned int flags, size_t max_msgs)
 
     purc_rwlock_writer_lock(&mb_lock);
 
-    if (pcutils_sorted_array_find(mb_atom2buff_map,
-                (void *)(uintptr_t)atom, (void **)&mb, NULL)) {
-        mb = NULL;
+    if (mb_find(atom)) {
         errcode = PURC_ERROR_DUPLICATED;
         goto done;
     }
 
-    if ((mb = malloc(sizeof(*mb))) == NULL) {
-        errcode = PURC_ERROR_OUT_OF_MEMORY;
-        goto done;
+    size_t idx = mb_hash(atom);
+    struct mb_segment *seg, *last = NULL;
+    foreach_mb_segment(seg) {
+        for (size_t i = 0; i < NR_MOVE_BUFFER_SLOTS; i++) {
+            struct pcinst_move_buffer *slot;
+            slot = seg->slots + ((idx + i) & MOVE_BUFFER_SLOT_MASK);
+
+            unsigned int state = atomic_load(&slot->state);
+            if (state == MB_STATE_UNUSED || state == MB_STATE_DEAD) {
+                mb = slot;
+                break;
+            }
+        }
+
+        if (mb)
+            break;
+        last = seg;
     }
 
-    purc_rwlock_init(&mb->lock);
-    if (mb->lock.native_impl == NULL) {
-        errcode = PURC_ERROR_BAD_SYSTEM_CALL;
-        goto done;
+    if (mb == NULL) {
+        /* all slots are in use; append a new segment */
+        seg = calloc(1, sizeof(*seg));
+        if (seg == NULL) {
+            errcode = PURC_ERROR_OUT_OF_MEMORY;
+            goto done;
+        }
+
+        atomic_store(&last->next, seg);
+        mb = seg->slots + idx;
     }
 
-    if (pcutils_sorted_array_add(mb_atom2buff_map,
-                (void *)(uintptr_t)atom, mb, NULL) < 0) {
+    if (mb->hold.native_impl == NULL) {
+        purc_rwlock_init(&mb->hold);
+        if (mb->hold.native_impl == NULL) {
+            errcode = PURC_ERROR_OUT_OF_MEMORY;
+            goto done;
+        }
+    }
+
+    mb->max_nr_msgs = (max_msgs > 0) ? max_msgs : NR_DEF_MAX_MSGS;
+
+    size_t capacity = 1;
+    while (capacity < mb->max_nr_msgs)
+        capacity <<= 1;
+
+    mb->cells = malloc(sizeof(struct mb_cell) * capacity);
+    if (mb->cells == NULL) {
         errcode = PURC_ERROR_OUT_OF_MEMORY;
         goto done;
     }
 
-    mb->flags = flags;
-    mb->nr_msgs = 0;
-    mb->max_nr_msgs = (max_msgs > 0) ? max_msgs : NR_DEF_MAX_MSGS;
+    for (size_t i = 0; i < capacity; i++) {
+        atomic_init(&mb->cells[i].seq, i);
+        mb->cells[i].msg = NULL;
+    }
+
+    mb->mask = capacity - 1;
+    atomic_store(&mb->enqueue_pos, 0);
+    mb->dequeue_pos = 0;
+    atomic_store(&mb->nr_reserved, 0);
     list_head_init(&mb->msgs);
+    mb->nr_local = 0;
+
+    mb->flags = flags;
+    mb->runloop = inst->running_loop;
+    atomic_store(&mb->atom, atom);
+
+    /* publish the buffer */
+    atomic_store(&mb->state, MB_STATE_ALIVE);
 
 done:
     purc_rwlock_writer_unlock(&mb_lock);
 
     if (errcode) {
-        if (mb) {
-            if (mb->lock.native_impl) {
-                purc_rwlock_clear(&mb->lock);
-            }
-
-            free(mb);
-        }
-
         purc_set_error(errcode);
         return 0;
     }
@@ -274,16 +576,33 @@ purc_inst_destroy_move_buffer(void)
 
     purc_rwlock_writer_lock(&mb_lock);
 
-    if (!pcutils_sorted_array_find(mb_atom2buff_map,
-                (void *)(uintptr_t)atom, (void **)&mb, NULL)) {
-        mb = NULL;
+    mb = mb_find(atom);
+    if (mb == NULL) {
         errcode = PURC_ERROR_NOT_EXISTS;
         goto done;
     }
 
+    /* stop new producers and wait for the ones moving messages */
+    atomic_store(&mb->state, MB_STATE_CLOSING);
+    purc_rwlock_writer_lock(&mb->hold);
+
     struct list_head *p, *n;
-    purc_rwlock_writer_lock(&mb->lock);
     pcvariant_use_move_heap();
+
+    pcrdr_msg *msg;
+    bool shared;
+    while ((msg = mb_pop(mb, &shared))) {
+        if (shared) {
+            /* only drop the reference of this buffer */
+            pcinst_put_message(msg);
+            nr++;
+        }
+        else {
+            struct pcrdr_msg_hdr *hdr = (struct pcrdr_msg_hdr *)msg;
+            list_add_tail(&hdr->ln, &mb->msgs);
+        }
+    }
+
     list_for_each_safe(p, n, &mb->msgs) {
 
         struct pcrdr_msg_hdr *hdr;
@@ -291,17 +610,17 @@ purc_inst_destroy_move_buffer(void)
         hdr = list_entry(p, struct pcrdr_msg_hdr, ln);
 
         list_del(p);
-        mb->nr_msgs--;
-
         pcinst_grind_message((pcrdr_msg *)hdr);
         nr++;
     }
     pcvariant_use_norm_heap();
-    purc_rwlock_writer_unlock(&mb->lock);
 
-    pcutils_sorted_array_remove(mb_atom2buff_map, (void *)(uintptr_t)atom);
-    purc_rwlock_clear(&mb->lock);
-    free(mb);
+    free(mb->cells);
+    mb->cells = NULL;
+    mb->nr_local = 0;
+    atomic_store(&mb->nr_reserved, 0);
+    atomic_store(&mb->state, MB_STATE_DEAD);
+    purc_rwlock_writer_unlock(&mb->hold);
 
 done:
     purc_rwlock_writer_unlock(&mb_lock);
@@ -328,182 +647,279 @@ do_move_message(struct pcinst* inst, pcrdr_msg *msg)
     }
 }
 
+/* the taker owns the message from now on, so the payload must be mutable:
+   a frozen container, which may be shared with other receivers of
+   a broadcast, is cloned here; frozen scalars are immutable anyway and
+   are still shared. */
+static purc_variant_t
+thaw_variant(purc_variant_t v)
+{
+    if (!purc_variant_is_frozen(v) || !purc_variant_is_container(v))
+        return v;
+
+    purc_variant_t copy = purc_variant_container_clone_recursively(v);
+    if (copy == PURC_VARIANT_INVALID) {
+        PC_WARN("failed to clone a frozen variant; left read-only\n");
+        return v;
+    }
+
+    purc_variant_unref(v);
+    return copy;
+}
+
 static void
 do_take_message(struct pcinst* inst, pcrdr_msg *msg)
 {
     (void)inst;
     for (int i = 0; i < PCRDR_NR_MSG_VARIANTS; i++) {
-        if (msg->variants[i])
+        if (msg->variants[i]) {
             msg->variants[i] = pcvariant_move_heap_out(msg->variants[i]);
+            msg->variants[i] = thaw_variant(msg->variants[i]);
+        }
     }
 }
 
-size_t
-purc_inst_move_message(purc_atom_t inst_to, pcrdr_msg *msg)
+/* freeze the variants in the message to share them among receivers;
+   the message is left untouched if any of them can not be frozen. */
+static bool
+freeze_message(pcrdr_msg *msg)
 {
-    int errcode = 0;
-    size_t nr = 0;
-    struct pcinst_move_buffer *mb;
-    struct pcinst* inst = pcinst_current();
+    purc_variant_t frozen[PCRDR_NR_MSG_VARIANTS] = { };
+    int i;
 
-    if (inst == NULL) {
-        purc_set_error(PURC_ERROR_NO_INSTANCE);
-        return 0;
+    for (i = 0; i < PCRDR_NR_MSG_VARIANTS; i++) {
+        purc_variant_t v = msg->variants[i];
+        if (v == NULL || purc_variant_is_frozen(v))
+            continue;
+
+        frozen[i] = purc_variant_freeze(v);
+        if (frozen[i] == PURC_VARIANT_INVALID)
+            goto failed;
     }
 
-    if (inst_to == (purc_atom_t)PURC_EVENT_TARGET_SELF) {
-        return 0;
+    for (i = 0; i < PCRDR_NR_MSG_VARIANTS; i++) {
+        if (frozen[i]) {
+            purc_variant_unref(msg->variants[i]);
+            msg->variants[i] = frozen[i];
+        }
     }
+    return true;
 
-    purc_rwlock_reader_lock(&mb_lock);
+failed:
+    while (--i >= 0) {
+        if (frozen[i])
+            purc_variant_unref(frozen[i]);
+    }
+    return false;
+}
 
-    if (inst_to != (purc_atom_t)PURC_EVENT_TARGET_BROADCAST) {
-        if (!pcutils_sorted_array_find(mb_atom2buff_map,
-                    (void *)(uintptr_t)inst_to, (void **)&mb, NULL)) {
-            errcode = PURC_ERROR_NOT_EXISTS;
-            goto done;
-        }
+/* release the buffers held for a broadcast but not used */
+static void
+unreserve_held(struct pcinst_move_buffer **held, size_t nr)
+{
+    for (size_t i = 0; i < nr; i++) {
+        atomic_fetch_sub(&held[i]->nr_reserved, 1);
+        mb_put(held[i]);
+    }
+}
 
-        if (mb->nr_msgs >= mb->max_nr_msgs) {
-            errcode = PURC_ERROR_TOO_SMALL_BUFF;
-            goto done;
-        }
+static size_t
+broadcast_message(struct pcinst* inst, pcrdr_msg *msg)
+{
+    /* the receiving buffers held; on the heap only for many receivers */
+    struct pcinst_move_buffer *held_on_stack[NR_HELD_ON_STACK];
+    struct pcinst_move_buffer **held = held_on_stack;
+    size_t sz_held = NR_HELD_ON_STACK;
+    size_t nr_mbs = 0;
+
+    /* hold and reserve room in all receiving buffers first */
+    struct mb_segment *seg;
+    foreach_mb_segment(seg) {
+        for (size_t i = 0; i < NR_MOVE_BUFFER_SLOTS; i++) {
+            struct pcinst_move_buffer *mb = seg->slots + i;
+
+            if (atomic_load(&mb->state) != MB_STATE_ALIVE || !mb_hold(mb))
+                continue;
+
+            if (!(mb->flags & PCINST_MOVE_BUFFER_BROADCAST) ||
+                    mb_reserve(mb, 1) == 0) {
+                mb_put(mb);
+                continue;
+            }
 
-        do_move_message(inst, msg);
+            if (nr_mbs == sz_held) {
+                struct pcinst_move_buffer **more;
+                more = malloc(sizeof(*more) * sz_held * 2);
+                if (more == NULL) {
+                    PC_ERROR("no memory to broadcast to %p\n", mb);
+                    unreserve_held(&mb, 1);
+                    continue;
+                }
 
-        purc_rwlock_writer_lock(&mb->lock);
-        struct pcrdr_msg_hdr *hdr = (struct pcrdr_msg_hdr *)msg;
-        list_add_tail(&hdr->ln, &mb->msgs);
-        mb->nr_msgs++;
-        purc_rwlock_writer_unlock(&mb->lock);
+                memcpy(more, held, sizeof(*more) * nr_mbs);
+                if (held != held_on_stack)
+                    free(held);
+                held = more;
+                sz_held *= 2;
+            }
 
-        nr++;
+            held[nr_mbs++] = mb;
+        }
     }
-    else {
-        size_t count = pcutils_sorted_array_count(mb_atom2buff_map);
 
-        for (size_t i = 0; i < count; i++) {
-            pcutils_sorted_array_get(mb_atom2buff_map, i, (void **)&mb);
-            if (mb->flags & PCINST_MOVE_BUFFER_BROADCAST &&
-                    mb->nr_msgs < mb->max_nr_msgs) {
+    if (nr_mbs == 0)
+        return 0;
 
-                pcrdr_msg *my_msg;
+    size_t nr = 0;
 
-                if (i == count - 1) {
-                    my_msg = msg;
-                    do_move_message(inst, msg);
-                }
-                else {
-                    my_msg = pcrdr_clone_message(msg);
-                    if (my_msg) {
-                        do_move_message(inst, my_msg);
-                        pcrdr_release_message(my_msg);
-                    }
-                    else {
-                        PC_ERROR("failed to clone message to broadcast: %p\n",
-                                msg);
-                        break;
-                    }
-                }
+    /* share one envelope with a frozen payload among all receivers;
+       every receiver makes a private copy of the envelope when it fetches
+       the message, and clones the frozen containers when it takes the
+       message away. */
+    if (nr_mbs > 1 && freeze_message(msg)) {
+        struct pcrdr_msg_hdr *hdr = (struct pcrdr_msg_hdr *)msg;
+        hdr->origin = inst->endpoint_atom;
+        atomic_fetch_add(&hdr->refcnt, nr_mbs);
 
-                purc_rwlock_writer_lock(&mb->lock);
-                struct pcrdr_msg_hdr *hdr = (struct pcrdr_msg_hdr *)my_msg;
-                list_add_tail(&hdr->ln, &mb->msgs);
-                mb->nr_msgs++;
-                purc_rwlock_writer_unlock(&mb->lock);
-                nr++;
-            }
+        for (size_t i = 0; i < nr_mbs; i++) {
+            mb_push(held[i], &msg, 1, true);
+            mb_put(held[i]);
         }
+
+        nr = nr_mbs;
+        goto done;
     }
 
-done:
-    purc_rwlock_reader_unlock(&mb_lock);
+    /* the payload can not be frozen (e.g., it contains native entities):
+       the last buffer gets the original message, others get clones */
+    for (size_t i = 0; i < nr_mbs - 1; i++) {
+        struct pcinst_move_buffer *mb = held[i];
+        pcrdr_msg *my_msg = pcrdr_clone_message(msg);
+        if (my_msg == NULL) {
+            PC_ERROR("failed to clone message to broadcast: %p\n", msg);
+            unreserve_held(&mb, 1);
+            continue;
+        }
 
-    if (errcode) {
-        purc_set_error(errcode);
+        do_move_message(inst, my_msg);
+        pcrdr_release_message(my_msg);
+        mb_push(mb, &my_msg, 1, false);
+        mb_put(mb);
+        nr++;
     }
 
+    struct pcinst_move_buffer *last = held[nr_mbs - 1];
+    do_move_message(inst, msg);
+    mb_push(last, &msg, 1, false);
+    mb_put(last);
+    nr++;
+
+done:
+    if (held != held_on_stack)
+        free(held);
     return nr;
 }
 
-int
-purc_inst_holding_messages_count(size_t *nr)
+size_t
+purc_inst_move_messages(purc_atom_t inst_to, pcrdr_msg **msgs, size_t count)
 {
+    int errcode = 0;
+    size_t nr = 0;
+    struct pcinst_move_buffer *mb;
     struct pcinst* inst = pcinst_current();
+
     if (inst == NULL) {
         purc_set_error(PURC_ERROR_NO_INSTANCE);
-        return PURC_ERROR_NO_INSTANCE;
+        return 0;
     }
 
-    int errcode = 0;
-    struct pcinst_move_buffer *mb;
+    if (inst_to == (purc_atom_t)PURC_EVENT_TARGET_SELF || count == 0) {
+        return 0;
+    }
 
-    purc_rwlock_reader_lock(&mb_lock);
+    if (inst_to == (purc_atom_t)PURC_EVENT_TARGET_BROADCAST) {
+        for (size_t i = 0; i < count; i++)
+            nr += broadcast_message(inst, msgs[i]);
+        return nr;
+    }
 
-    if (!pcutils_sorted_array_find(mb_atom2buff_map,
-                (void *)(uintptr_t)inst->endpoint_atom, (void **)&mb, NULL)) {
+    mb = mb_get(inst_to);
+    if (mb == NULL) {
         errcode = PURC_ERROR_NOT_EXISTS;
         goto done;
     }
 
-    /* no need to lock the buffer */
-    *nr = mb->nr_msgs;
+    nr = mb_reserve(mb, count);
+    if (nr < count)
+        errcode = PURC_ERROR_TOO_SMALL_BUFF;
 
-done:
-    purc_rwlock_reader_unlock(&mb_lock);
+    if (nr > 0) {
+        for (size_t i = 0; i < nr; i++)
+            do_move_message(inst, msgs[i]);
+        mb_push(mb, msgs, nr, false);
+    }
+    mb_put(mb);
 
+done:
     if (errcode) {
         purc_set_error(errcode);
     }
 
-    return errcode;
+    return nr;
 }
 
-const pcrdr_msg *
-purc_inst_retrieve_message(size_t index)
+size_t
+purc_inst_move_message(purc_atom_t inst_to, pcrdr_msg *msg)
 {
-    struct pcinst* inst = pcinst_current();
-    if (inst == NULL)
-        return NULL;
-
-    int errcode = 0;
-    const pcrdr_msg *msg = NULL;
-    struct pcinst_move_buffer *mb;
+    return purc_inst_move_messages(inst_to, &msg, 1);
+}
 
-    purc_rwlock_reader_lock(&mb_lock);
+int
+purc_inst_holding_messages_count(size_t *nr)
+{
+    struct pcinst* inst = pcinst_current();
+    if (inst == NULL) {
+        purc_set_error(PURC_ERROR_NO_INSTANCE);
+        return PURC_ERROR_NO_INSTANCE;
+    }
 
-    if (!pcutils_sorted_array_find(mb_atom2buff_map,
-                (void *)(uintptr_t)inst->endpoint_atom, (void **)&mb, NULL)) {
-        errcode = PURC_ERROR_NOT_EXISTS;
-        goto done;
+    struct pcinst_move_buffer *mb = mb_find(inst->endpoint_atom);
+    if (mb == NULL) {
+        purc_set_error(PURC_ERROR_NOT_EXISTS);
+        return PURC_ERROR_NOT_EXISTS;
     }
 
-    purc_rwlock_reader_lock(&mb->lock);
-    if (index < mb->nr_msgs) {
-        struct list_head *p;
-        struct pcrdr_msg_hdr *hdr;
-        size_t i = 0;
+    /* only the messages ready to take away are counted */
+    mb_drain(mb);
+    *nr = mb->nr_local;
+    return 0;
+}
 
-        list_for_each(p, &mb->msgs) {
-            hdr = list_entry(p, struct pcrdr_msg_hdr, ln);
-            if (i == index) {
-                msg = (pcrdr_msg *)hdr;
-                break;
-            }
+const pcrdr_msg *
+purc_inst_retrieve_message(size_t index)
+{
+    struct pcinst* inst = pcinst_current();
+    if (inst == NULL)
+        return NULL;
 
-            i++;
-        }
+    struct pcinst_move_buffer *mb = mb_find(inst->endpoint_atom);
+    if (mb == NULL) {
+        purc_set_error(PURC_ERROR_NOT_EXISTS);
+        return NULL;
     }
-    purc_rwlock_reader_unlock(&mb->lock);
 
-done:
-    purc_rwlock_reader_unlock(&mb_lock);
+    if (!mb_fetch(mb, index))
+        return NULL;
 
-    if (errcode) {
-        purc_set_error(errcode);
+    struct list_head *p;
+    size_t i = 0;
+    list_for_each(p, &mb->msgs) {
+        if (i == index)
+            return (pcrdr_msg *)list_entry(p, struct pcrdr_msg_hdr, ln);
+        i++;
     }
 
-    return msg;
+    return NULL;
 }
 
 pcrdr_msg *
@@ -515,53 +931,68 @@ purc_inst_take_away_message(size_t index)
         return NULL;
     }
 
-    int errcode = 0;
-    pcrdr_msg *msg = NULL;
-    struct pcinst_move_buffer *mb;
-
-    purc_rwlock_reader_lock(&mb_lock);
-
-    if (!pcutils_sorted_array_find(mb_atom2buff_map,
-                (void *)(uintptr_t)inst->endpoint_atom, (void **)&mb, NULL)) {
-        errcode = PURC_ERROR_NOT_EXISTS;
-        goto done;
+    struct pcinst_move_buffer *mb = mb_find(inst->endpoint_atom);
+    if (mb == NULL || !mb_fetch(mb, index)) {
+        purc_set_error(PURC_ERROR_NOT_EXISTS);
+        return NULL;
     }
 
-    purc_rwlock_writer_lock(&mb->lock);
-    if (index < mb->nr_msgs) {
-        struct list_head *p, *n;
-        struct pcrdr_msg_hdr *hdr;
-        size_t i = 0;
-
-        list_for_each_safe(p, n, &mb->msgs) {
+    pcrdr_msg *msg = NULL;
+    struct list_head *p;
+    size_t i = 0;
+    list_for_each(p, &mb->msgs) {
+        if (i == index) {
+            struct pcrdr_msg_hdr *hdr;
             hdr = list_entry(p, struct pcrdr_msg_hdr, ln);
-            if (i == index) {
-                msg = (pcrdr_msg *)hdr;
-                list_del(p);
-                hdr->ln.next = hdr->ln.prev = NULL; /* mark as not linked */
-                mb->nr_msgs--;
-                break;
-            }
-
-            i++;
+            list_del(p);
+            hdr->ln.next = hdr->ln.prev = NULL; /* mark as not linked */
+            msg = (pcrdr_msg *)hdr;
+            break;
         }
+        i++;
     }
-    else {
-        errcode = PURC_ERROR_NOT_EXISTS;
+
+    assert(msg);
+    mb_count_taken(mb, 1);
+    do_take_message(inst, msg);
+    return msg;
+}
+
+size_t
+purc_inst_take_away_messages(pcrdr_msg **msgs, size_t max)
+{
+    struct pcinst* inst = pcinst_current();
+    if (inst == NULL) {
+        purc_set_error(PURC_ERROR_NO_INSTANCE);
+        return 0;
     }
-    purc_rwlock_writer_unlock(&mb->lock);
 
-    if (msg)
-        do_take_message(inst, msg);
+    struct pcinst_move_buffer *mb = mb_find(inst->endpoint_atom);
+    if (mb == NULL) {
+        purc_set_error(PURC_ERROR_NOT_EXISTS);
+        return 0;
+    }
 
-done:
-    purc_rwlock_reader_unlock(&mb_lock);
+    if (max == 0)
+        return 0;
 
-    if (errcode) {
-        purc_set_error(errcode);
+    mb_fetch(mb, max - 1);
+    size_t nr = (mb->nr_local < max) ? mb->nr_local : max;
+    if (nr == 0)
+        return 0;
+
+    for (size_t i = 0; i < nr; i++) {
+        struct pcrdr_msg_hdr *hdr;
+        hdr = list_first_entry(&mb->msgs, struct pcrdr_msg_hdr, ln);
+        list_del(&hdr->ln);
+        hdr->ln.next = hdr->ln.prev = NULL; /* mark as not linked */
+
+        msgs[i] = (pcrdr_msg *)hdr;
+        do_take_message(inst, msgs[i]);
     }
 
-    return msg;
+    mb_count_taken(mb, nr);
+    return nr;
 }
 
 #else   /* HAVE(STDATOMIC_H) */
@@ -619,6 +1050,15 @@ purc_inst_move_message(purc_atom_t inst_to, pcrdr_msg *msg)
     return 0;
 }
 
+size_t
+purc_inst_move_messages(purc_atom_t inst_to, pcrdr_msg **msgs, size_t count)
+{
+    UNUSED_PARAM(inst_to);
+    UNUSED_PARAM(msgs);
+    UNUSED_PARAM(count);
+    return 0;
+}
+
 int
 purc_inst_holding_messages_count(size_t *nr)
 {
@@ -643,6 +1083,15 @@ purc_inst_take_away_message(size_t index)
     return NULL;
 }
 
+size_t
+purc_inst_take_away_messages(pcrdr_msg **msgs, size_t max)
+{
+    UNUSED_PARAM(msgs);
+    UNUSED_PARAM(max);
+    purc_set_error(PURC_ERROR_NOT_SUPPORTED);
+    return 0;
+}
+
 #endif  /* !HAVE(STDATOMIC_H) */
 
 struct pcmodule _module_mvbuf = {
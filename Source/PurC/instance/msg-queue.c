@@ -30,6 +30,9 @@
 #include "private/utils.h"
 #include "private/variant.h"
 #include "private/msg-queue.h"
+#include "private/pcrdr.h"
+
+#include "purc-runloop.h"
 
 #if HAVE(GLIB)
     #include <gmodule.h>
@@ -37,6 +40,86 @@
 
 #include <sys/time.h>
 
+#if ENABLE(LOCKFREE_MSG_QUEUE)
+
+static void
+inbox_init(struct pcinst_msg_queue *queue)
+{
+    atomic_store_explicit(&queue->inbox_stub.next, NULL, memory_order_relaxed);
+    atomic_store_explicit(&queue->inbox_head, &queue->inbox_stub,
+            memory_order_relaxed);
+    queue->inbox_tail = &queue->inbox_stub;
+}
+
+/* called by any thread */
+static void
+inbox_push(struct pcinst_msg_queue *queue, struct pcinst_msg_hdr *hdr)
+{
+    atomic_store_explicit(&hdr->next, NULL, memory_order_relaxed);
+    struct pcinst_msg_hdr *prev = atomic_exchange_explicit(&queue->inbox_head,
+            hdr, memory_order_acq_rel);
+    atomic_store_explicit(&prev->next, hdr, memory_order_release);
+}
+
+/* called by the consumer only; returns NULL if the inbox is empty or
+   a producer is just pushing the only message. */
+static struct pcinst_msg_hdr *
+inbox_pop(struct pcinst_msg_queue *queue)
+{
+    struct pcinst_msg_hdr *tail = queue->inbox_tail;
+    struct pcinst_msg_hdr *next = atomic_load_explicit(&tail->next,
+            memory_order_acquire);
+
+    if (tail == &queue->inbox_stub) {
+        if (next == NULL)
+            return NULL;
+
+        queue->inbox_tail = next;
+        tail = next;
+        next = atomic_load_explicit(&next->next, memory_order_acquire);
+    }
+
+    if (next) {
+        queue->inbox_tail = next;
+        return tail;
+    }
+
+    if (tail != atomic_load_explicit(&queue->inbox_head, memory_order_acquire))
+        return NULL;
+
+    inbox_push(queue, &queue->inbox_stub);
+    next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    if (next) {
+        queue->inbox_tail = next;
+        return tail;
+    }
+
+    return NULL;
+}
+
+static void enqueue_msg(struct pcinst_msg_queue *queue, pcrdr_msg *msg,
+        bool tail);
+
+/* move the messages in the inbox to the lists in batch */
+static void
+drain_inbox(struct pcinst_msg_queue *queue)
+{
+    struct pcinst_msg_hdr *hdr;
+    while ((hdr = inbox_pop(queue))) {
+        enqueue_msg(queue, (pcrdr_msg *)hdr, true);
+    }
+}
+
+#define queue_lock(queue)       drain_inbox(queue)
+#define queue_unlock(queue)
+
+#else   /* ENABLE(LOCKFREE_MSG_QUEUE) */
+
+#define queue_lock(queue)       purc_rwlock_writer_lock(&(queue)->lock)
+#define queue_unlock(queue)     purc_rwlock_writer_unlock(&(queue)->lock)
+
+#endif  /* !ENABLE(LOCKFREE_MSG_QUEUE) */
+
 struct pcinst_msg_queue *
 pcinst_msg_queue_create(void)
 {
@@ -48,11 +131,15 @@ pcinst_msg_queue_create(void)
         goto done;
     }
 
+#if ENABLE(LOCKFREE_MSG_QUEUE)
+    inbox_init(queue);
+#else
     purc_rwlock_init(&queue->lock);
     if (queue->lock.native_impl == NULL) {
         errcode = PURC_ERROR_BAD_SYSTEM_CALL;
         goto done;
     }
+#endif
 
     queue->state = 0;
     queue->nr_msgs = 0;
@@ -60,14 +147,19 @@ pcinst_msg_queue_create(void)
     list_head_init(&queue->res_msgs);
     list_head_init(&queue->event_msgs);
     list_head_init(&queue->void_msgs);
+    queue->event_buckets = NULL;
+    queue->nr_event_buckets = 0;
+    queue->nr_events = 0;
 
 done:
 
     if (errcode) {
         if (queue) {
+#if !ENABLE(LOCKFREE_MSG_QUEUE)
             if (queue->lock.native_impl) {
                 purc_rwlock_clear(&queue->lock);
             }
+#endif
 
             free(queue);
         }
@@ -97,7 +189,7 @@ ssize_t
 pcinst_msg_queue_destroy(struct pcinst_msg_queue *queue)
 {
     ssize_t nr = 0;
-    purc_rwlock_writer_lock(&queue->lock);
+    queue_lock(queue);
 
     nr += grind_msg_list(&queue->req_msgs);
     nr += grind_msg_list(&queue->res_msgs);
@@ -105,9 +197,15 @@ pcinst_msg_queue_destroy(struct pcinst_msg_queue *queue)
     nr += grind_msg_list(&queue->void_msgs);
     queue->nr_msgs -= nr;
 
-    purc_rwlock_writer_unlock(&queue->lock);
+    free(queue->event_buckets);
+    queue->event_buckets = NULL;
+    queue->nr_events = 0;
 
+    queue_unlock(queue);
+
+#if !ENABLE(LOCKFREE_MSG_QUEUE)
     purc_rwlock_clear(&queue->lock);
+#endif
     free(queue);
 
     return nr;
@@ -134,150 +232,230 @@ get_timestamp_us(void)
     return (uint64_t)now.tv_sec * 1000000 + now.tv_usec;
 }
 
-int
-reduce_event(struct pcinst_msg_queue *queue, pcrdr_msg *msg, bool tail)
+static size_t
+event_hash(pcrdr_msg *msg)
+{
+    size_t hash = msg->target;
+    hash = hash * 31 + (size_t)msg->targetValue;
+    hash = hash * 31 + pcvariant_shallow_hash(msg->eventName);
+    hash = hash * 31 + pcvariant_shallow_hash(msg->elementValue);
+    return hash;
+}
+
+static inline struct list_head *
+event_bucket(struct pcinst_msg_queue *queue, size_t hash)
 {
+    return queue->event_buckets + (hash & (queue->nr_event_buckets - 1));
+}
+
+/* grow the index to keep the buckets short; keeps the order in buckets */
+static int
+grow_event_index(struct pcinst_msg_queue *queue)
+{
+    size_t nr_buckets = queue->nr_event_buckets ?
+        queue->nr_event_buckets * 2 : MSG_QUEUE_EVENT_BUCKETS_MIN;
+    struct list_head *buckets = malloc(sizeof(*buckets) * nr_buckets);
+    if (buckets == NULL) {
+        return -1;
+    }
+
+    for (size_t i = 0; i < nr_buckets; i++) {
+        list_head_init(buckets + i);
+    }
+
+    free(queue->event_buckets);
+    queue->event_buckets = buckets;
+    queue->nr_event_buckets = nr_buckets;
+
+    /* rehash in the order of the event list */
     struct pcinst_msg_hdr *hdr;
-    struct list_head *p, *n;
-    list_for_each_safe(p, n, &queue->event_msgs) {
-        hdr = list_entry(p, struct pcinst_msg_hdr, ln);
-        pcrdr_msg *orig = (pcrdr_msg*) hdr;
+    list_for_each_entry(hdr, &queue->event_msgs, ln) {
+        list_add_tail(&hdr->ln_hash,
+                event_bucket(queue, event_hash((pcrdr_msg *)hdr)));
+    }
+
+    return 0;
+}
+
+/* links an event just added to `event_msgs` to the index */
+static void
+index_event(struct pcinst_msg_queue *queue, pcrdr_msg *msg, bool tail)
+{
+    struct pcinst_msg_hdr *hdr = (struct pcinst_msg_hdr *)msg;
+
+    queue->nr_events++;
+    if (queue->nr_events > queue->nr_event_buckets * 2) {
+        /* the new event is linked by the rehashing */
+        if (grow_event_index(queue) == 0) {
+            return;
+        }
+
+        /* keep the original index if failed to grow */
+        if (queue->event_buckets == NULL) {
+            list_head_init(&hdr->ln_hash);
+            return;
+        }
+    }
+
+    struct list_head *bucket = event_bucket(queue, event_hash(msg));
+    if (tail) {
+        list_add_tail(&hdr->ln_hash, bucket);
+    }
+    else {
+        list_add(&hdr->ln_hash, bucket);
+    }
+}
+
+/* unlinks an event removed from `event_msgs` from the index */
+static void
+unindex_event(struct pcinst_msg_queue *queue, struct pcinst_msg_hdr *hdr)
+{
+    list_del_init(&hdr->ln_hash);
+    queue->nr_events--;
+}
+
+static pcrdr_msg *
+find_event_to_reduce(struct pcinst_msg_queue *queue, pcrdr_msg *msg)
+{
+    if (queue->event_buckets == NULL) {
+        return NULL;
+    }
+
+    struct list_head *bucket = event_bucket(queue, event_hash(msg));
+    struct pcinst_msg_hdr *hdr;
+    list_for_each_entry(hdr, bucket, ln_hash) {
+        pcrdr_msg *orig = (pcrdr_msg *)hdr;
         if (is_event_match(orig, msg)) {
-            if (msg->reduceOpt == PCRDR_MSG_EVENT_REDUCE_OPT_IGNORE) {
-                pcrdr_release_message(msg);
-                return 0;
-            }
-            // OVERLAY : data
-            if (orig->data) {
-                purc_variant_unref(orig->data);
-                orig->data = PURC_VARIANT_INVALID;
-            }
-            if (msg->data) {
-                orig->data = msg->data;
-                purc_variant_ref(orig->data);
-            }
-            pcrdr_release_message(msg);
-            return 0;
+            return orig;
         }
     }
 
-    hdr = (struct pcinst_msg_hdr *)msg;
-    /* keep timestamp */
-    msg->resultValue = get_timestamp_us();
+    return NULL;
+}
+
+static void
+add_event(struct pcinst_msg_queue *queue, pcrdr_msg *msg, bool tail)
+{
+    struct pcinst_msg_hdr *hdr = (struct pcinst_msg_hdr *)msg;
     if (tail) {
         list_add_tail(&hdr->ln, &queue->event_msgs);
     }
     else {
         list_add(&hdr->ln, &queue->event_msgs);
     }
+    index_event(queue, msg, tail);
     queue->state |= MSG_QS_EVENT;
     queue->nr_msgs++;
+}
 
+int
+reduce_event(struct pcinst_msg_queue *queue, pcrdr_msg *msg, bool tail)
+{
+    pcrdr_msg *orig = find_event_to_reduce(queue, msg);
+    if (orig) {
+        if (msg->reduceOpt == PCRDR_MSG_EVENT_REDUCE_OPT_IGNORE) {
+            pcrdr_release_message(msg);
+            return 0;
+        }
+        // OVERLAY : data
+        if (orig->data) {
+            purc_variant_unref(orig->data);
+            orig->data = PURC_VARIANT_INVALID;
+        }
+        if (msg->data) {
+            orig->data = msg->data;
+            purc_variant_ref(orig->data);
+        }
+        pcrdr_release_message(msg);
+        return 0;
+    }
+
+    add_event(queue, msg, tail);
     return 0;
 }
 
-int
-pcinst_msg_queue_append(struct pcinst_msg_queue *queue, pcrdr_msg *msg)
+static void
+enqueue_msg(struct pcinst_msg_queue *queue, pcrdr_msg *msg, bool tail)
 {
     struct pcinst_msg_hdr *hdr = (struct pcinst_msg_hdr *)msg;
-
-    purc_rwlock_writer_lock(&queue->lock);
+    struct list_head *msgs;
+    uint64_t state;
 
     switch (msg->type) {
-    case PCRDR_MSG_TYPE_VOID:
-        list_add_tail(&hdr->ln, &queue->void_msgs);
-        queue->state |= MSG_QS_VOID;
-        queue->nr_msgs++;
-        break;
-
     case PCRDR_MSG_TYPE_REQUEST:
-        list_add_tail(&hdr->ln, &queue->req_msgs);
-        queue->state |= MSG_QS_REQ;
-        queue->nr_msgs++;
+        msgs = &queue->req_msgs;
+        state = MSG_QS_REQ;
         break;
 
     case PCRDR_MSG_TYPE_RESPONSE:
-        list_add_tail(&hdr->ln, &queue->res_msgs);
-        queue->state |= MSG_QS_RES;
-        queue->nr_msgs++;
+        msgs = &queue->res_msgs;
+        state = MSG_QS_RES;
         break;
 
     case PCRDR_MSG_TYPE_EVENT:
         queue->state |= MSG_QS_EVENT;
         if (msg->reduceOpt == PCRDR_MSG_EVENT_REDUCE_OPT_KEEP) {
-            /* keep timestamp */
-            msg->resultValue = get_timestamp_us();
-            list_add_tail(&hdr->ln, &queue->event_msgs);
-            queue->state |= MSG_QS_EVENT;
-            queue->nr_msgs++;
+            add_event(queue, msg, tail);
         }
         else {
-            reduce_event(queue, msg, true);
+            reduce_event(queue, msg, tail);
         }
-        break;
+        return;
 
+    case PCRDR_MSG_TYPE_VOID:
     default:
-        list_add_tail(&hdr->ln, &queue->void_msgs);
-        queue->state |= MSG_QS_VOID;
-        queue->nr_msgs++;
+        msgs = &queue->void_msgs;
+        state = MSG_QS_VOID;
         break;
     }
 
-    purc_rwlock_writer_unlock(&queue->lock);
-    return 0;
+    if (tail) {
+        list_add_tail(&hdr->ln, msgs);
+    }
+    else {
+        list_add(&hdr->ln, msgs);
+    }
+    queue->state |= state;
+    queue->nr_msgs++;
 }
 
 int
-pcinst_msg_queue_prepend(struct pcinst_msg_queue *queue, pcrdr_msg *msg)
+pcinst_msg_queue_append(struct pcinst_msg_queue *queue, pcrdr_msg *msg)
 {
-    struct pcinst_msg_hdr *hdr = (struct pcinst_msg_hdr *)msg;
-
-    purc_rwlock_writer_lock(&queue->lock);
-
-    switch (msg->type) {
-    case PCRDR_MSG_TYPE_VOID:
-        list_add(&hdr->ln, &queue->void_msgs);
-        queue->state |= MSG_QS_VOID;
-        queue->nr_msgs++;
-        break;
-
-    case PCRDR_MSG_TYPE_REQUEST:
-        list_add(&hdr->ln, &queue->req_msgs);
-        queue->state |= MSG_QS_REQ;
-        queue->nr_msgs++;
-        break;
-
-    case PCRDR_MSG_TYPE_RESPONSE:
-        list_add(&hdr->ln, &queue->res_msgs);
-        queue->state |= MSG_QS_RES;
-        queue->nr_msgs++;
-        break;
+    /* keep the timestamp of posting; in the lock-free implementation
+       the message may stay in the inbox for a while before it is drained */
+    if (msg->type == PCRDR_MSG_TYPE_EVENT) {
+        msg->resultValue = get_timestamp_us();
+    }
 
-    case PCRDR_MSG_TYPE_EVENT:
-        queue->state |= MSG_QS_EVENT;
-        if (msg->reduceOpt == PCRDR_MSG_EVENT_REDUCE_OPT_KEEP) {
-            list_add(&hdr->ln, &queue->event_msgs);
-            queue->state |= MSG_QS_EVENT;
-            queue->nr_msgs++;
-        }
-        else {
-            reduce_event(queue, msg, false);
-        }
-        break;
+#if ENABLE(LOCKFREE_MSG_QUEUE)
+    inbox_push(queue, (struct pcinst_msg_hdr *)msg);
+#else
+    queue_lock(queue);
+    enqueue_msg(queue, msg, true);
+    queue_unlock(queue);
+#endif
+    return 0;
+}
 
-    default:
-        list_add(&hdr->ln, &queue->void_msgs);
-        queue->state |= MSG_QS_VOID;
-        queue->nr_msgs++;
-        break;
+int
+pcinst_msg_queue_prepend(struct pcinst_msg_queue *queue, pcrdr_msg *msg)
+{
+    /* a kept event prepended retains its original timestamp */
+    if (msg->type == PCRDR_MSG_TYPE_EVENT &&
+            msg->reduceOpt != PCRDR_MSG_EVENT_REDUCE_OPT_KEEP) {
+        msg->resultValue = get_timestamp_us();
     }
 
-    purc_rwlock_writer_unlock(&queue->lock);
+    queue_lock(queue);
+    enqueue_msg(queue, msg, false);
+    queue_unlock(queue);
     return 0;
 }
 
 static pcrdr_msg *
-get_msg(struct pcinst_msg_queue *queue, struct list_head *msgs)
+get_msg(struct pcinst_msg_queue *queue, struct list_head *msgs,
+        uint64_t state)
 {
     if (list_empty(msgs)) {
         return NULL;
@@ -286,48 +464,58 @@ get_msg(struct pcinst_msg_queue *queue, struct list_head *msgs)
             struct pcinst_msg_hdr, ln);
     pcrdr_msg *msg = (pcrdr_msg *)hdr;
     list_del(&hdr->ln);
+    if (msgs == &queue->event_msgs) {
+        unindex_event(queue, hdr);
+    }
     queue->nr_msgs--;
     if (list_empty(msgs)) {
-        queue->state &= ~MSG_QS_RES;
+        queue->state &= ~state;
     }
     return msg;
 }
 
-pcrdr_msg *
-pcinst_msg_queue_get_msg(struct pcinst_msg_queue *queue)
+static pcrdr_msg *
+get_next_msg(struct pcinst_msg_queue *queue)
 {
-    purc_rwlock_writer_lock(&queue->lock);
     pcrdr_msg *msg = NULL;
     if (queue->state & MSG_QS_RES) {
-        msg = get_msg(queue, &queue->res_msgs);
+        msg = get_msg(queue, &queue->res_msgs, MSG_QS_RES);
         if (msg) {
             goto done;
         }
     }
 
     if (queue->state & MSG_QS_REQ) {
-        msg = get_msg(queue, &queue->req_msgs);
+        msg = get_msg(queue, &queue->req_msgs, MSG_QS_REQ);
         if (msg) {
             goto done;
         }
     }
 
     if (queue->state & MSG_QS_EVENT) {
-        msg = get_msg(queue, &queue->event_msgs);
+        msg = get_msg(queue, &queue->event_msgs, MSG_QS_EVENT);
         if (msg) {
             goto done;
         }
     }
 
     if (queue->state & MSG_QS_VOID) {
-        msg = get_msg(queue, &queue->void_msgs);
+        msg = get_msg(queue, &queue->void_msgs, MSG_QS_VOID);
         if (msg) {
             goto done;
         }
     }
 
 done:
-    purc_rwlock_writer_unlock(&queue->lock);
+    return msg;
+}
+
+pcrdr_msg *
+pcinst_msg_queue_get_msg(struct pcinst_msg_queue *queue)
+{
+    queue_lock(queue);
+    pcrdr_msg *msg = get_next_msg(queue);
+    queue_unlock(queue);
     return msg;
 }
 
@@ -337,7 +525,7 @@ pcinst_msg_queue_get_event_by_element(struct pcinst_msg_queue *queue,
         purc_variant_t event_name)
 {
     pcrdr_msg *msg = NULL;
-    purc_rwlock_writer_lock(&queue->lock);
+    queue_lock(queue);
 
     struct list_head *msgs = &queue->event_msgs;
     struct list_head *p, *n;
@@ -350,11 +538,13 @@ pcinst_msg_queue_get_event_by_element(struct pcinst_msg_queue *queue,
                 purc_variant_is_equal_to(m->eventName, event_name)) {
             msg = m;
             list_del(&hdr->ln);
+            unindex_event(queue, hdr);
+            queue->nr_msgs--;
             break;
         }
     }
 
-    purc_rwlock_writer_unlock(&queue->lock);
+    queue_unlock(queue);
     return msg;
 }
 
@@ -375,6 +565,7 @@ purc_inst_post_event(purc_atom_t inst_to, pcrdr_msg *msg)
             return 0;
         }
 
+        int ret = 0;
         struct list_head *crtns;
         pcintr_coroutine_t p, q;
         if (PURC_EVENT_TARGET_BROADCAST != msg->targetValue) {
@@ -382,7 +573,8 @@ purc_inst_post_event(purc_atom_t inst_to, pcrdr_msg *msg)
             list_for_each_entry_safe(p, q, crtns, ln) {
                 pcintr_coroutine_t co = p;
                 if (co->cid == msg->targetValue) {
-                    return pcinst_msg_queue_append(co->mq, msg);
+                    ret = pcintr_coroutine_append_msg(co, msg);
+                    goto wakeup;
                 }
             }
 
@@ -390,10 +582,12 @@ purc_inst_post_event(purc_atom_t inst_to, pcrdr_msg *msg)
             list_for_each_entry_safe(p, q, crtns, ln) {
                 pcintr_coroutine_t co = p;
                 if (co->cid == msg->targetValue) {
-                    return pcinst_msg_queue_append(co->mq, msg);
+                    ret = pcintr_coroutine_append_msg(co, msg);
+                    goto wakeup;
                 }
             }
             pcrdr_release_message(msg);
+            return 0;
         }
         else {
             crtns = &heap->crtns;
@@ -401,7 +595,7 @@ purc_inst_post_event(purc_atom_t inst_to, pcrdr_msg *msg)
                 pcintr_coroutine_t co = p;
                 pcrdr_msg *my_msg = pcrdr_clone_message(msg);
                 my_msg->targetValue = co->cid;
-                pcinst_msg_queue_append(co->mq, my_msg);
+                pcintr_coroutine_append_msg(co, my_msg);
             }
 
             crtns = &heap->stopped_crtns;
@@ -409,12 +603,16 @@ purc_inst_post_event(purc_atom_t inst_to, pcrdr_msg *msg)
                 pcintr_coroutine_t co = p;
                 pcrdr_msg *my_msg = pcrdr_clone_message(msg);
                 my_msg->targetValue = co->cid;
-                pcinst_msg_queue_append(co->mq, my_msg);
+                pcintr_coroutine_append_msg(co, my_msg);
             }
             pcrdr_release_message(msg);
         }
 
-        return 0;
+wakeup:
+        /* the event may be posted by a timer or a fd monitor
+           when the scheduler is suspended */
+        purc_runloop_resume_idle_func(heap->owner->running_loop);
+        return ret;
     }
 
     int ret = 0;
@@ -482,6 +680,7 @@ pcinst_broadcast_event(pcrdr_msg_event_reduce_opt reduce_op,
     purc_variant_ref(msg->elementValue);
 
     msg->eventName = event_name;
+    pcrdr_msg_resolve_event_type(msg);
 
     if (data) {
         msg->dataType = PCRDR_MSG_DATA_TYPE_JSON;
@@ -496,9 +695,9 @@ size_t
 pcinst_msg_queue_count(struct pcinst_msg_queue *queue)
 {
     size_t nr = 0;
-    purc_rwlock_writer_lock(&queue->lock);
+    queue_lock(queue);
     nr = queue->nr_msgs;
-    purc_rwlock_writer_unlock(&queue->lock);
+    queue_unlock(queue);
     return nr;
 }
 
@@ -34,6 +34,135 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <limits.h>
+
+/* the maximal capability of a channel, so that the ring size never
+   overflows an unsigned int. */
+#define MAX_CHAN_CAPABILITY     (UINT_MAX / 2 + 1)
+
+struct chan_selector;
+
+struct selector_node {
+    /* the node in the selector list of a channel */
+    struct list_head        ln;
+    struct chan_selector   *sel;
+};
+
+/* a coroutine waiting to receive from any one of several channels */
+struct chan_selector {
+    pcintr_coroutine_t      crtn;
+    size_t                  nr_nodes;
+    struct selector_node    nodes[];
+};
+
+static inline unsigned int
+ring_slots(unsigned int cap)
+{
+    unsigned int n = 1;
+
+    while (n < cap)
+        n <<= 1;
+    return n;
+}
+
+static inline void
+ring_put(pcchan_t chan, purc_variant_t vrt)
+{
+    chan->data[chan->sendx & chan->mask] = vrt;
+    chan->sendx++;
+    chan->qcount++;
+}
+
+static inline purc_variant_t
+ring_peek(pcchan_t chan)
+{
+    return chan->data[chan->recvx & chan->mask];
+}
+
+static inline purc_variant_t
+ring_get(pcchan_t chan)
+{
+    unsigned int slot = chan->recvx & chan->mask;
+    purc_variant_t vrt = chan->data[slot];
+
+    chan->data[slot] = PURC_VARIANT_INVALID;
+    chan->recvx++;
+    chan->qcount--;
+    return vrt;
+}
+
+static void
+free_selector(struct chan_selector *sel)
+{
+    for (size_t i = 0; i < sel->nr_nodes; i++) {
+        list_del(&sel->nodes[i].ln);
+    }
+
+    free(sel);
+}
+
+static bool
+wake_up_first(struct list_head *crtns)
+{
+    if (list_empty(crtns))
+        return false;
+
+    pcintr_coroutine_t crtn = list_first_entry(crtns,
+            struct pcintr_coroutine, ln_stopped);
+    pcintr_resume_coroutine(crtn);
+    list_del(&crtn->ln_stopped);
+    return true;
+}
+
+static bool
+wake_up_selector(pcchan_t chan)
+{
+    if (list_empty(&chan->selectors))
+        return false;
+
+    struct selector_node *node = list_first_entry(&chan->selectors,
+            struct selector_node, ln);
+    pcintr_coroutine_t crtn = node->sel->crtn;
+    free_selector(node->sel);
+    pcintr_resume_coroutine(crtn);
+    return true;
+}
+
+/* resume the coroutines waiting for the @nr variants just sent */
+static void
+wake_up_receivers(pcchan_t chan, unsigned int nr)
+{
+    while (nr > 0) {
+        if (!wake_up_first(&chan->recv_crtns) && !wake_up_selector(chan))
+            break;
+        nr--;
+    }
+}
+
+/* resume the coroutines waiting for the @nr slots just freed */
+static void
+wake_up_senders(pcchan_t chan, unsigned int nr)
+{
+    while (nr > 0 && wake_up_first(&chan->send_crtns))
+        nr--;
+}
+
+/* called when the call is tried again after the wait timed out */
+static bool
+forget_waiting_crtn(struct list_head *crtns, pcintr_coroutine_t crtn)
+{
+    struct list_head *p, *n;
+    list_for_each_safe(p, n, crtns) {
+        struct pcintr_coroutine *_crtn;
+        _crtn = list_entry(p, struct pcintr_coroutine, ln_stopped);
+        if (_crtn == crtn) {
+            list_del(&crtn->ln_stopped);
+            return true;
+        }
+    }
+
+    return false;
+}
 
 void
 pcchan_destroy(pcchan_t chan)
@@ -43,6 +172,12 @@ pcchan_destroy(pcchan_t chan)
                 chan->name, chan->qcount);
     }
 
+    while (!list_empty(&chan->selectors)) {
+        struct selector_node *node = list_first_entry(&chan->selectors,
+                struct selector_node, ln);
+        free_selector(node->sel);
+    }
+
     free(chan->data);
     free(chan->name);
     free(chan);
@@ -58,7 +193,8 @@ pcchan_open(const char *chan_name, unsigned int cap)
         return NULL;
     }
 
-    if (UNLIKELY(chan_name == NULL || chan_name[0] == '\0' || cap == 0)) {
+    if (UNLIKELY(chan_name == NULL || chan_name[0] == '\0' || cap == 0 ||
+                cap > MAX_CHAN_CAPABILITY)) {
         inst->errcode = PURC_ERROR_INVALID_VALUE;
         return NULL;
     }
@@ -66,6 +202,7 @@ pcchan_open(const char *chan_name, unsigned int cap)
     pcintr_heap_t heap = inst->intr_heap;
     pcutils_map_entry* entry;
     pcchan_t chan;
+    unsigned int nr_slots = ring_slots(cap);
 
     entry = pcutils_map_find(heap->name_chan_map, chan_name);
     if (entry) {
@@ -74,13 +211,16 @@ pcchan_open(const char *chan_name, unsigned int cap)
             inst->errcode = PURC_ERROR_EXISTS;
             return NULL;
         }
-        else {
-            // reopen the existed channel
-            chan->data = realloc(chan->data, sizeof(purc_variant_t) * cap);
-            if (chan->data == NULL) {
+        else if (nr_slots > chan->mask + 1) {
+            // reopen the existed channel with a larger ring
+            purc_variant_t *data;
+            data = realloc(chan->data, sizeof(purc_variant_t) * nr_slots);
+            if (data == NULL) {
                 inst->errcode = PURC_ERROR_OUT_OF_MEMORY;
                 return NULL;
             }
+            chan->data = data;
+            chan->mask = nr_slots - 1;
             entry->val = chan;
         }
     }
@@ -91,12 +231,13 @@ pcchan_open(const char *chan_name, unsigned int cap)
             return NULL;
         }
 
-        chan->data = calloc(cap, sizeof(purc_variant_t));
+        chan->data = calloc(nr_slots, sizeof(purc_variant_t));
         if (chan->data == NULL) {
             inst->errcode = PURC_ERROR_OUT_OF_MEMORY;
             free(chan);
             return NULL;
         }
+        chan->mask = nr_slots - 1;
 
         chan->name = strdup(chan_name);
         if (pcutils_map_insert(heap->name_chan_map, chan->name, chan)) {
@@ -112,6 +253,7 @@ pcchan_open(const char *chan_name, unsigned int cap)
     chan->recvx = 0;
     list_head_init(&chan->send_crtns);
     list_head_init(&chan->recv_crtns);
+    list_head_init(&chan->selectors);
 
     return chan;
 }
@@ -122,17 +264,10 @@ discard_data(pcchan_t chan)
     unsigned int nr = 0;
 
     while (chan->qcount > 0) {
-        purc_variant_t vrt = chan->data[chan->recvx];
+        purc_variant_t vrt = ring_get(chan);
 
         assert(vrt);
         purc_variant_unref(vrt);
-
-        chan->data[chan->recvx] = PURC_VARIANT_INVALID;
-        chan->recvx++;
-        if (chan->recvx == chan->qsize)
-            chan->recvx = 0;
-
-        chan->qcount--;
         nr++;
     }
 
@@ -156,6 +291,8 @@ discard_data(pcchan_t chan)
         list_del(p);
     }
 
+    while (wake_up_selector(chan));
+
     return nr;
 }
 
@@ -190,29 +327,37 @@ pcchan_ctrl(pcchan_t chan, unsigned int new_cap)
         }
     }
     else if (new_cap > chan->qcount) {
-        purc_variant_t *newdata = malloc(sizeof(purc_variant_t) * new_cap);
-        if (newdata == NULL) {
-            inst->errcode = PURC_ERROR_OUT_OF_MEMORY;
+        if (new_cap > MAX_CHAN_CAPABILITY) {
+            inst->errcode = PURC_ERROR_INVALID_VALUE;
             goto failed;
         }
 
-        // copy channel fields and data
-        unsigned int i = 0;
-        while (chan->qcount > 0) {
-            newdata[i] = chan->data[chan->recvx];
-            chan->recvx++;
-            if (chan->recvx == chan->qsize)
-                chan->recvx = 0;
-            chan->qcount--;
-            i++;
+        unsigned int nr_slots = ring_slots(new_cap);
+        if (nr_slots > chan->mask + 1) {
+            purc_variant_t *newdata = malloc(sizeof(purc_variant_t) * nr_slots);
+            if (newdata == NULL) {
+                inst->errcode = PURC_ERROR_OUT_OF_MEMORY;
+                goto failed;
+            }
+
+            // copy the queued variants in order to the new ring
+            unsigned int i = 0;
+            while (chan->qcount > 0) {
+                newdata[i] = ring_get(chan);
+                i++;
+            }
+
+            chan->qcount = i;
+            chan->recvx = 0;
+            chan->sendx = i;
+            chan->mask = nr_slots - 1;
+
+            free(chan->data);
+            chan->data = newdata;
         }
 
+        // the ring is large enough; only change the capability
         chan->qsize = new_cap;
-        chan->recvx = 0;
-        chan->sendx = i;
-
-        free(chan->data);
-        chan->data = newdata;
     }
 
     return true;
@@ -247,6 +392,76 @@ pcchan_retrieve(const char *chan_name)
     return NULL;
 }
 
+pcchan_t
+pcchan_select(pcchan_t *chans, size_t nr_chans, unsigned call_flags)
+{
+    pcintr_coroutine_t crtn = pcintr_get_coroutine();
+    struct chan_selector *sel = NULL;
+
+    // remove the selector left by the last call if there is one.
+    if (crtn) {
+        for (size_t i = 0; i < nr_chans && sel == NULL; i++) {
+            struct selector_node *node;
+            list_for_each_entry(node, &chans[i]->selectors, ln) {
+                if (node->sel->crtn == crtn) {
+                    sel = node->sel;
+                    break;
+                }
+            }
+        }
+
+        if (sel)
+            free_selector(sel);
+    }
+
+    if (call_flags & PCVRT_CALL_FLAG_AGAIN &&
+            call_flags & PCVRT_CALL_FLAG_TIMEOUT) {
+        purc_set_error(sel ? PURC_ERROR_TIMEOUT : PURC_ERROR_INTERNAL_FAILURE);
+        return NULL;
+    }
+
+    size_t nr_alive = 0;
+    for (size_t i = 0; i < nr_chans; i++) {
+        if (chans[i]->qsize == 0)
+            continue;
+
+        if (chans[i]->qcount > 0)
+            return chans[i];
+        nr_alive++;
+    }
+
+    if (nr_alive == 0) {
+        purc_set_error(PURC_ERROR_ENTITY_GONE);
+        return NULL;
+    }
+
+    if (crtn) {
+        sel = malloc(sizeof(*sel) + sizeof(struct selector_node) * nr_alive);
+        if (sel == NULL) {
+            purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
+            return NULL;
+        }
+
+        sel->crtn = crtn;
+        sel->nr_nodes = 0;
+        for (size_t i = 0; i < nr_chans; i++) {
+            if (chans[i]->qsize == 0)
+                continue;
+
+            struct selector_node *node = sel->nodes + sel->nr_nodes;
+            node->sel = sel;
+            list_add_tail(&node->ln, &chans[i]->selectors);
+            sel->nr_nodes++;
+        }
+
+        // stop the current coroutine until any channel has data
+        pcintr_stop_coroutine(crtn, &crtn->timeout);
+    }
+
+    purc_set_error(PURC_ERROR_AGAIN);
+    return NULL;
+}
+
 static purc_variant_t
 send_getter(void *native_entity, size_t nr_args, purc_variant_t *argv,
                 unsigned call_flags)
@@ -257,17 +472,9 @@ send_getter(void *native_entity, size_t nr_args, purc_variant_t *argv,
     if (call_flags & PCVRT_CALL_FLAG_AGAIN &&
             call_flags & PCVRT_CALL_FLAG_TIMEOUT) {
 
-        if (crtn) {
-            struct list_head *p, *n;
-            list_for_each_safe(p, n, &chan->send_crtns) {
-                struct pcintr_coroutine *_crtn;
-                _crtn = list_entry(p, struct pcintr_coroutine, ln_stopped);
-                if (_crtn == crtn) {
-                    list_del(&crtn->ln_stopped);
-                    purc_set_error(PURC_ERROR_TIMEOUT);
-                    goto failed;
-                }
-            }
+        if (crtn && forget_waiting_crtn(&chan->send_crtns, crtn)) {
+            purc_set_error(PURC_ERROR_TIMEOUT);
+            goto failed;
         }
 
         purc_set_error(PURC_ERROR_INTERNAL_FAILURE);
@@ -290,19 +497,88 @@ send_getter(void *native_entity, size_t nr_args, purc_variant_t *argv,
     }
 
     if (chan->qcount < chan->qsize) {
-        chan->data[chan->sendx] = purc_variant_ref(argv[0]);
-        chan->sendx++;
-        if (chan->sendx == chan->qsize)
-            chan->sendx = 0;
-        chan->qcount++;
+        ring_put(chan, purc_variant_ref(argv[0]));
 
         // if there is any coroutine waiting to receive, resume the first one.
-        if (!list_empty(&chan->recv_crtns)) {
-            pcintr_coroutine_t crtn = list_first_entry(&chan->recv_crtns,
-                    struct pcintr_coroutine, ln_stopped);
-            pcintr_resume_coroutine(crtn);
-            list_del(&crtn->ln_stopped);
+        wake_up_receivers(chan, 1);
+    }
+    else {
+        if (crtn) {
+            // stop the current coroutine
+            pcintr_stop_coroutine(crtn, &crtn->timeout);
+            list_add_tail(&crtn->ln_stopped, &chan->send_crtns);
+        }
+
+        purc_set_error(PURC_ERROR_AGAIN);
+        return PURC_VARIANT_INVALID;
+    }
+
+    return purc_variant_make_boolean(true);
+
+failed:
+    if (call_flags & PCVRT_CALL_FLAG_SILENTLY)
+        return purc_variant_make_boolean(false);
+
+    return PURC_VARIANT_INVALID;
+}
+
+/* sends all members of a linear container, or nothing if there is
+   no room for all of them. */
+static purc_variant_t
+sendm_getter(void *native_entity, size_t nr_args, purc_variant_t *argv,
+                unsigned call_flags)
+{
+    pcchan_t chan = native_entity;
+    pcintr_coroutine_t crtn = pcintr_get_coroutine();
+    size_t nr_vrts;
+
+    if (call_flags & PCVRT_CALL_FLAG_AGAIN &&
+            call_flags & PCVRT_CALL_FLAG_TIMEOUT) {
+
+        if (crtn && forget_waiting_crtn(&chan->send_crtns, crtn)) {
+            purc_set_error(PURC_ERROR_TIMEOUT);
+            goto failed;
         }
+
+        purc_set_error(PURC_ERROR_INTERNAL_FAILURE);
+        goto failed;
+    }
+
+    if (nr_args < 1) {
+        purc_set_error(PURC_ERROR_ARGUMENT_MISSED);
+        goto failed;
+    }
+
+    if (chan->qsize == 0) {
+        purc_set_error(PURC_ERROR_ENTITY_GONE);
+        goto failed;
+    }
+
+    if (!purc_variant_linear_container_size(argv[0], &nr_vrts)) {
+        purc_set_error(PURC_ERROR_WRONG_DATA_TYPE);
+        goto failed;
+    }
+
+    if (nr_vrts > chan->qsize) {
+        purc_set_error(PURC_ERROR_TOO_MANY);
+        goto failed;
+    }
+
+    for (size_t i = 0; i < nr_vrts; i++) {
+        purc_variant_t vrt = purc_variant_linear_container_get(argv[0], i);
+        if (purc_variant_is_undefined(vrt)) {
+            purc_set_error(PURC_ERROR_INVALID_VALUE);
+            goto failed;
+        }
+    }
+
+    if (chan->qsize - chan->qcount >= nr_vrts) {
+        for (size_t i = 0; i < nr_vrts; i++) {
+            purc_variant_t vrt = purc_variant_linear_container_get(argv[0], i);
+            ring_put(chan, purc_variant_ref(vrt));
+        }
+
+        wake_up_receivers(chan, nr_vrts);
     }
     else {
         if (crtn) {
@@ -337,17 +613,9 @@ recv_getter(void *native_entity, size_t nr_args, purc_variant_t *argv,
     if (call_flags & PCVRT_CALL_FLAG_AGAIN &&
             call_flags & PCVRT_CALL_FLAG_TIMEOUT) {
 
-        if (crtn) {
-            struct list_head *p, *n;
-            list_for_each_safe(p, n, &chan->send_crtns) {
-                struct pcintr_coroutine *_crtn;
-                _crtn = list_entry(p, struct pcintr_coroutine, ln_stopped);
-                if (_crtn == crtn) {
-                    list_del(&crtn->ln_stopped);
-                    purc_set_error(PURC_ERROR_TIMEOUT);
-                    goto failed;
-                }
-            }
+        if (crtn && forget_waiting_crtn(&chan->recv_crtns, crtn)) {
+            purc_set_error(PURC_ERROR_TIMEOUT);
+            goto failed;
         }
 
         purc_set_error(PURC_ERROR_INTERNAL_FAILURE);
@@ -361,19 +629,10 @@ recv_getter(void *native_entity, size_t nr_args, purc_variant_t *argv,
 
     purc_variant_t vrt = PURC_VARIANT_INVALID;
     if (chan->qcount > 0) {
-        vrt = chan->data[chan->recvx];
-        chan->recvx++;
-        if (chan->recvx == chan->qsize)
-            chan->recvx = 0;
-        chan->qcount--;
+        vrt = ring_get(chan);
 
         // if there is any coroutine waiting to send, resume the first one.
-        if (!list_empty(&chan->send_crtns)) {
-            pcintr_coroutine_t crtn = list_first_entry(&chan->send_crtns,
-                    struct pcintr_coroutine, ln_stopped);
-            pcintr_resume_coroutine(crtn);
-            list_del(&crtn->ln_stopped);
-        }
+        wake_up_senders(chan, 1);
     }
     else {
         if (crtn) {
@@ -395,6 +654,87 @@ failed:
     return PURC_VARIANT_INVALID;
 }
 
+/* receives all available variants, but not more than the given maximum,
+   in an array. */
+static purc_variant_t
+recvm_getter(void *native_entity, size_t nr_args, purc_variant_t *argv,
+                unsigned call_flags)
+{
+    pcchan_t chan = native_entity;
+    pcintr_coroutine_t crtn = pcintr_get_coroutine();
+    uint32_t max = UINT32_MAX;
+
+    if (call_flags & PCVRT_CALL_FLAG_AGAIN &&
+            call_flags & PCVRT_CALL_FLAG_TIMEOUT) {
+
+        if (crtn && forget_waiting_crtn(&chan->recv_crtns, crtn)) {
+            purc_set_error(PURC_ERROR_TIMEOUT);
+            goto failed;
+        }
+
+        purc_set_error(PURC_ERROR_INTERNAL_FAILURE);
+        goto failed;
+    }
+
+    if (nr_args > 0) {
+        if (!purc_variant_cast_to_uint32(argv[0], &max, false)) {
+            purc_set_error(PURC_ERROR_WRONG_DATA_TYPE);
+            goto failed;
+        }
+
+        if (max == 0) {
+            purc_set_error(PURC_ERROR_INVALID_VALUE);
+            goto failed;
+        }
+    }
+
+    if (chan->qsize == 0) {
+        purc_set_error(PURC_ERROR_ENTITY_GONE);
+        goto failed;
+    }
+
+    if (chan->qcount > 0) {
+        purc_variant_t arr;
+        arr = purc_variant_make_array(0, PURC_VARIANT_INVALID);
+        if (arr == PURC_VARIANT_INVALID)
+            goto failed;
+
+        unsigned int nr = 0;
+        while (chan->qcount > 0 && nr < max) {
+            // take the variant away only after it was appended.
+            if (!purc_variant_array_append(arr, ring_peek(chan)))
+                break;
+            purc_variant_unref(ring_get(chan));
+            nr++;
+        }
+
+        if (nr == 0) {
+            purc_variant_unref(arr);
+            goto failed;
+        }
+
+        // resume the coroutines waiting to send.
+        wake_up_senders(chan, nr);
+        return arr;
+    }
+    else {
+        if (crtn) {
+            // stop the current coroutine
+            pcintr_stop_coroutine(crtn, &crtn->timeout);
+            list_add_tail(&crtn->ln_stopped, &chan->recv_crtns);
+        }
+
+        purc_set_error(PURC_ERROR_AGAIN);
+        return PURC_VARIANT_INVALID;
+    }
+
+failed:
+    if (call_flags & PCVRT_CALL_FLAG_SILENTLY)
+        return purc_variant_make_undefined();
+
+    return PURC_VARIANT_INVALID;
+}
+
 static purc_variant_t
 cap_getter(void *native_entity, size_t nr_args, purc_variant_t *argv,
                 unsigned call_flags)
@@ -448,12 +788,18 @@ property_getter(void *entity, const char *name)
         if (strcmp(name, "send") == 0) {
             return send_getter;
         }
+        else if (strcmp(name, "sendm") == 0) {
+            return sendm_getter;
+        }
         break;
 
     case 'r':
         if (strcmp(name, "recv") == 0) {
             return recv_getter;
         }
+        else if (strcmp(name, "recvm") == 0) {
+            return recvm_getter;
+        }
         break;
 
     case 'c':
@@ -57,7 +57,7 @@ ctxt_for_bind_destroy(struct ctxt_for_bind *ctxt)
         PURC_VARIANT_SAFE_CLEAR(ctxt->as);
         PURC_VARIANT_SAFE_CLEAR(ctxt->at);
         PURC_VARIANT_SAFE_CLEAR(ctxt->against);
-        free(ctxt);
+        pcintr_ctxt_free(ctxt, sizeof(*ctxt));
     }
 }
 
@@ -397,7 +397,7 @@ after_pushed(pcintr_stack_t stack, pcvdom_element_t pos)
 
     struct ctxt_for_bind *ctxt = frame->ctxt;
     if (!ctxt) {
-        ctxt = (struct ctxt_for_bind*)calloc(1, sizeof(*ctxt));
+        ctxt = (struct ctxt_for_bind*)pcintr_ctxt_alloc(sizeof(*ctxt));
         if (!ctxt) {
             purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
             return NULL;
@@ -85,7 +85,7 @@ ctxt_for_call_destroy(struct ctxt_for_call *ctxt)
                     ctxt->endpoint_name_within);
             ctxt->endpoint_atom_within = 0;
         }
-        free(ctxt);
+        pcintr_ctxt_free(ctxt, sizeof(*ctxt));
     }
 }
 
@@ -465,7 +465,7 @@ after_pushed(pcintr_stack_t stack, pcvdom_element_t pos)
 
     struct ctxt_for_call *ctxt = frame->ctxt;
     if (!ctxt) {
-        ctxt = (struct ctxt_for_call*)calloc(1, sizeof(*ctxt));
+        ctxt = (struct ctxt_for_call*)pcintr_ctxt_alloc(sizeof(*ctxt));
         if (!ctxt) {
             purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
             return NULL;
@@ -50,7 +50,7 @@ ctxt_for_catch_destroy(struct ctxt_for_catch *ctxt)
     if (ctxt) {
         PURC_VARIANT_SAFE_CLEAR(ctxt->for_var);
 
-        free(ctxt);
+        pcintr_ctxt_free(ctxt, sizeof(*ctxt));
     }
 }
 
@@ -148,7 +148,7 @@ _after_pushed(pcintr_stack_t stack, pcvdom_element_t pos,
 
     struct ctxt_for_catch *ctxt = frame->ctxt;
     if (!ctxt) {
-        ctxt = (struct ctxt_for_catch*)calloc(1, sizeof(*ctxt));
+        ctxt = (struct ctxt_for_catch*)pcintr_ctxt_alloc(sizeof(*ctxt));
         if (!ctxt) {
             purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
             return NULL;
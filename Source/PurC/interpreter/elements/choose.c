@@ -55,7 +55,7 @@ ctxt_for_choose_destroy(struct ctxt_for_choose *ctxt)
         PURC_VARIANT_SAFE_CLEAR(ctxt->in);
         PURC_VARIANT_SAFE_CLEAR(ctxt->with);
 
-        free(ctxt);
+        pcintr_ctxt_free(ctxt, sizeof(*ctxt));
     }
 }
 
@@ -342,7 +342,7 @@ after_pushed(pcintr_stack_t stack, pcvdom_element_t pos)
 
     struct ctxt_for_choose *ctxt = frame->ctxt;
     if (!ctxt) {
-        ctxt = (struct ctxt_for_choose*)calloc(1, sizeof(*ctxt));
+        ctxt = (struct ctxt_for_choose*)pcintr_ctxt_alloc(sizeof(*ctxt));
         if (!ctxt) {
             purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
             return NULL;
@@ -43,7 +43,7 @@ static void
 ctxt_for_differ_destroy(struct ctxt_for_differ *ctxt)
 {
     if (ctxt) {
-        free(ctxt);
+        pcintr_ctxt_free(ctxt, sizeof(*ctxt));
     }
 }
 
@@ -79,7 +79,7 @@ after_pushed(pcintr_stack_t stack, pcvdom_element_t pos)
 
     struct ctxt_for_differ *ctxt = frame->ctxt;
     if (!ctxt) {
-        ctxt = (struct ctxt_for_differ*)calloc(1, sizeof(*ctxt));
+        ctxt = (struct ctxt_for_differ*)pcintr_ctxt_alloc(sizeof(*ctxt));
         if (!ctxt) {
             purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
             return NULL;
@@ -73,7 +73,7 @@ ctxt_for_except_destroy(struct ctxt_for_except *ctxt)
             purc_rwstream_destroy(ctxt->resp);
             ctxt->resp = NULL;
         }
-        free(ctxt);
+        pcintr_ctxt_free(ctxt, sizeof(*ctxt));
     }
 }
 
@@ -445,7 +445,7 @@ after_pushed(pcintr_stack_t stack, pcvdom_element_t pos)
 
     struct ctxt_for_except *ctxt = frame->ctxt;
     if (!ctxt) {
-        ctxt = (struct ctxt_for_except*)calloc(1, sizeof(*ctxt));
+        ctxt = (struct ctxt_for_except*)pcintr_ctxt_alloc(sizeof(*ctxt));
         if (!ctxt) {
             purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
             return NULL;
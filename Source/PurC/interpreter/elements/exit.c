@@ -43,7 +43,7 @@ ctxt_for_exit_destroy(struct ctxt_for_exit *ctxt)
     if (ctxt) {
         PURC_VARIANT_SAFE_CLEAR(ctxt->with);
 
-        free(ctxt);
+        pcintr_ctxt_free(ctxt, sizeof(*ctxt));
     }
 }
 
@@ -110,7 +110,7 @@ after_pushed(pcintr_stack_t stack, pcvdom_element_t pos)
 
     struct ctxt_for_exit *ctxt = frame->ctxt;
     if (!ctxt) {
-        ctxt = (struct ctxt_for_exit*)calloc(1, sizeof(*ctxt));
+        ctxt = (struct ctxt_for_exit*)pcintr_ctxt_alloc(sizeof(*ctxt));
         if (!ctxt) {
             purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
             return NULL;
@@ -94,7 +94,7 @@ ctxt_for_init_destroy(struct ctxt_for_init *ctxt)
             purc_rwstream_destroy(ctxt->resp);
             ctxt->resp = NULL;
         }
-        free(ctxt);
+        pcintr_ctxt_free(ctxt, sizeof(*ctxt));
     }
 }
 
@@ -1028,7 +1028,7 @@ after_pushed(pcintr_stack_t stack, pcvdom_element_t pos)
 
     struct ctxt_for_init *ctxt = frame->ctxt;
     if (!ctxt) {
-        ctxt = (struct ctxt_for_init*)calloc(1, sizeof(*ctxt));
+        ctxt = (struct ctxt_for_init*)pcintr_ctxt_alloc(sizeof(*ctxt));
         if (!ctxt) {
             purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
             return NULL;
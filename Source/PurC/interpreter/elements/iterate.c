@@ -121,7 +121,7 @@ ctxt_for_iterate_destroy(struct ctxt_for_iterate *ctxt)
         PURC_VARIANT_SAFE_CLEAR(ctxt->with);
         PURC_VARIANT_SAFE_CLEAR(ctxt->val_from_func);
 
-        free(ctxt);
+        pcintr_ctxt_free(ctxt, sizeof(*ctxt));
     }
 }
 
@@ -898,7 +898,7 @@ prepare(pcintr_stack_t stack, struct pcintr_stack_frame *frame)
     UNUSED_PARAM(frame);
     struct ctxt_for_iterate *ctxt = frame->ctxt;
     if (!ctxt) {
-        ctxt = (struct ctxt_for_iterate*)calloc(1, sizeof(*ctxt));
+        ctxt = (struct ctxt_for_iterate*)pcintr_ctxt_alloc(sizeof(*ctxt));
         if (!ctxt) {
             purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
             return PURC_ERROR_OUT_OF_MEMORY;
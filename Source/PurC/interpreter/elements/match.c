@@ -58,7 +58,7 @@ ctxt_for_match_destroy(struct ctxt_for_match *ctxt)
         PURC_VARIANT_SAFE_CLEAR(ctxt->exclusively);
 
         match_for_param_reset(&ctxt->param);
-        free(ctxt);
+        pcintr_ctxt_free(ctxt, sizeof(*ctxt));
     }
 }
 
@@ -204,7 +204,7 @@ after_pushed(pcintr_stack_t stack, pcvdom_element_t pos)
 
     struct ctxt_for_match *ctxt = frame->ctxt;
     if (!ctxt) {
-        ctxt = (struct ctxt_for_match*)calloc(1, sizeof(*ctxt));
+        ctxt = (struct ctxt_for_match*)pcintr_ctxt_alloc(sizeof(*ctxt));
         if (!ctxt) {
             purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
             return NULL;
@@ -76,7 +76,7 @@ ctxt_for_observe_destroy(struct ctxt_for_observe *ctxt)
             free(ctxt->sub_type);
             ctxt->sub_type = NULL;
         }
-        free(ctxt);
+        pcintr_ctxt_free(ctxt, sizeof(*ctxt));
     }
 }
 
@@ -685,7 +685,7 @@ after_pushed(pcintr_stack_t stack, pcvdom_element_t pos)
 
     struct ctxt_for_observe *ctxt = frame->ctxt;
     if (!ctxt) {
-        ctxt = (struct ctxt_for_observe*)calloc(1, sizeof(*ctxt));
+        ctxt = (struct ctxt_for_observe*)pcintr_ctxt_alloc(sizeof(*ctxt));
         if (!ctxt) {
             purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
             return NULL;
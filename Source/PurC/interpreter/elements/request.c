@@ -69,7 +69,7 @@ ctxt_for_request_destroy(struct ctxt_for_request *ctxt)
         PURC_VARIANT_SAFE_CLEAR(ctxt->as);
         PURC_VARIANT_SAFE_CLEAR(ctxt->with);
         PURC_VARIANT_SAFE_CLEAR(ctxt->request_id);
-        free(ctxt);
+        pcintr_ctxt_free(ctxt, sizeof(*ctxt));
     }
 }
 
@@ -760,7 +760,7 @@ after_pushed(pcintr_stack_t stack, pcvdom_element_t pos)
 
     struct ctxt_for_request *ctxt = frame->ctxt;
     if (!ctxt) {
-        ctxt = (struct ctxt_for_request*)calloc(1, sizeof(*ctxt));
+        ctxt = (struct ctxt_for_request*)pcintr_ctxt_alloc(sizeof(*ctxt));
         if (!ctxt) {
             purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
             return NULL;
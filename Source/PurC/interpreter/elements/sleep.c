@@ -63,7 +63,7 @@ ctxt_for_sleep_destroy(struct ctxt_for_sleep *ctxt)
         }
         PURC_VARIANT_SAFE_CLEAR(ctxt->element_value);
 
-        free(ctxt);
+        pcintr_ctxt_free(ctxt, sizeof(*ctxt));
     }
 }
 
@@ -391,7 +391,7 @@ after_pushed(pcintr_stack_t stack, pcvdom_element_t pos)
 
     struct ctxt_for_sleep *ctxt = frame->ctxt;
     if (!ctxt) {
-        ctxt = (struct ctxt_for_sleep*)calloc(1, sizeof(*ctxt));
+        ctxt = (struct ctxt_for_sleep*)pcintr_ctxt_alloc(sizeof(*ctxt));
         if (!ctxt) {
             purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
             return NULL;
@@ -440,7 +440,7 @@ after_pushed(pcintr_stack_t stack, pcvdom_element_t pos)
     }
 
     ctxt->co = stack->co;
-    ctxt->timer = pcintr_timer_create(NULL, NULL, on_sleep_timeout, ctxt);
+    ctxt->timer = pcintr_wheel_timer_create(NULL, on_sleep_timeout, ctxt);
     if (!ctxt->timer)
         return ctxt;
 
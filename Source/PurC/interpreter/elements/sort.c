@@ -92,7 +92,7 @@ ctxt_for_sort_destroy(struct ctxt_for_sort *ctxt)
             pcintr_unload_module(ctxt->handle);
             ctxt->handle = NULL;
         }
-        free(ctxt);
+        pcintr_ctxt_free(ctxt, sizeof(*ctxt));
     }
 }
 
@@ -594,7 +594,7 @@ after_pushed(pcintr_stack_t stack, pcvdom_element_t pos)
 
     struct ctxt_for_sort *ctxt = frame->ctxt;
     if (!ctxt) {
-        ctxt = (struct ctxt_for_sort*)calloc(1, sizeof(*ctxt));
+        ctxt = (struct ctxt_for_sort*)pcintr_ctxt_alloc(sizeof(*ctxt));
         if (!ctxt) {
             purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
             return NULL;
@@ -65,7 +65,7 @@ ctxt_for_test_destroy(struct ctxt_for_test *ctxt)
         PURC_VARIANT_SAFE_CLEAR(ctxt->in);
         PURC_VARIANT_SAFE_CLEAR(ctxt->with);
 
-        free(ctxt);
+        pcintr_ctxt_free(ctxt, sizeof(*ctxt));
     }
 }
 
@@ -310,7 +310,7 @@ after_pushed(pcintr_stack_t stack, pcvdom_element_t pos)
 
     struct ctxt_for_test *ctxt = frame->ctxt;
     if (!ctxt) {
-        ctxt = (struct ctxt_for_test*)calloc(1, sizeof(*ctxt));
+        ctxt = (struct ctxt_for_test*)pcintr_ctxt_alloc(sizeof(*ctxt));
         if (!ctxt) {
             purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
             return NULL;
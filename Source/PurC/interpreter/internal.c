@@ -41,7 +41,13 @@
 #include <string.h>
 
 #define ATTR_NAME_AS       "as"
-#define MIN_BUFFER         512
+#define ATTR_NAME_ON       "on"
+#define ATTR_NAME_WITH     "with"
+#define ATTR_NAME_TARGET   "target"
+#define ATTR_NAME_SILENTLY "silently"
+
+#define REQ_ARGS           "_args"
+#define REQ_CONTENT        "_content"
 
 #define REQUEST_ID_KEY_HANDLE   "__pcintr_request_id_handle"
 #define REQUEST_ID_KEY_TYPE     "type"
@@ -52,21 +58,6 @@
 #define USE_REQUEST_ID_AS_CRTN_OBSERVED     1
 
 
-static const char doctypeTemplate[] = "<!DOCTYPE hvml SYSTEM \"%s\">\n";
-
-static const char callTemplateHead[] =
-"<hvml target=\"void\">\n";
-
-static const char callTemplateFoot[] =
-"    <call on $%s with $REQ._args silently>\n"
-"        $REQ._content\n"
-"        <exit with $? />\n"
-"    </call>\n"
-"</hvml>\n";
-
-#define  ATTR_ID            "id"
-#define  ATTR_IDD_BY        "idd-by"
-
 bool
 pcintr_match_id(pcintr_stack_t stack, struct pcvdom_element *elem,
         const char *id)
@@ -75,22 +66,16 @@ pcintr_match_id(pcintr_stack_t stack, struct pcvdom_element *elem,
         return false;
     }
 
-    struct pcvdom_attr *attr;
-
-    const char *name = elem->tag_name;
-    const struct pchvml_tag_entry* entry = pchvml_tag_static_search(name,
-            strlen(name));
-    if (entry &&
-            (entry->cats & (PCHVML_TAGCAT_TEMPLATE | PCHVML_TAGCAT_VERB))) {
-        attr = pcvdom_element_find_attr(elem, ATTR_IDD_BY);
-    }
-    else {
-        attr = pcvdom_element_find_attr(elem, ATTR_ID);
-    }
+    const char *anchor;
+    struct pcvdom_attr *attr = pcvdom_element_anchor_attr(elem, &anchor);
     if (!attr) {
         return false;
     }
 
+    if (anchor) {
+        return strcmp(anchor, id) == 0;
+    }
+
     bool silently = false;
     purc_variant_t v = pcintr_eval_vcm(stack, attr->val, silently);
     purc_clr_error();
@@ -460,12 +445,138 @@ pcintr_get_named_variable_mgr_by_at(pcintr_stack_t stack,
     return mgr;
 }
 
+static struct pcvcm_node *
+make_get_variable(const char *name)
+{
+    struct pcvcm_node *str = pcvcm_node_new_string(name);
+    if (!str)
+        return NULL;
+
+    struct pcvcm_node *node = pcvcm_node_new_get_variable(str);
+    if (!node)
+        pcvcm_node_destroy(str);
+    return node;
+}
+
+/* makes `$<var>.<key>`; takes the ownership of @var */
+static struct pcvcm_node *
+make_get_element(struct pcvcm_node *var, const char *key)
+{
+    struct pcvcm_node *str = NULL;
+    struct pcvcm_node *node = NULL;
+
+    if (!var)
+        goto failed;
+
+    if ((str = pcvcm_node_new_string(key)) == NULL)
+        goto failed;
+
+    if ((node = pcvcm_node_new_get_element(var, str)) == NULL)
+        goto failed;
+
+    return node;
+
+failed:
+    if (str)
+        pcvcm_node_destroy(str);
+    if (var)
+        pcvcm_node_destroy(var);
+    return NULL;
+}
+
+/* takes the ownership of @vcm */
 static int
-serial_element(const char *buf, size_t len, void *ctxt)
+append_attr(struct pcvdom_element *elem, const char *key,
+        struct pcvcm_node *vcm)
 {
-    purc_rwstream_t rws = (purc_rwstream_t) ctxt;
-    purc_rwstream_write(rws, buf, len);
-    return 0;
+    struct pcvdom_attr *attr = pcvdom_attr_create_simple(key, vcm);
+    if (!attr) {
+        if (vcm)
+            pcvcm_node_destroy(vcm);
+        return -1;
+    }
+
+    return pcvdom_element_append_attr(elem, attr);
+}
+
+/*
+ * Builds the vDOM for a concurrent call from the `define` element directly,
+ * which is equivalent to the following HVML program:
+ *
+ * <!DOCTYPE hvml SYSTEM "<the system info of the caller>">
+ * <hvml target="void">
+ *     <define as="<as>"> ... </define>
+ *     <call on $<as> with $REQ._args silently>
+ *         $REQ._content
+ *         <exit with $? />
+ *     </call>
+ * </hvml>
+ */
+static purc_vdom_t
+build_call_vdom(purc_vdom_t doc, pcvdom_element_t define, const char *as)
+{
+    struct pcvdom_element *hvml, *call, *exit;
+    struct pcvdom_content *content;
+    struct pcvdom_node *node;
+    struct pcvcm_node *vcm;
+
+    purc_vdom_t vdom = pcvdom_document_create();
+    if (!vdom)
+        return NULL;
+
+    if (pcvdom_document_set_doctype(vdom,
+                doc->doctype.name ? doc->doctype.name : "",
+                doc->doctype.system_info ? doc->doctype.system_info : "v:"))
+        goto failed;
+    vdom->quirks = doc->quirks;
+
+    if ((hvml = pcvdom_element_create(PCHVML_TAG_HVML)) == NULL)
+        goto failed;
+    pcvdom_document_set_root(vdom, hvml);
+    if ((vcm = pcvcm_node_new_string("void")) == NULL ||
+            append_attr(hvml, ATTR_NAME_TARGET, vcm))
+        goto failed;
+
+    if ((node = pcvdom_node_clone(&define->node)) == NULL)
+        goto failed;
+    pcvdom_element_append_element(hvml, PCVDOM_ELEMENT_FROM_NODE(node));
+
+    if ((call = pcvdom_element_create(PCHVML_TAG_CALL)) == NULL)
+        goto failed;
+    pcvdom_element_append_element(hvml, call);
+    if ((vcm = make_get_variable(as)) == NULL ||
+            append_attr(call, ATTR_NAME_ON, vcm))
+        goto failed;
+    vcm = make_get_element(make_get_variable(PURC_PREDEF_VARNAME_REQ),
+            REQ_ARGS);
+    if (vcm == NULL || append_attr(call, ATTR_NAME_WITH, vcm))
+        goto failed;
+    if (append_attr(call, ATTR_NAME_SILENTLY, NULL))
+        goto failed;
+
+    vcm = make_get_element(make_get_variable(PURC_PREDEF_VARNAME_REQ),
+            REQ_CONTENT);
+    if (vcm == NULL)
+        goto failed;
+    if ((content = pcvdom_content_create(vcm)) == NULL) {
+        pcvcm_node_destroy(vcm);
+        goto failed;
+    }
+    pcvdom_element_append_content(call, content);
+
+    if ((exit = pcvdom_element_create(PCHVML_TAG_EXIT)) == NULL)
+        goto failed;
+    exit->self_closing = 1;
+    pcvdom_element_append_element(call, exit);
+    if ((vcm = make_get_variable("?")) == NULL ||
+            append_attr(exit, ATTR_NAME_WITH, vcm))
+        goto failed;
+
+    return vdom;
+
+failed:
+    pcvdom_document_unref(vdom);
+    return NULL;
 }
 
 purc_vdom_t
@@ -473,12 +584,8 @@ pcintr_build_concurrently_call_vdom(pcintr_stack_t stack,
         pcvdom_element_t element)
 {
     purc_vdom_t vdom = NULL;
-    char *foot = NULL;
-    purc_rwstream_t rws = NULL;
+    char *key = NULL;
     const char *as;
-    struct pcvdom_doctype  *doctype;
-    size_t nr_hvml;
-    const char *hvml;
     purc_variant_t as_var = PURC_VARIANT_INVALID;
 
     struct pcvdom_attr *as_attr = pcvdom_element_get_attr_c(element,
@@ -504,47 +611,31 @@ pcintr_build_concurrently_call_vdom(pcintr_stack_t stack,
         goto out;
     }
 
-    rws = purc_rwstream_new_buffer(MIN_BUFFER, 0);
-    if (rws == NULL) {
-        PC_WARN("create rwstream failed\n");
-        goto out;
-    }
     as = purc_variant_get_string_const(as_var);
-    foot = (char*)malloc(strlen(callTemplateFoot) + strlen(as) + 1);
-    if (!foot) {
+
+    /* the vDOMs are cached in the caller's vDOM per `define` and `as` */
+    key = (char*)malloc(strlen(as) + sizeof(void *) * 2 + 8);
+    if (!key) {
         purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
         goto out;
     }
+    sprintf(key, "%p/%s", element, as);
 
-    sprintf(foot, callTemplateFoot, as);
-
-    //FIXME: generate DOCTYPE
-    doctype = &stack->vdom->doctype;
-    if (doctype) {
-        char *doc = (char *)malloc(
-                strlen(doctypeTemplate) + strlen(doctype->system_info) + 1);
-        sprintf(doc, doctypeTemplate, doctype->system_info);
-        purc_rwstream_write(rws, doc, strlen(doc));
-        free(doc);
+    vdom = pcvdom_document_find_derived(stack->vdom, key);
+    if (vdom == NULL) {
+        vdom = build_call_vdom(stack->vdom, element, as);
+        if (vdom) {
+            vdom = pcvdom_document_cache_derived(stack->vdom, key, vdom);
+        }
     }
 
-    purc_rwstream_write(rws, callTemplateHead, strlen(callTemplateHead));
-    pcvdom_util_node_serialize(&element->node, serial_element, rws);
-    purc_rwstream_write(rws, foot, strlen(foot));
-
-    nr_hvml = 0;
-    hvml = purc_rwstream_get_mem_buffer(rws, &nr_hvml);
-
-    vdom = purc_load_hvml_from_string(hvml);
     if (!vdom) {
-        PC_WARN("create vdom for call concurrently failed! hvml is %s\n", hvml);
+        PC_WARN("create vdom for call concurrently failed!\n");
     }
+
 out:
-    if (rws) {
-        purc_rwstream_destroy(rws);
-    }
-    if (foot)
-        free(foot);
+    if (key)
+        free(key);
     PURC_VARIANT_SAFE_CLEAR(as_var);
     return vdom;
 }
@@ -124,6 +124,12 @@ PCA_EXTERN_C_BEGIN
 void
 pcintr_destroy_observer_list(struct list_head *observer_list);
 
+void
+pcintr_observer_index_init(struct pcintr_observer_index *index);
+
+void
+pcintr_observer_index_release(struct pcintr_observer_index *index);
+
 struct pcintr_stack_frame_normal *
 pcintr_push_stack_frame_normal(pcintr_stack_t stack);
 
@@ -52,8 +52,6 @@
 #include <stdarg.h>
 #include <libgen.h>
 
-#define EVENT_TIMER_INTRVAL  10
-
 #define EVENT_SEPARATOR      ':'
 
 
@@ -64,6 +62,19 @@
 #define BUFF_MIN            1024
 #define BUFF_MAX            1024 * 1024 * 4
 
+static void
+clear_attrs_result(pcutils_array_t *attrs_result)
+{
+    size_t nr_result = pcutils_array_length(attrs_result);
+    for (size_t i = 0; i < nr_result; i++) {
+        purc_variant_t v = pcutils_array_get(attrs_result, i);
+        if (v) {
+            purc_variant_unref(v);
+        }
+    }
+    pcutils_array_clean(attrs_result);
+}
+
 static void
 stack_frame_release(struct pcintr_stack_frame *frame)
 {
@@ -92,13 +103,7 @@ stack_frame_release(struct pcintr_stack_frame *frame)
     PURC_VARIANT_SAFE_CLEAR(frame->elem_id);
 
     if (frame->attrs_result) {
-        size_t nr_result = pcutils_array_length(frame->attrs_result);
-        for (size_t i = 0; i < nr_result; i++) {
-            purc_variant_t v = pcutils_array_get(frame->attrs_result, i);
-            if (v) {
-                purc_variant_unref(v);
-            }
-        }
+        clear_attrs_result(frame->attrs_result);
         pcutils_array_destroy(frame->attrs_result, true);
         frame->attrs_result = NULL;
     }
@@ -142,6 +147,43 @@ stack_frame_normal_destroy(struct pcintr_stack_frame_normal *frame_normal)
     free(frame_normal);
 }
 
+/* release the content of a popped frame and keep it in the frame pool of
+   the stack; the attribute result array is kept with the frame. */
+static void
+stack_frame_normal_recycle(pcintr_stack_t stack,
+        struct pcintr_stack_frame_normal *frame_normal)
+{
+    if (stack->nr_pooled_frames >= PCINTR_FRAME_POOL_DEPTH) {
+        stack_frame_normal_destroy(frame_normal);
+        return;
+    }
+
+    struct pcintr_stack_frame *frame = &frame_normal->frame;
+    pcutils_array_t *attrs_result = frame->attrs_result;
+    frame->attrs_result = NULL;
+
+    stack_frame_release(frame);
+    if (attrs_result) {
+        clear_attrs_result(attrs_result);
+        frame->attrs_result = attrs_result;
+    }
+
+    list_add(&frame->node, &stack->frame_pool);
+    stack->nr_pooled_frames++;
+}
+
+static void
+destroy_frame_pool(pcintr_stack_t stack)
+{
+    struct pcintr_stack_frame *p, *n;
+    list_for_each_entry_safe(p, n, &stack->frame_pool, node) {
+        list_del(&p->node);
+        stack_frame_normal_destroy(container_of(p,
+                    struct pcintr_stack_frame_normal, frame));
+    }
+    stack->nr_pooled_frames = 0;
+}
+
 static int
 doc_init(pcintr_stack_t stack)
 {
@@ -335,11 +377,24 @@ stack_release(pcintr_stack_t stack)
         destroy_stack_frame(p);
     }
     PC_ASSERT(stack->nr_frames == 0);
+    destroy_frame_pool(stack);
 
     release_scoped_variables(stack);
 
+    if (stack->var_slots) {
+        free(stack->var_slots);
+        stack->var_slots = NULL;
+    }
+
+    if (stack->anchor_index) {
+        pcutils_map_destroy(stack->anchor_index);
+        stack->anchor_index = NULL;
+    }
+
     pcintr_destroy_observer_list(&stack->intr_observers);
     pcintr_destroy_observer_list(&stack->hvml_observers);
+    pcintr_observer_index_release(&stack->intr_observer_index);
+    pcintr_observer_index_release(&stack->hvml_observer_index);
 
     if (stack->doc) {
         purc_document_unref(stack->doc);
@@ -478,6 +533,11 @@ static void
 coroutine_destroy(pcintr_coroutine_t co)
 {
     if (co) {
+        list_del_init(&co->ln_ready);
+        list_del_init(&co->ln_event);
+        list_del_init(&co->ln_idle);
+        list_del_init(&co->ln_vcm_ev);
+        pcutils_twheel_remove(&co->owner->timer_wheel, &co->timeout_node);
         coroutine_release(co);
         free(co);
     }
@@ -487,8 +547,11 @@ static void
 stack_init(pcintr_stack_t stack)
 {
     list_head_init(&stack->frames);
+    list_head_init(&stack->frame_pool);
     list_head_init(&stack->intr_observers);
     list_head_init(&stack->hvml_observers);
+    pcintr_observer_index_init(&stack->intr_observer_index);
+    pcintr_observer_index_init(&stack->hvml_observer_index);
     stack->scoped_variables = RB_ROOT;
 
     stack->mode = STACK_VDOM_BEFORE_HVML;
@@ -518,8 +581,6 @@ static void _cleanup_instance(struct pcinst* inst)
         coroutine_destroy(pco);
     }
 
-    pcutils_sorted_array_destroy(heap->wait_timeout_crtns);
-
     if (heap->move_buff) {
         size_t n = purc_inst_destroy_move_buffer();
         PC_DEBUG("Instance is quiting, %u messages discarded\n", (unsigned)n);
@@ -531,6 +592,12 @@ static void _cleanup_instance(struct pcinst* inst)
         heap->event_timer = NULL;
     }
 
+    if (heap->conn_monitor) {
+        purc_runloop_remove_fd_monitor(inst->running_loop, heap->conn_monitor);
+        heap->conn_monitor = 0;
+        heap->conn_fd = -1;
+    }
+
     if (heap->name_chan_map) {
         pcutils_map_destroy(heap->name_chan_map);
         heap->name_chan_map = NULL;
@@ -541,14 +608,24 @@ static void _cleanup_instance(struct pcinst* inst)
         heap->token_crtn_map = NULL;
     }
 
+    for (int i = 0; i < PCINTR_CTXT_NR_CLASSES; i++) {
+        while (!list_empty(&heap->ctxt_pool[i])) {
+            struct list_head *node = heap->ctxt_pool[i].next;
+            list_del(node);
+            free(node);
+        }
+    }
+
+    struct pcintr_alloc_stat *stat = &heap->alloc_stat;
+    PC_DEBUG("Stack frames allocated/reused: %zu/%zu; "
+            "element contexts allocated/reused: %zu/%zu\n",
+            stat->nr_frames_allocated, stat->nr_frames_reused,
+            stat->nr_ctxts_allocated, stat->nr_ctxts_reused);
+
     free(heap);
     inst->intr_heap = NULL;
 }
 
-
-static void
-event_timer_fire(pcintr_timer_t timer, const char* id, void* data);
-
 static int _init_instance(struct pcinst* inst,
         const purc_instance_extra_info* extra_info)
 {
@@ -562,6 +639,8 @@ static int _init_instance(struct pcinst* inst,
     if (!heap)
         return PURC_ERROR_OUT_OF_MEMORY;
 
+    /* the move buffer wakes up the scheduler via the running loop */
+    inst->running_loop = purc_runloop_get_current();
     heap->move_buff = purc_inst_create_move_buffer(
             PCINST_MOVE_BUFFER_BROADCAST, PCINTR_MOVE_BUFFER_SIZE);
     if (!heap->move_buff) {
@@ -574,16 +653,28 @@ static int _init_instance(struct pcinst* inst,
         return purc_get_last_error();
     }
 
-    inst->running_loop = purc_runloop_get_current();
     inst->intr_heap = heap;
     heap->owner     = inst;
+    heap->conn_fd   = -1;
 
     heap->running_coroutine = NULL;
 
     list_head_init(&heap->crtns);
     list_head_init(&heap->stopped_crtns);
-    heap->wait_timeout_crtns = pcutils_sorted_array_create(
-            SAFLAG_ORDER_ASC | SAFLAG_DUPLCATE_SORTV, 0, NULL, NULL);
+    for (int i = 0; i < PURC_NR_SCHED_CLASSES; i++) {
+        list_head_init(&heap->ready_crtns[i]);
+    }
+    heap->time_slices[PURC_SCHED_CLASS_INTERACTIVE] =
+        PCINTR_TIME_SLICE_INTERACTIVE;
+    heap->time_slices[PURC_SCHED_CLASS_NORMAL] = PCINTR_TIME_SLICE_NORMAL;
+    heap->time_slices[PURC_SCHED_CLASS_BATCH] = PCINTR_TIME_SLICE_BATCH;
+    list_head_init(&heap->event_crtns);
+    list_head_init(&heap->idle_crtns);
+    list_head_init(&heap->vcm_ev_crtns);
+    for (int i = 0; i < PCINTR_CTXT_NR_CLASSES; i++) {
+        list_head_init(&heap->ctxt_pool[i]);
+    }
+    pcutils_twheel_init(&heap->timer_wheel, pcintr_monotonic_time_ms());
 
     heap->name_chan_map =
         pcutils_map_create(NULL, NULL, NULL,
@@ -593,17 +684,6 @@ static int _init_instance(struct pcinst* inst,
         pcutils_map_create(copy_key_string, free_key_string, NULL, NULL,
                 comp_key_string, false);
 
-    heap->event_timer = pcintr_timer_create(NULL, NULL, event_timer_fire, inst);
-    if (!heap->event_timer) {
-        purc_inst_destroy_move_buffer();
-        heap->move_buff = 0;
-        free(heap);
-        return PURC_ERROR_OUT_OF_MEMORY;
-    }
-
-    pcintr_timer_set_interval(heap->event_timer, EVENT_TIMER_INTRVAL);
-    pcintr_timer_start(heap->event_timer);
-
     return 0;
 }
 
@@ -632,6 +712,80 @@ struct pcintr_heap* pcintr_get_heap(void)
     return inst ? inst->intr_heap : NULL;
 }
 
+void *
+pcintr_ctxt_alloc(size_t size)
+{
+    struct pcintr_heap *heap = pcintr_get_heap();
+    size_t cls = (size + PCINTR_CTXT_GRAIN - 1) / PCINTR_CTXT_GRAIN;
+    void *ctxt;
+
+    if (cls == 0 || cls > PCINTR_CTXT_NR_CLASSES) {
+        ctxt = calloc(1, size);
+    }
+    else if (heap && !list_empty(&heap->ctxt_pool[cls - 1])) {
+        struct list_head *node = heap->ctxt_pool[cls - 1].next;
+        list_del(node);
+        heap->nr_pooled_ctxts[cls - 1]--;
+        heap->alloc_stat.nr_ctxts_reused++;
+
+        ctxt = node;
+        memset(ctxt, 0, size);
+        return ctxt;
+    }
+    else {
+        /* allocate the whole size class so that the block can be reused,
+           even if the block is freed when there is a heap but there was
+           none when it was allocated */
+        ctxt = calloc(1, cls * PCINTR_CTXT_GRAIN);
+    }
+
+    if (ctxt && heap) {
+        heap->alloc_stat.nr_ctxts_allocated++;
+    }
+    return ctxt;
+}
+
+void
+pcintr_ctxt_free(void *ctxt, size_t size)
+{
+    if (!ctxt)
+        return;
+
+    struct pcintr_heap *heap = pcintr_get_heap();
+    size_t cls = (size + PCINTR_CTXT_GRAIN - 1) / PCINTR_CTXT_GRAIN;
+
+    if (heap == NULL || cls == 0 || cls > PCINTR_CTXT_NR_CLASSES ||
+            heap->nr_pooled_ctxts[cls - 1] >= PCINTR_CTXT_POOL_DEPTH) {
+        free(ctxt);
+        return;
+    }
+
+    struct list_head *node = (struct list_head *)ctxt;
+    list_add(node, &heap->ctxt_pool[cls - 1]);
+    heap->nr_pooled_ctxts[cls - 1]++;
+}
+
+int
+purc_get_intr_alloc_stat(struct purc_intr_alloc_stat *stat)
+{
+    struct pcintr_heap *heap = pcintr_get_heap();
+    if (!heap || !stat) {
+        purc_set_error(heap ? PURC_ERROR_INVALID_VALUE :
+                PURC_ERROR_NO_INSTANCE);
+        return -1;
+    }
+
+    stat->nr_frames_allocated = heap->alloc_stat.nr_frames_allocated;
+    stat->nr_frames_reused = heap->alloc_stat.nr_frames_reused;
+    stat->nr_ctxts_allocated = heap->alloc_stat.nr_ctxts_allocated;
+    stat->nr_ctxts_reused = heap->alloc_stat.nr_ctxts_reused;
+    stat->nr_pooled_ctxts = 0;
+    for (int i = 0; i < PCINTR_CTXT_NR_CLASSES; i++) {
+        stat->nr_pooled_ctxts += heap->nr_pooled_ctxts[i];
+    }
+    return 0;
+}
+
 pcintr_coroutine_t
 pcintr_get_coroutine(void)
 {
@@ -709,6 +863,7 @@ pop_stack_frame(pcintr_stack_t stack)
 
     struct pcintr_stack_frame *frame;
     frame = container_of(tail, struct pcintr_stack_frame, node);
+    pcintr_unindex_frame_anchor(stack, frame);
 
     struct pcintr_stack_frame_normal *frame_normal = NULL;
     struct pcintr_stack_frame_pseudo *frame_pseudo = NULL;
@@ -717,7 +872,7 @@ pop_stack_frame(pcintr_stack_t stack)
         case STACK_FRAME_TYPE_NORMAL:
             frame_normal = container_of(frame,
                     struct pcintr_stack_frame_normal, frame);
-            stack_frame_normal_destroy(frame_normal);
+            stack_frame_normal_recycle(stack, frame_normal);
             break;
         case STACK_FRAME_TYPE_PSEUDO:
             frame_pseudo = container_of(frame,
@@ -855,10 +1010,13 @@ init_stack_frame(pcintr_stack_t stack, struct pcintr_stack_frame* frame)
         return -1;
     }
 
-    frame->attrs_result = pcutils_array_create();
+    /* a frame reused from the frame pool keeps its (empty) array */
     if (!frame->attrs_result) {
-        purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
-        return -1;
+        frame->attrs_result = pcutils_array_create();
+        if (!frame->attrs_result) {
+            purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
+            return -1;
+        }
     }
     return 0;
 }
@@ -987,16 +1145,33 @@ init_stack_frame_normal(pcintr_stack_t stack,
 static struct pcintr_stack_frame_normal*
 stack_frame_normal_create(pcintr_stack_t stack)
 {
+    struct pcintr_alloc_stat *stat = &stack->co->owner->alloc_stat;
     struct pcintr_stack_frame_normal *frame_normal;
-    frame_normal = (struct pcintr_stack_frame_normal*)calloc(1,
-            sizeof(*frame_normal));
-    if (!frame_normal) {
-        purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
-        return NULL;
+    pcutils_array_t *attrs_result = NULL;
+
+    if (!list_empty(&stack->frame_pool)) {
+        frame_normal = list_first_entry(&stack->frame_pool,
+                struct pcintr_stack_frame_normal, frame.node);
+        list_del(&frame_normal->frame.node);
+        stack->nr_pooled_frames--;
+
+        attrs_result = frame_normal->frame.attrs_result;
+        memset(frame_normal, 0, sizeof(*frame_normal));
+        stat->nr_frames_reused++;
+    }
+    else {
+        frame_normal = (struct pcintr_stack_frame_normal*)calloc(1,
+                sizeof(*frame_normal));
+        if (!frame_normal) {
+            purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
+            return NULL;
+        }
+        stat->nr_frames_allocated++;
     }
 
     struct pcintr_stack_frame *frame = &frame_normal->frame;
     frame->type = STACK_FRAME_TYPE_NORMAL;
+    frame->attrs_result = attrs_result;
 
     if (init_stack_frame_normal(stack, frame_normal))
         goto fail_init;
@@ -1834,6 +2009,15 @@ coroutine_create(purc_vdom_t vdom, pcintr_coroutine_t parent,
         goto fail;
     }
 
+    /* must be ready before changing the state */
+    co->owner = heap;
+    co->sched_class = PURC_SCHED_CLASS_NORMAL;
+    list_head_init(&co->ln_ready);
+    list_head_init(&co->ln_event);
+    list_head_init(&co->ln_idle);
+    list_head_init(&co->ln_vcm_ev);
+    pcutils_twheel_node_init(&co->timeout_node, pcintr_on_coroutine_timeout);
+
     if (set_coroutine_id(co)) {
         goto fail_co;
     }
@@ -1863,7 +2047,6 @@ coroutine_create(purc_vdom_t vdom, pcintr_coroutine_t parent,
 
     stack = &co->stack;
     stack->co = co;
-    co->owner = heap;
     co->user_data = user_data;
     co->loaded_vars = RB_ROOT;
 
@@ -1910,6 +2093,7 @@ fail_variables:
     pcinst_msg_queue_destroy(co->mq);
 
 fail_co:
+    list_del_init(&co->ln_ready);
     free(co);
 
 fail:
@@ -2924,49 +3108,6 @@ struct timer_data {
     char                        *id;
 };
 
-static void
-event_timer_fire(pcintr_timer_t timer, const char* id, void* data)
-{
-    UNUSED_PARAM(timer);
-    UNUSED_PARAM(id);
-    UNUSED_PARAM(data);
-
-    PC_ASSERT(pcintr_get_heap());
-
-    pcintr_coroutine_t co = pcintr_get_coroutine();
-    if (co == NULL) {
-        return;
-    }
-
-    if (co->state != CO_STATE_OBSERVING)
-    {
-        return;
-    }
-
-    pcintr_stack_t stack = &co->stack;
-    if (stack->exited)
-        return;
-
-    struct pcintr_stack_frame *frame;
-    frame = pcintr_stack_get_bottom_frame(stack);
-    PC_ASSERT(frame == NULL);
-
-    struct list_head *observer_list = &stack->hvml_observers;
-    struct pcintr_observer *p, *n;
-    list_for_each_entry_safe(p, n, observer_list, node) {
-        purc_variant_t var = p->observed;
-        struct purc_native_ops *ops = purc_variant_native_get_ops(var);
-        if (ops && ops->property_getter) {
-            void *entity = purc_variant_native_get_entity(var);
-            purc_nvariant_method is_vcm_ev = ops->property_getter(entity,
-                    PCVCM_EV_PROPERTY_VCM_EV);
-            if (is_vcm_ev) {
-                pcintr_observe_vcm_ev(stack, p, var, ops);
-            }
-        }
-    }
-}
-
 static struct purc_native_ops ops_vdom = {};
 
 purc_variant_t
@@ -3368,6 +3509,34 @@ pcintr_coroutine_set_state_with_location(pcintr_coroutine_t co,
     UNUSED_PARAM(line);
     UNUSED_PARAM(func);
     co->state = state;
+
+    /* keep the ready queue of the heap in sync with the state */
+    if (state == CO_STATE_READY) {
+        if (list_empty(&co->ln_ready)) {
+            list_add_tail(&co->ln_ready,
+                    &co->owner->ready_crtns[co->sched_class]);
+            clock_gettime(CLOCK_MONOTONIC, &co->ready_since);
+        }
+    }
+    else if (!list_empty(&co->ln_ready)) {
+        list_del_init(&co->ln_ready);
+    }
+}
+
+void
+pcintr_coroutine_mark_event_pending(pcintr_coroutine_t co)
+{
+    if (list_empty(&co->ln_event)) {
+        list_add_tail(&co->ln_event, &co->owner->event_crtns);
+    }
+}
+
+int
+pcintr_coroutine_append_msg(pcintr_coroutine_t co, pcrdr_msg *msg)
+{
+    int ret = pcinst_msg_queue_append(co->mq, msg);
+    pcintr_coroutine_mark_event_pending(co);
+    return ret;
 }
 
 int
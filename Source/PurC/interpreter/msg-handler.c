@@ -29,6 +29,7 @@
 #include "ops.h"
 #include "private/instance.h"
 #include "private/msg-queue.h"
+#include "private/pcrdr.h"
 #include "private/interpreter.h"
 #include "private/regex.h"
 
@@ -322,7 +323,7 @@ dispatch_coroutine_event_from_move_buffer(struct pcinst *inst,
         list_for_each_entry_safe(p, q, crtns, ln) {
             pcintr_coroutine_t co = p;
             if (co->cid == msg->targetValue) {
-                return pcinst_msg_queue_append(co->mq, msg_clone);
+                return pcintr_coroutine_append_msg(co, msg_clone);
             }
         }
 
@@ -330,7 +331,7 @@ dispatch_coroutine_event_from_move_buffer(struct pcinst *inst,
         list_for_each_entry_safe(p, q, crtns, ln) {
             pcintr_coroutine_t co = p;
             if (co->cid == msg->targetValue) {
-                return pcinst_msg_queue_append(co->mq, msg_clone);
+                return pcintr_coroutine_append_msg(co, msg_clone);
             }
         }
         pcrdr_release_message(msg_clone);
@@ -341,7 +342,7 @@ dispatch_coroutine_event_from_move_buffer(struct pcinst *inst,
             pcintr_coroutine_t co = p;
             pcrdr_msg *my_msg = pcrdr_clone_message(msg_clone);
             my_msg->targetValue = co->cid;
-            pcinst_msg_queue_append(co->mq, my_msg);
+            pcintr_coroutine_append_msg(co, my_msg);
         }
 
         crtns = &heap->stopped_crtns;
@@ -349,7 +350,7 @@ dispatch_coroutine_event_from_move_buffer(struct pcinst *inst,
             pcintr_coroutine_t co = p;
             pcrdr_msg *my_msg = pcrdr_clone_message(msg_clone);
             my_msg->targetValue = co->cid;
-            pcinst_msg_queue_append(co->mq, my_msg);
+            pcintr_coroutine_append_msg(co, my_msg);
         }
         pcrdr_release_message(msg_clone);
     }
@@ -677,6 +678,7 @@ pcintr_post_event(purc_atom_t rid, purc_atom_t cid,
 
     msg->eventName = event_name;
     purc_variant_ref(msg->eventName);
+    pcrdr_msg_resolve_event_type(msg);
 
     if (element_value) {
         msg->elementType = PCRDR_MSG_ELEMENT_TYPE_VARIANT;
@@ -30,10 +30,117 @@
 #include "private/msg-queue.h"
 #include "private/interpreter.h"
 #include "private/regex.h"
+#include "private/vcm.h"
 
 #include <sys/time.h>
 
-#define BUILTIN_VAR_CRTN        PURC_PREDEF_VARNAME_CRTN
+#define VCM_EV_TIMER_INTERVAL   10
+
+static void
+add_idle_observer(pcintr_stack_t stack)
+{
+    pcintr_coroutine_t co = stack->co;
+    if (stack->nr_idle_observers++ == 0) {
+        list_add_tail(&co->ln_idle, &co->owner->idle_crtns);
+    }
+    co->owner->nr_idle_observers++;
+}
+
+static void
+remove_idle_observer(pcintr_stack_t stack)
+{
+    pcintr_coroutine_t co = stack->co;
+    PC_ASSERT(stack->nr_idle_observers > 0);
+    if (--stack->nr_idle_observers == 0) {
+        list_del_init(&co->ln_idle);
+    }
+    co->owner->nr_idle_observers--;
+}
+
+/* re-evaluates the expression variables observed by the coroutines */
+static void
+vcm_ev_timer_fire(pcintr_timer_t timer, const char* id, void* data)
+{
+    UNUSED_PARAM(timer);
+    UNUSED_PARAM(id);
+
+    struct pcintr_heap *heap = (struct pcintr_heap *)data;
+    pcintr_coroutine_t current = heap->running_coroutine;
+    pcintr_coroutine_t co, next;
+    list_for_each_entry_safe(co, next, &heap->vcm_ev_crtns, ln_vcm_ev) {
+        pcintr_stack_t stack = &co->stack;
+        if (co->state != CO_STATE_OBSERVING || stack->exited)
+            continue;
+
+        PC_ASSERT(pcintr_stack_get_bottom_frame(stack) == NULL);
+
+        pcintr_set_current_co(co);
+        struct pcintr_observer *p, *n;
+        list_for_each_entry_safe(p, n, &stack->hvml_observers, node) {
+            if (p->observe_vcm_ev) {
+                pcintr_observe_vcm_ev(stack, p, p->observed,
+                        purc_variant_native_get_ops(p->observed));
+            }
+        }
+        pcintr_set_current_co(current);
+    }
+}
+
+static bool
+is_vcm_ev_observed(purc_variant_t observed)
+{
+    if (!purc_variant_is_native(observed))
+        return false;
+
+    struct purc_native_ops *ops = purc_variant_native_get_ops(observed);
+    if (!ops || !ops->property_getter)
+        return false;
+
+    void *entity = purc_variant_native_get_entity(observed);
+    return ops->property_getter(entity, PCVCM_EV_PROPERTY_VCM_EV) != NULL;
+}
+
+/* the timer re-evaluating the expression variables runs only while
+   there are observers of them */
+static bool
+add_vcm_ev_observer(pcintr_stack_t stack)
+{
+    pcintr_coroutine_t co = stack->co;
+    struct pcintr_heap *heap = co->owner;
+    if (heap->nr_vcm_ev_observers == 0) {
+        PC_ASSERT(heap->event_timer == NULL);
+        heap->event_timer = pcintr_wheel_timer_create(NULL,
+                vcm_ev_timer_fire, heap);
+        if (!heap->event_timer)
+            return false;
+
+        pcintr_timer_set_interval(heap->event_timer, VCM_EV_TIMER_INTERVAL);
+        pcintr_timer_start(heap->event_timer);
+    }
+    heap->nr_vcm_ev_observers++;
+
+    if (stack->nr_vcm_ev_observers++ == 0) {
+        list_add_tail(&co->ln_vcm_ev, &heap->vcm_ev_crtns);
+    }
+    return true;
+}
+
+static void
+remove_vcm_ev_observer(pcintr_stack_t stack)
+{
+    pcintr_coroutine_t co = stack->co;
+    struct pcintr_heap *heap = co->owner;
+    PC_ASSERT(stack->nr_vcm_ev_observers > 0);
+    if (--stack->nr_vcm_ev_observers == 0) {
+        list_del_init(&co->ln_vcm_ev);
+    }
+
+    PC_ASSERT(heap->nr_vcm_ev_observers > 0);
+    if (--heap->nr_vcm_ev_observers == 0) {
+        pcintr_timer_destroy(heap->event_timer);
+        heap->event_timer = NULL;
+    }
+}
 
 static void
 release_observer(struct pcintr_observer *observer)
@@ -42,6 +149,26 @@ release_observer(struct pcintr_observer *observer)
         return;
 
     list_del(&observer->node);
+    list_del(&observer->ln_index);
+    if (observer->bucketed) {
+        struct pcintr_observer_index *index;
+        if (observer->list == &observer->stack->intr_observers)
+            index = &observer->stack->intr_observer_index;
+        else
+            index = &observer->stack->hvml_observer_index;
+        index->nr_bucketed--;
+        observer->bucketed = false;
+    }
+
+    if (observer->observe_idle) {
+        remove_idle_observer(observer->stack);
+        observer->observe_idle = false;
+    }
+
+    if (observer->observe_vcm_ev) {
+        remove_vcm_ev_observer(observer->stack);
+        observer->observe_vcm_ev = false;
+    }
 
     if (observer->on_revoke) {
         observer->on_revoke(observer, observer->on_revoke_data);
@@ -78,6 +205,64 @@ free_observer(struct pcintr_observer *observer)
     free(observer);
 }
 
+void
+pcintr_observer_index_init(struct pcintr_observer_index *index)
+{
+    index->buckets = NULL;
+    index->nr_buckets = 0;
+    index->nr_bucketed = 0;
+    index->dispatching = 0;
+    list_head_init(&index->wildcard);
+}
+
+void
+pcintr_observer_index_release(struct pcintr_observer_index *index)
+{
+    free(index->buckets);
+    index->buckets = NULL;
+    index->nr_buckets = 0;
+    index->nr_bucketed = 0;
+}
+
+/* Doubles the bucket table (or allocates the initial one). Since the
+ * number of buckets is a power of two, all observers in a new bucket come
+ * from the same old bucket, so appending them in turn keeps each bucket
+ * in the order of registration. */
+static int
+observer_index_grow(struct pcintr_observer_index *index)
+{
+    size_t nr_buckets = index->nr_buckets ?
+        index->nr_buckets * 2 : PCINTR_MIN_OBSERVER_BUCKETS;
+    struct list_head *buckets;
+
+    buckets = (struct list_head *)malloc(sizeof(*buckets) * nr_buckets);
+    if (buckets == NULL)
+        return -1;
+
+    for (size_t i = 0; i < nr_buckets; i++) {
+        list_head_init(&buckets[i]);
+    }
+
+    for (size_t i = 0; i < index->nr_buckets; i++) {
+        struct pcintr_observer *p, *n;
+        list_for_each_entry_safe(p, n, &index->buckets[i], ln_index) {
+            list_del(&p->ln_index);
+            list_add_tail(&p->ln_index,
+                    &buckets[p->msg_type_atom & (nr_buckets - 1)]);
+        }
+    }
+
+    free(index->buckets);
+    index->buckets = buckets;
+    index->nr_buckets = nr_buckets;
+    return 0;
+}
+
+static bool
+is_match_default(pcintr_coroutine_t co, struct pcintr_observer *observer,
+        pcrdr_msg *msg, purc_variant_t observed, purc_atom_t type,
+        const char *sub_type);
+
 static void
 add_observer_into_list(pcintr_stack_t stack, struct list_head *list,
         struct pcintr_observer* observer)
@@ -85,6 +270,32 @@ add_observer_into_list(pcintr_stack_t stack, struct list_head *list,
     observer->list = list;
     list_add_tail(&observer->node, list);
 
+    /* only the observers matching the event type exactly can be bucketed */
+    struct pcintr_observer_index *index;
+    if (list == &stack->intr_observers)
+        index = &stack->intr_observer_index;
+    else
+        index = &stack->hvml_observer_index;
+    observer->seq = stack->observer_seq++;
+    if (observer->is_match == is_match_default && !index->dispatching &&
+            index->nr_bucketed >= index->nr_buckets * 2) {
+        /* on failure, keep the current table if any */
+        observer_index_grow(index);
+    }
+
+    if (observer->is_match == is_match_default && index->nr_buckets) {
+        list_add_tail(&observer->ln_index,
+                pcintr_observer_index_bucket(index, observer->msg_type_atom));
+        observer->bucketed = true;
+        index->nr_bucketed++;
+    }
+    else {
+        /* is_match() still checks the type, so the wildcard list is a
+           correct (if slower) place for any observer */
+        list_add_tail(&observer->ln_index, &index->wildcard);
+        observer->bucketed = false;
+    }
+
     // TODO:
     PC_ASSERT(stack);
     PC_ASSERT(stack->co->waits >= 0);
@@ -257,7 +468,16 @@ pcintr_register_observer(pcintr_stack_t  stack,
             MSG_TYPE_IDLE);
     if (pcintr_is_crtn_observed(observed) &&
             msg_type_atom == idle_atom && sub_type == NULL) {
-        stack->observe_idle = 1;
+        observer->observe_idle = true;
+        add_idle_observer(stack);
+    }
+
+    if (source != OBSERVER_SOURCE_INTR && is_vcm_ev_observed(observed)) {
+        if (!add_vcm_ev_observer(stack)) {
+            free_observer(observer);
+            return NULL;
+        }
+        observer->observe_vcm_ev = true;
     }
 
     return observer;
@@ -320,13 +540,6 @@ pcintr_revoke_observer(struct pcintr_observer* observer)
     PC_ASSERT(stack->co->waits >= 1);
     stack->co->waits--;
 
-    // observe idle
-    purc_variant_t hvml = pcintr_get_coroutine_variable(stack->co,
-            BUILTIN_VAR_CRTN);
-    if (observer->observed == hvml) {
-        stack->observe_idle = 0;
-    }
-
     free_observer(observer);
 }
 
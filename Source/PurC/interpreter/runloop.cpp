@@ -100,6 +100,22 @@ void purc_runloop_set_idle_func(purc_runloop_t runloop, purc_runloop_func func,
     }
 }
 
+void purc_runloop_suspend_idle_func(purc_runloop_t runloop, long timeout_ms)
+{
+    if (runloop) {
+        ((RunLoop*)runloop)->suspendIdleCallback(timeout_ms < 0 ?
+                PurCWTF::Seconds::infinity() :
+                PurCWTF::Seconds::fromMilliseconds(timeout_ms));
+    }
+}
+
+void purc_runloop_resume_idle_func(purc_runloop_t runloop)
+{
+    if (runloop) {
+        ((RunLoop*)runloop)->resumeIdleCallback();
+    }
+}
+
 static purc_runloop_io_event
 to_runloop_io_event(GIOCondition condition)
 {
@@ -178,6 +194,21 @@ void purc_runloop_remove_fd_monitor(purc_runloop_t runloop, uintptr_t handle)
     ((RunLoop*)runloop)->removeFdMonitor(handle);
 }
 
+uintptr_t
+pcintr_monitor_fd_for_scheduler(purc_runloop_t runloop, int fd)
+{
+    RunLoop *runLoop = (RunLoop*)runloop;
+
+    return runLoop->addFdMonitor(fd,
+            (GIOCondition)(G_IO_IN | G_IO_ERR | G_IO_HUP),
+            [runLoop] (gint fd, GIOCondition condition) -> gboolean {
+            UNUSED_PARAM(fd);
+            UNUSED_PARAM(condition);
+            runLoop->resumeIdleCallback();
+            return true;
+        });
+}
+
 extern "C" purc_atom_t
 pcrun_create_inst_thread(const char *app_name, const char *runner_name,
         purc_cond_handler cond_handler,
@@ -269,6 +300,8 @@ static void _runloop_init_main(void)
                 return;
             }
 
+            /* the move buffer wakes up the idle callback via the runloop */
+            pcinst_current()->running_loop = (purc_runloop_t)&runloop;
             atom = purc_inst_create_move_buffer(PCINST_MOVE_BUFFER_FLAG_NONE,
                     PCINTR_MOVE_BUFFER_SIZE >> 1);
             if (atom == 0) {
@@ -328,15 +328,9 @@ pcrdr_msg *pcrun_extra_message_source(pcrdr_conn* conn, void *ctxt)
     UNUSED_PARAM(conn);
     UNUSED_PARAM(ctxt);
 
-    size_t n;
-
-    int ret = purc_inst_holding_messages_count(&n);
-    if (ret) {
-        purc_log_error("Failed purc_inst_holding_messages_count(): %s(%d)\n",
-                purc_get_error_message(ret), ret);
-    }
-    else if (n > 0) {
-        return purc_inst_take_away_message(0);
+    pcrdr_msg *msg;
+    if (purc_inst_take_away_messages(&msg, 1) > 0) {
+        return msg;
     }
 
     return NULL;
@@ -618,24 +612,9 @@ static void kill_instance(struct instmgr_info *info,
     }
 }
 
-void pcrun_instmgr_handle_message(void *ctxt)
+static void
+instmgr_handle_message(struct instmgr_info *info, pcrdr_msg *msg)
 {
-    struct instmgr_info *info = ctxt;
-
-    size_t n;
-    int ret = purc_inst_holding_messages_count(&n);
-    if (ret) {
-        purc_log_error("Failed to check messages in move buffer: %d\n", ret);
-        return;
-    }
-    else if (n == 0) {
-        // sleep 1ms to take a breath
-        pcutils_usleep(1000);
-        return;
-    }
-
-    /* there is a new message */
-    pcrdr_msg *msg = purc_inst_take_away_message(0);
     if (msg->type == PCRDR_MSG_TYPE_REQUEST) {
         const char* source_uri;
         purc_atom_t requester;
@@ -749,6 +728,32 @@ void pcrun_instmgr_handle_message(void *ctxt)
     pcrdr_release_message(msg);
 }
 
+#define NR_INSTMGR_BATCH_MSGS   16
+
+void pcrun_instmgr_handle_message(void *ctxt)
+{
+    struct instmgr_info *info = ctxt;
+
+    size_t n;
+    int ret = purc_inst_holding_messages_count(&n);
+    if (ret) {
+        purc_log_error("Failed to check messages in move buffer: %d\n", ret);
+        return;
+    }
+    else if (n == 0) {
+        // sleep until a new message is moved to the buffer
+        purc_runloop_suspend_idle_func(purc_runloop_get_current(), -1);
+        return;
+    }
+
+    /* there are new messages; handle them in batch */
+    pcrdr_msg *msgs[NR_INSTMGR_BATCH_MSGS];
+    n = purc_inst_take_away_messages(msgs, NR_INSTMGR_BATCH_MSGS);
+    for (size_t i = 0; i < n; i++) {
+        instmgr_handle_message(info, msgs[i]);
+    }
+}
+
 
 purc_atom_t
 purc_inst_create_or_get(const char *app_name, const char *runner_name,
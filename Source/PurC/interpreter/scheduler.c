@@ -35,15 +35,16 @@
 #include "private/variant.h"
 #include "private/ports.h"
 #include "private/msg-queue.h"
+#include "private/pcrdr.h"
 
 #include <stdlib.h>
 #include <string.h>
 
 #include <sys/time.h>
 
-#define SCHEDULE_SLEEP          10 * 1000       // usec
 #define IDLE_EVENT_TIMEOUT      100             // ms
 #define TIME_SLIECE             0.005           // s
+#define NR_CONN_MSGS_PER_PASS   64              // max renderer msgs per pass
 
 #define BUILTIN_VAR_CRTN        PURC_PREDEF_VARNAME_CRTN
 
@@ -56,45 +57,30 @@ timespec_to_ms(const struct timespec *ts)
     return ts->tv_sec * 1000 + ts->tv_nsec * 1.0E-6;
 }
 
-static time_t
-pcintr_monotonic_time_ms()
+time_t
+pcintr_monotonic_time_ms(void)
 {
     struct timespec ts;
     clock_gettime(CLOCK_MONOTONIC, &ts);
     return timespec_to_ms(&ts);
 }
 
+/* posts an idle event to the coroutines observing it only */
 static void
 broadcast_idle_event(struct pcinst *inst)
 {
     struct pcintr_heap *heap = inst->intr_heap;
-    struct list_head *crtns = &heap->crtns;
-    pcintr_coroutine_t p, q;
-    list_for_each_entry_safe(p, q, crtns, ln) {
-        pcintr_coroutine_t co = p;
-        pcintr_stack_t stack = &co->stack;
-        if (stack->observe_idle) {
-            purc_variant_t hvml = pcintr_crtn_observed_create(co->cid);
-            pcintr_coroutine_post_event(stack->co->cid,
-                    PCRDR_MSG_EVENT_REDUCE_OPT_OVERLAY,
-                    hvml, MSG_TYPE_IDLE, NULL,
-                    PURC_VARIANT_INVALID, PURC_VARIANT_INVALID);
-            purc_variant_unref(hvml);
-        }
-    }
+    if (heap->nr_idle_observers == 0)
+        return;
 
-    crtns = &heap->stopped_crtns;
-    list_for_each_entry_safe(p, q, crtns, ln) {
-        pcintr_coroutine_t co = p;
-        pcintr_stack_t stack = &co->stack;
-        if (stack->observe_idle) {
-            purc_variant_t hvml = pcintr_crtn_observed_create(co->cid);
-            pcintr_coroutine_post_event(stack->co->cid,
-                    PCRDR_MSG_EVENT_REDUCE_OPT_OVERLAY,
-                    hvml, MSG_TYPE_IDLE, NULL,
-                    PURC_VARIANT_INVALID, PURC_VARIANT_INVALID);
-            purc_variant_unref(hvml);
-        }
+    pcintr_coroutine_t p, q;
+    list_for_each_entry_safe(p, q, &heap->idle_crtns, ln_idle) {
+        purc_variant_t hvml = pcintr_crtn_observed_create(p->cid);
+        pcintr_coroutine_post_event(p->cid,
+                PCRDR_MSG_EVENT_REDUCE_OPT_OVERLAY,
+                hvml, MSG_TYPE_IDLE, NULL,
+                PURC_VARIANT_INVALID, PURC_VARIANT_INVALID);
+        purc_variant_unref(hvml);
     }
 }
 
@@ -139,12 +125,42 @@ handle_rdr_conn_lost(struct pcinst *inst)
                 PURC_VARIANT_INVALID, PURC_VARIANT_INVALID);
     }
 
+    if (heap->conn_monitor) {
+        purc_runloop_remove_fd_monitor(inst->running_loop, heap->conn_monitor);
+        heap->conn_monitor = 0;
+        heap->conn_fd = -1;
+    }
+
     // FIXME:
     // pcrdr_disconnect(inst->conn_to_rdr);
     pcrdr_free_connection(inst->conn_to_rdr);
     inst->conn_to_rdr = NULL;
 }
 
+/* monitor the socket of the renderer connection (if any) to wake up
+   the suspended scheduler when there is an incoming message. */
+static void
+update_conn_monitor(struct pcinst *inst, struct pcrdr_conn *conn)
+{
+    struct pcintr_heap *heap = inst->intr_heap;
+    int fd = conn ? pcrdr_conn_fd(conn) : -1;
+
+    if (fd == heap->conn_fd) {
+        return;
+    }
+
+    if (heap->conn_monitor) {
+        purc_runloop_remove_fd_monitor(inst->running_loop, heap->conn_monitor);
+        heap->conn_monitor = 0;
+    }
+
+    heap->conn_fd = fd;
+    if (fd >= 0 && inst->running_loop) {
+        heap->conn_monitor = pcintr_monitor_fd_for_scheduler(
+                inst->running_loop, fd);
+    }
+}
+
 bool
 is_match_except(purc_variant_t for_var, purc_atom_t except)
 {
@@ -493,6 +509,36 @@ execute_one_step_for_ready_co(struct pcinst *inst, pcintr_coroutine_t co)
     pcintr_set_current_co(NULL);
 }
 
+/* pick the ready coroutine having the highest priority; the priority of
+   a coroutine rises with the time it has been waiting for */
+static pcintr_coroutine_t
+pick_ready_co(struct list_head *ready)
+{
+    pcintr_coroutine_t picked = NULL;
+    double best = 0;
+
+    for (int c = 0; c < PURC_NR_SCHED_CLASSES; c++) {
+        if (list_empty(&ready[c])) {
+            continue;
+        }
+
+        /* the coroutines of a class are queued in the order of readiness */
+        pcintr_coroutine_t co;
+        co = list_first_entry(&ready[c], struct pcintr_coroutine, ln_ready);
+        double prio = c - purc_get_elapsed_seconds(&co->ready_since, NULL) /
+            PCINTR_SCHED_AGING_PERIOD;
+        if (picked == NULL || prio < best) {
+            picked = co;
+            best = prio;
+        }
+    }
+
+    if (picked) {
+        list_del_init(&picked->ln_ready);
+    }
+    return picked;
+}
+
 // execute one step for all ready coroutines of the inst
 // return whether busy
 static bool
@@ -501,69 +547,55 @@ execute_one_step(struct pcinst *inst)
     bool busy = false;
     struct pcintr_heap *heap = inst->intr_heap;
 
-    pcintr_coroutine_t p, q;
     pcintr_coroutine_t co;
-    struct list_head *crtns;
-
-    time_t now = pcintr_monotonic_time_ms();
-
-    pcutils_array_t *cos = pcutils_array_create();
-    if (!cos) {
-        purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
-        return false;
-    }
 
-    size_t nr = pcutils_sorted_array_count(heap->wait_timeout_crtns);
-    for (size_t i = 0; i < nr; i++) {
-        pcutils_sorted_array_get(heap->wait_timeout_crtns, i, (void **)&co);
-        if (now < co->stopped_timeout) {
-            break;
-        }
-        co->stack.timeout = true;
-        pcutils_array_push(cos, co);
-    }
+    /* fire the expired timers and wait timeouts in one batch */
+    pcutils_twheel_expire(&heap->timer_wheel, pcintr_monotonic_time_ms());
 
-    nr = pcutils_array_length(cos);
-    for (size_t i = 0; i < nr; i++) {
-        co = pcutils_array_get(cos, i);
-        pcintr_resume_coroutine(co);
+    /* only the coroutines in the ready queues are visited; the coroutines
+       becoming ready again while running are queued for the next pass */
+    struct list_head ready[PURC_NR_SCHED_CLASSES];
+    for (int c = 0; c < PURC_NR_SCHED_CLASSES; c++) {
+        list_head_init(&ready[c]);
+        list_splice_init(&heap->ready_crtns[c], &ready[c]);
     }
-    pcutils_array_destroy(cos, true);
 
-
-    crtns = &heap->crtns;
-    list_for_each_entry_safe(p, q, crtns, ln) {
-        pcintr_coroutine_t co = p;
+    while ((co = pick_ready_co(ready))) {
         if (co->state != CO_STATE_READY) {
             continue;
         }
 
-#if 1
+        struct purc_coroutine_sched_stat *stat = &co->sched_stat;
         struct timespec begin;
         clock_gettime(CLOCK_MONOTONIC, &begin);
+
+        double waited = purc_get_elapsed_seconds(&co->ready_since, &begin);
+        stat->ready_time += waited;
+        if (waited > stat->max_ready_time) {
+            stat->max_ready_time = waited;
+        }
+        stat->nr_slices++;
+
+        double slice = heap->time_slices[co->sched_class];
         struct pcintr_stack_frame *frame;
+        double diff = 0;
         while (co->state == CO_STATE_READY) {
             frame = pcintr_stack_get_bottom_frame(&co->stack);
             bool must_yield = frame ? frame->must_yield : false;
             execute_one_step_for_ready_co(inst, co);
-            if (must_yield) {
-                break;
-            }
-            double diff = purc_get_elapsed_seconds(&begin, NULL);
-            if (diff > TIME_SLIECE) {
+            diff = purc_get_elapsed_seconds(&begin, NULL);
+            if (must_yield || diff > slice) {
                 break;
             }
         }
-#else
-            execute_one_step_for_ready_co(inst, co);
-#endif
+
+        stat->run_time += diff;
         busy = true;
     }
 
     return busy;
 }
 
-
 void
 check_and_dispatch_event_from_conn(struct pcinst *inst)
 {
@@ -575,10 +607,12 @@ check_and_dispatch_event_from_conn(struct pcinst *inst)
             pcrdr_conn_set_event_handler(conn, pcintr_conn_event_handler);
         }
 
+        update_conn_monitor(inst, conn);
+
         int last_err = purc_get_last_error();
         purc_clr_error();
 
-        pcrdr_wait_and_dispatch_message(conn, 0);
+        pcrdr_drain_and_dispatch_messages(conn, NR_CONN_MSGS_PER_PASS);
 
         int err = purc_get_last_error();
         if (err == PCRDR_ERROR_IO || err == PCRDR_ERROR_PEER_CLOSED) {
@@ -589,14 +623,35 @@ check_and_dispatch_event_from_conn(struct pcinst *inst)
 }
 
 static int
-handle_event_by_observer_list(purc_coroutine_t co, struct list_head *list,
-        pcrdr_msg *msg, purc_atom_t event_type,
-        const char *event_sub_type, bool *event_observed, bool *busy)
+handle_event_by_observer_index(purc_coroutine_t co,
+        struct pcintr_observer_index *index, pcrdr_msg *msg,
+        purc_atom_t event_type, const char *event_sub_type,
+        bool *event_observed, bool *busy)
 {
     int ret = PURC_ERROR_INCOMPLETED;
     purc_variant_t observed = msg->elementValue;
-    struct pcintr_observer *observer, *next;
-    list_for_each_entry_safe(observer, next, list, node) {
+    struct list_head *bucket = pcintr_observer_index_bucket(index, event_type);
+    struct list_head *wildcard = &index->wildcard;
+    struct list_head *b = bucket ? bucket->next : NULL;
+    struct list_head *w = wildcard->next;
+
+    /* merge the bucket of the event type and the wildcard observers
+       in the order of registration; the handlers may register observers,
+       so keep the bucket table in place meanwhile */
+    index->dispatching++;
+    while (b != bucket || w != wildcard) {
+        struct pcintr_observer *observer;
+        if (b == bucket || (w != wildcard &&
+                    list_entry(w, struct pcintr_observer, ln_index)->seq <
+                    list_entry(b, struct pcintr_observer, ln_index)->seq)) {
+            observer = list_entry(w, struct pcintr_observer, ln_index);
+            w = w->next;
+        }
+        else {
+            observer = list_entry(b, struct pcintr_observer, ln_index);
+            b = b->next;
+        }
+
         bool match = observer->is_match(co, observer, msg, observed, event_type,
                 event_sub_type);
         if ((co->stage & observer->cor_stage) &&
@@ -612,6 +667,7 @@ handle_event_by_observer_list(purc_coroutine_t co, struct list_head *list,
             *event_observed = true;
         }
     }
+    index->dispatching--;
     return ret;
 }
 
@@ -620,7 +676,6 @@ handle_coroutine_event(pcintr_coroutine_t co)
 {
     bool busy = false;
     bool msg_observed = false;
-    char *type = NULL;
     purc_atom_t event_type = 0;
     const char *event_sub_type = NULL;
 
@@ -631,38 +686,34 @@ handle_coroutine_event(pcintr_coroutine_t co)
     pcrdr_msg *msg = pcinst_msg_queue_get_msg(co->mq);
 
     if (msg && msg->eventName) {
-        const char *event = purc_variant_get_string_const(msg->eventName);
-        const char *separator = strchr(event, MSG_EVENT_SEPARATOR);
-        if (separator) {
-            event_sub_type = separator + 1;
+        /* the event name may be set without resolving the type */
+        event_type = msg->eventTypeAtom;
+        if (event_type == 0) {
+            event_type = pcrdr_msg_resolve_event_type(msg);
         }
 
-        size_t nr_type = separator - event;
-        if (nr_type) {
-            type = strndup(event, separator - event);
-            if (!type) {
-                purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
-                goto out;
-            }
+        const char *event = purc_variant_get_string_const(msg->eventName);
+        if (msg->eventSubTypeOffset) {
+            event_sub_type = event + msg->eventSubTypeOffset;
+        }
 
-            event_type = purc_atom_try_string_ex(ATOM_BUCKET_MSG, type);
-            if (!event_type) {
-                purc_set_error(PURC_ERROR_INVALID_VALUE);
-                PC_WARN("unknown event '%s'\n", event);
-                goto out;
-            }
+        if (!event_type) {
+            purc_set_error(PURC_ERROR_INVALID_VALUE);
+            PC_WARN("unknown event '%s'\n", event);
+            pcrdr_release_message(msg);
+            goto out;
         }
     }
 
     // observer
     if (msg) {
-        int handle_by_inner = handle_event_by_observer_list(co,
-                &co->stack.intr_observers, msg, event_type, event_sub_type,
-                &msg_observed, &busy);
+        int handle_by_inner = handle_event_by_observer_index(co,
+                &co->stack.intr_observer_index, msg, event_type,
+                event_sub_type, &msg_observed, &busy);
 
-        int handle_by_hvml = handle_event_by_observer_list(co,
-                    &co->stack.hvml_observers, msg, event_type, event_sub_type,
-                    &msg_observed, &busy);
+        int handle_by_hvml = handle_event_by_observer_index(co,
+                &co->stack.hvml_observer_index, msg, event_type,
+                event_sub_type, &msg_observed, &busy);
 
         if (handle_by_inner == 0 || handle_by_hvml == 0) {
             pcrdr_release_message(msg);
@@ -685,16 +736,13 @@ handle_coroutine_event(pcintr_coroutine_t co)
     }
 
     if (msg_observed) {
-        pcinst_msg_queue_append(co->mq, msg);
+        pcintr_coroutine_append_msg(co, msg);
     }
     else {
         pcrdr_release_message(msg);
     }
 
 out:
-    if (type) {
-        free(type);
-    }
     return busy;
 }
 
@@ -715,32 +763,28 @@ again:
 
     bool co_is_busy = false;
     struct pcintr_heap *heap = inst->intr_heap;
-    struct list_head *crtns = &heap->crtns;
-    pcintr_coroutine_t p, q;
-    list_for_each_entry_safe(p, q, crtns, ln) {
-        pcintr_coroutine_t co = p;
-        co_is_busy = handle_coroutine_event(co);
 
-        if (co->stack.exited && co->stack.last_msg_read) {
-            pcintr_run_exiting_co(co);
-        }
+    /* only the coroutines having pending messages or tasks are visited */
+    LIST_HEAD(pending);
+    list_splice_init(&heap->event_crtns, &pending);
+    while (!list_empty(&pending)) {
+        pcintr_coroutine_t co;
+        co = list_first_entry(&pending, struct pcintr_coroutine, ln_event);
+        list_del_init(&co->ln_event);
 
+        co_is_busy = handle_coroutine_event(co);
         if (co_is_busy) {
             is_busy = true;
         }
-    }
-
-    crtns = &heap->stopped_crtns;
-    list_for_each_entry_safe(p, q, crtns, ln) {
-        pcintr_coroutine_t co = p;
-        co_is_busy = handle_coroutine_event(co);
 
         if (co->stack.exited && co->stack.last_msg_read) {
+            /* unlinked by coroutine_destroy() if the coroutine exits */
+            pcintr_coroutine_mark_event_pending(co);
             pcintr_run_exiting_co(co);
         }
-
-        if (co_is_busy) {
-            is_busy = true;
+        else if (!list_empty(&co->tasks) ||
+                pcinst_msg_queue_count(co->mq) > 0) {
+            pcintr_coroutine_mark_event_pending(co);
         }
     }
 
@@ -753,6 +797,104 @@ again:
     return is_busy;
 }
 
+/* returns the time in ms the scheduler can sleep for; -1 for no timeout. */
+static long
+get_schedule_timeout(struct pcinst *inst)
+{
+    struct pcintr_heap *heap = inst->intr_heap;
+    long timeout = -1;
+
+    /* messages left in the move buffer are fetched one per pass */
+    size_t nr = 0;
+    if (purc_inst_holding_messages_count(&nr) == 0 && nr > 0) {
+        return 0;
+    }
+
+    /* the frames left in the read-ahead buffer of the renderer connection
+       when the last pass ran out of its budget do not wake up the loop */
+    struct pcrdr_conn *conn = purc_get_conn_to_renderer();
+    if (conn && pcrdr_conn_has_buffered_input(conn)) {
+        return 0;
+    }
+
+    int64_t expiry = pcutils_twheel_next_expiry(&heap->timer_wheel);
+    if (expiry >= 0) {
+        time_t now = pcintr_monotonic_time_ms();
+        timeout = (expiry > now) ? expiry - now : 0;
+    }
+
+    if (heap->nr_idle_observers > 0) {
+        double left = heap->timestamp + IDLE_EVENT_TIMEOUT -
+            pcintr_get_current_time();
+        long idle_timeout = (left > 0) ? (long)left + 1 : 0;
+        if (timeout < 0 || idle_timeout < timeout) {
+            timeout = idle_timeout;
+        }
+    }
+
+    return timeout;
+}
+
+int
+purc_coroutine_set_sched_class(purc_coroutine_t cor,
+        purc_sched_class_k sched_class)
+{
+    if (sched_class < 0 || sched_class >= PURC_NR_SCHED_CLASSES) {
+        purc_set_error(PURC_ERROR_INVALID_VALUE);
+        return -1;
+    }
+
+    if (cor->sched_class != sched_class) {
+        cor->sched_class = sched_class;
+        /* requeue with the new class; the waiting time is kept */
+        if (!list_empty(&cor->ln_ready)) {
+            list_del(&cor->ln_ready);
+            list_add_tail(&cor->ln_ready,
+                    &cor->owner->ready_crtns[sched_class]);
+        }
+    }
+
+    return 0;
+}
+
+purc_sched_class_k
+purc_coroutine_get_sched_class(purc_coroutine_t cor)
+{
+    return cor->sched_class;
+}
+
+int
+purc_set_sched_time_slice(purc_sched_class_k sched_class, double seconds)
+{
+    struct pcintr_heap *heap = pcintr_get_heap();
+    if (heap == NULL) {
+        purc_set_error(PURC_ERROR_NO_INSTANCE);
+        return -1;
+    }
+
+    if (sched_class < 0 || sched_class >= PURC_NR_SCHED_CLASSES ||
+            !(seconds > 0)) {
+        purc_set_error(PURC_ERROR_INVALID_VALUE);
+        return -1;
+    }
+
+    heap->time_slices[sched_class] = seconds;
+    return 0;
+}
+
+int
+purc_coroutine_get_sched_stat(purc_coroutine_t cor,
+        struct purc_coroutine_sched_stat *stat)
+{
+    if (!cor || !stat) {
+        purc_set_error(PURC_ERROR_INVALID_VALUE);
+        return -1;
+    }
+
+    *stat = cor->sched_stat;
+    return 0;
+}
+
 void
 pcintr_schedule(void *ctxt)
 {
@@ -760,12 +902,12 @@ pcintr_schedule(void *ctxt)
     bool event_is_busy;
     struct pcinst *inst = (struct pcinst *)ctxt;
     if (!inst) {
-        goto out_sleep;
+        return;
     }
 
     struct pcintr_heap *heap = inst->intr_heap;
     if (!heap) {
-        goto out_sleep;
+        return;
     }
 
 again:
@@ -790,10 +932,12 @@ again:
         pcintr_update_timestamp(inst);
     }
 
-out_sleep:
-    pcutils_usleep(SCHEDULE_SLEEP);
-
-    return;
+    // 6. sleep until a new message arrives, the renderer connection
+    // becomes readable, a timer fires, or the next timeout expires.
+    long timeout = get_schedule_timeout(inst);
+    if (timeout != 0) {
+        purc_runloop_suspend_idle_func(inst->running_loop, timeout);
+    }
 }
 
 int pcintr_yield(
@@ -1011,10 +1155,8 @@ void pcintr_stop_coroutine(pcintr_coroutine_t crtn,
         crtn->stopped_timeout = -1;
     }
     if (crtn->stopped_timeout != -1) {
-        if (pcutils_sorted_array_add(heap->wait_timeout_crtns,
-                    (void *)(uintptr_t)crtn->stopped_timeout, crtn, NULL) < 0) {
-            purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
-        }
+        pcutils_twheel_add(&heap->timer_wheel, &crtn->timeout_node,
+                crtn->stopped_timeout);
     }
 
 }
@@ -1028,18 +1170,16 @@ void pcintr_resume_coroutine(pcintr_coroutine_t crtn)
     pcintr_heap_t heap = crtn->owner;
     list_add_tail(&crtn->ln, &heap->crtns);
 
-    if (crtn->stopped_timeout != -1) {
-        size_t nr = pcutils_sorted_array_count(heap->wait_timeout_crtns);
-        for (size_t i = 0; i < nr; i++) {
-            pcintr_coroutine_t co;
-            pcutils_sorted_array_get(heap->wait_timeout_crtns, i, (void **)&co);
-            if (co == crtn) {
-                pcutils_sorted_array_delete(heap->wait_timeout_crtns, i);
-                break;
-            }
-        }
-    }
-
+    pcutils_twheel_remove(&heap->timer_wheel, &crtn->timeout_node);
     crtn->stopped_timeout = -1;
 }
 
+/* called by the timer wheel when the wait of the coroutine times out */
+void pcintr_on_coroutine_timeout(struct pcutils_twheel_node *node)
+{
+    pcintr_coroutine_t crtn;
+    crtn = container_of(node, struct pcintr_coroutine, timeout_node);
+    crtn->stack.timeout = true;
+    pcintr_resume_coroutine(crtn);
+}
+
@@ -29,6 +29,7 @@
 #include "internal.h"
 
 #include "private/errors.h"
+#include "private/list.h"
 #include "private/timer.h"
 #include "private/interpreter.h"
 #include "purc-runloop.h"
@@ -39,21 +40,19 @@
 #include <stdlib.h>
 #include <string.h>
 
-class Timer : public PurCWTF::RunLoop::TimerBase {
+class Timer {
     public:
-        Timer(const char *id, pcintr_timer_fire_func func, RunLoop& runLoop,
-                void *data)
-            : TimerBase(runLoop)
-            , m_id(NULL)
+        Timer(const char *id, pcintr_timer_fire_func func, void *data)
+            : m_id(NULL)
             , m_func(func)
             , m_data(data)
+            , m_interval(0)
         {
             m_id = id ? strdup(id) : NULL;
         }
 
-        ~Timer()
+        virtual ~Timer()
         {
-            stop();
             if (m_id) {
                 free(m_id);
             }
@@ -64,13 +63,16 @@ class Timer : public PurCWTF::RunLoop::TimerBase {
         const char *getId() { return m_id; }
         void *getData() { return m_data; }
 
-        virtual void fired()
+        virtual void startTimer(bool repeat) = 0;
+        virtual void stopTimer() = 0;
+        virtual bool isTimerActive() = 0;
+
+    protected:
+        void fire()
         {
             m_func(this, m_id, m_data);
         }
 
-        virtual void processed(void) {}
-
     private:
         char *m_id;
         pcintr_timer_fire_func m_func;
@@ -78,12 +80,129 @@ class Timer : public PurCWTF::RunLoop::TimerBase {
         uint32_t m_interval;
 };
 
+/* the timer driven by a RunLoop */
+class RunLoopTimer : public Timer, public PurCWTF::RunLoop::TimerBase {
+    public:
+        RunLoopTimer(const char *id, pcintr_timer_fire_func func,
+                RunLoop& runLoop, void *data)
+            : Timer(id, func, data)
+            , TimerBase(runLoop)
+        {
+        }
+
+        ~RunLoopTimer()
+        {
+            stop();
+        }
+
+        virtual void startTimer(bool repeat)
+        {
+            if (repeat) {
+                startRepeating(
+                        PurCWTF::Seconds::fromMilliseconds(getInterval()));
+            }
+            else {
+                startOneShot(
+                        PurCWTF::Seconds::fromMilliseconds(getInterval()));
+            }
+        }
+
+        virtual void stopTimer() { stop(); }
+        virtual bool isTimerActive() { return isActive(); }
+
+        virtual void fired() { fire(); }
+};
+
+class WheelTimer;
+
+struct wheel_timer_node {
+    struct pcutils_twheel_node  node;
+    WheelTimer                 *timer;
+};
+
+/* the timer driven by the timer wheel of the interpreter heap;
+   fired by the scheduler in one batch with other expired timers. */
+class WheelTimer : public Timer {
+    public:
+        WheelTimer(const char *id, pcintr_timer_fire_func func,
+                struct pcutils_twheel *wheel, void *data)
+            : Timer(id, func, data)
+            , m_wheel(wheel)
+            , m_repeat(false)
+        {
+            pcutils_twheel_node_init(&m_node.node, onExpired);
+            m_node.timer = this;
+        }
+
+        ~WheelTimer()
+        {
+            stopTimer();
+        }
+
+        virtual void startTimer(bool repeat)
+        {
+            m_repeat = repeat;
+            pcutils_twheel_add(m_wheel, &m_node.node,
+                    pcintr_monotonic_time_ms() + getInterval());
+        }
+
+        virtual void stopTimer()
+        {
+            pcutils_twheel_remove(m_wheel, &m_node.node);
+        }
+
+        virtual bool isTimerActive()
+        {
+            return pcutils_twheel_node_is_pending(&m_node.node);
+        }
+
+    private:
+        static void onExpired(struct pcutils_twheel_node *node)
+        {
+            WheelTimer *timer = container_of(node,
+                    struct wheel_timer_node, node)->timer;
+            if (timer->m_repeat) {
+                /* keep the period without drifting */
+                uint64_t expires = node->expires + timer->getInterval();
+                uint64_t now = pcintr_monotonic_time_ms();
+                if (expires <= now) {
+                    expires = now + timer->getInterval();
+                }
+                pcutils_twheel_add(timer->m_wheel, node, expires);
+            }
+
+            /* the timer may be destroyed by the callback */
+            timer->fire();
+        }
+
+        struct pcutils_twheel      *m_wheel;
+        struct wheel_timer_node     m_node;
+        bool                        m_repeat;
+};
+
 pcintr_timer_t
 pcintr_timer_create(purc_runloop_t runloop, const char* id,
         pcintr_timer_fire_func func, void *data)
 {
     RunLoop* loop = runloop ? (RunLoop*)runloop : &RunLoop::current();
-    Timer* timer = new Timer(id, func, *loop, data);
+    Timer* timer = new RunLoopTimer(id, func, *loop, data);
+    if (!timer) {
+        purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+    return timer;
+}
+
+pcintr_timer_t
+pcintr_wheel_timer_create(const char* id,
+        pcintr_timer_fire_func func, void *data)
+{
+    struct pcintr_heap *heap = pcintr_get_heap();
+    if (!heap) {
+        return pcintr_timer_create(NULL, id, func, data);
+    }
+
+    Timer* timer = new WheelTimer(id, func, &heap->timer_wheel, data);
     if (!timer) {
         purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
         return NULL;
@@ -112,9 +231,7 @@ void
 pcintr_timer_start(pcintr_timer_t timer)
 {
     if (timer) {
-        Timer* tm = (Timer*)timer;
-        tm->startRepeating(
-                PurCWTF::Seconds::fromMilliseconds(tm->getInterval()));
+        ((Timer*)timer)->startTimer(true);
     }
 }
 
@@ -122,9 +239,7 @@ void
 pcintr_timer_start_oneshot(pcintr_timer_t timer)
 {
     if (timer) {
-        Timer* tm = (Timer*)timer;
-        tm->startOneShot(
-                PurCWTF::Seconds::fromMilliseconds(tm->getInterval()));
+        ((Timer*)timer)->startTimer(false);
     }
 }
 
@@ -132,14 +247,14 @@ void
 pcintr_timer_stop(pcintr_timer_t timer)
 {
     if (timer) {
-        ((Timer*)timer)->stop();
+        ((Timer*)timer)->stopTimer();
     }
 }
 
 bool
 pcintr_timer_is_active(pcintr_timer_t timer)
 {
-    return timer ? ((Timer*)timer)->isActive() : false;
+    return timer ? ((Timer*)timer)->isTimerActive() : false;
 }
 
 void
@@ -281,7 +396,7 @@ get_inner_timer(purc_coroutine_t cor , purc_variant_t timer_var)
         return timer;
     }
 
-    timer = pcintr_timer_create(NULL, idstr, timer_fire_func, cor);
+    timer = pcintr_wheel_timer_create(idstr, timer_fire_func, cor);
     if (timer == NULL) {
         return NULL;
     }
@@ -33,6 +33,7 @@
 #include "private/instance.h"
 #include "private/utils.h"
 #include "private/variant.h"
+#include "private/tls.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -49,6 +50,21 @@
 #define KEY_NAME                "name"
 #define KEY_MGR                 "mgr"
 
+PURC_DEFINE_THREAD_LOCAL(unsigned long, binding_epoch);
+
+static inline void
+bump_binding_epoch(pcvarmgr_t mgr)
+{
+    if (!mgr->transient) {
+        (*PURC_GET_THREAD_LOCAL(binding_epoch))++;
+    }
+}
+
+unsigned long pcvarmgr_binding_epoch(void)
+{
+    return *PURC_GET_THREAD_LOCAL(binding_epoch);
+}
+
 enum var_event_type {
     VAR_EVENT_TYPE_ATTACHED,
     VAR_EVENT_TYPE_DETACHED,
@@ -198,9 +214,11 @@ static bool mgr_handler(purc_variant_t source, pcvar_op_t msg_type,
 {
     switch (msg_type) {
     case PCVAR_OPERATION_GROW:
+        bump_binding_epoch((pcvarmgr_t)ctxt);
         return mgr_grow_handler(source, msg_type, ctxt, nr_args, argv);
 
     case PCVAR_OPERATION_SHRINK:
+        bump_binding_epoch((pcvarmgr_t)ctxt);
         return mgr_shrink_handler(source, msg_type, ctxt, nr_args, argv);
 
     case PCVAR_OPERATION_CHANGE:
@@ -263,6 +281,7 @@ int pcvarmgr_destroy(pcvarmgr_t mgr)
 {
     if (mgr) {
         PC_ASSERT(mgr->node.rb_parent == NULL);
+        bump_binding_epoch(mgr);
         if (mgr->listener) {
             purc_variant_revoke_listener(mgr->object, mgr->listener);
         }
@@ -549,6 +568,183 @@ pcintr_find_named_var(pcintr_stack_t stack, const char* name)
     return PURC_VARIANT_INVALID;
 }
 
+/* the elements visited when looking for a scope variable from a frame;
+   see _find_named_scope_var() */
+struct scope_walk {
+    struct pcintr_stack_frame *frame;
+};
+
+static pcvdom_element_t
+scope_walk_first(struct scope_walk *walk, struct pcintr_stack_frame *frame)
+{
+    if (frame->scope) {
+        walk->frame = NULL;
+        return frame->scope;
+    }
+
+    walk->frame = frame;
+    return frame->pos;
+}
+
+static pcvdom_element_t
+scope_walk_next(struct scope_walk *walk, pcvdom_element_t elem)
+{
+    if (walk->frame == NULL)
+        return pcvdom_element_parent(elem);
+
+    walk->frame = pcintr_stack_frame_get_parent(walk->frame);
+    if (walk->frame == NULL)
+        return NULL;
+
+    if (walk->frame->scope) {
+        pcvdom_element_t scope = walk->frame->scope;
+        walk->frame = NULL;
+        return scope;
+    }
+
+    return walk->frame->pos;
+}
+
+/* check that the scope walk from `frame` still visits the ancestors of
+   the start element recorded in the slot */
+static bool
+is_slot_valid(struct pcintr_stack_frame *frame, struct pcintr_var_slot *slot)
+{
+    if (slot->epoch != pcvarmgr_binding_epoch())
+        return false;
+
+    struct scope_walk walk;
+    pcvdom_element_t elem = scope_walk_first(&walk, frame);
+    if (elem == NULL || elem != slot->start)
+        return false;
+
+    for (size_t depth = 1; depth < slot->depth; depth++) {
+        pcvdom_element_t next = scope_walk_next(&walk, elem);
+        if (next == NULL || next != pcvdom_element_parent(elem))
+            return false;
+        elem = next;
+    }
+
+    /* the whole walk was checked for the variables out of scopes */
+    if (!slot->in_scope && scope_walk_next(&walk, elem))
+        return false;
+
+    return true;
+}
+
+static purc_variant_t
+resolve_named_var(pcintr_stack_t stack, struct pcintr_stack_frame *frame,
+        const char *name, struct pcintr_var_slot *slot)
+{
+    purc_coroutine_t cor = stack->co;
+    purc_variant_t v;
+
+    /* the result can be kept only if the walk goes along the vDOM */
+    bool along_vdom = true;
+    size_t depth = 0;
+
+    struct scope_walk walk;
+    pcvdom_element_t elem = scope_walk_first(&walk, frame);
+    pcvdom_element_t start = elem;
+    while (elem) {
+        depth++;
+        v = pcintr_get_scope_variable(cor, elem, name);
+        if (v) {
+            slot->mgr = pcintr_get_scope_variables(cor, elem);
+            slot->in_scope = true;
+            goto found;
+        }
+
+        pcvdom_element_t next = scope_walk_next(&walk, elem);
+        if (next && next != pcvdom_element_parent(elem))
+            along_vdom = false;
+        elem = next;
+    }
+
+    slot->in_scope = false;
+    v = find_cor_level_var(cor, name);
+    if (v) {
+        slot->mgr = cor->variables;
+        goto found;
+    }
+
+    v = find_inst_var(name);
+    if (v) {
+        slot->mgr = pcinst_get_variables();
+        goto found;
+    }
+
+    slot->site = NULL;
+    purc_set_error_with_info(PCVRNT_ERROR_NOT_FOUND, "name:%s", name);
+    return PURC_VARIANT_INVALID;
+
+found:
+    if (along_vdom && start && slot->mgr) {
+        slot->epoch = pcvarmgr_binding_epoch();
+        slot->start = start;
+        slot->depth = depth;
+    }
+    else {
+        slot->site = NULL;
+    }
+
+    purc_clr_error();
+    return v;
+}
+
+purc_variant_t
+pcintr_find_named_var_at_site(pcintr_stack_t stack, const char* name,
+        const void *site)
+{
+    if (!stack || !name || !site) {
+        PC_ASSERT(0); // FIXME: still recoverable???
+        return PURC_VARIANT_INVALID;
+    }
+
+    size_t len = strlen(name);
+    if (len > PCINTR_VAR_SLOT_NAME_MAX) {
+        return pcintr_find_named_var(stack, name);
+    }
+
+    if (stack->var_slots == NULL) {
+        stack->var_slots = (struct pcintr_var_slot *)calloc(
+                PCINTR_NR_VAR_SLOTS, sizeof(struct pcintr_var_slot));
+        if (stack->var_slots == NULL) {
+            return pcintr_find_named_var(stack, name);
+        }
+    }
+
+    struct pcintr_stack_frame* frame = pcintr_stack_get_bottom_frame(stack);
+    PC_ASSERT(frame);
+
+    /* temporary variables are bound at runtime; always look them up */
+    purc_variant_t v;
+    v = _find_named_temp_var(frame, name);
+    if (v) {
+        purc_clr_error();
+        return v;
+    }
+
+    /* the sites are nodes allocated by malloc() */
+    size_t idx = ((uintptr_t)site >> 4) % PCINTR_NR_VAR_SLOTS;
+    struct pcintr_var_slot *slot = stack->var_slots + idx;
+    if (slot->site == site && strcmp(slot->name, name) == 0) {
+        if (is_slot_valid(frame, slot)) {
+            v = pcvarmgr_get(slot->mgr, name);
+            if (v) {
+                purc_clr_error();
+                return v;
+            }
+        }
+    }
+    else {
+        slot->site = site;
+        memcpy(slot->name, name, len + 1);
+    }
+
+    return resolve_named_var(stack, frame, name, slot);
+}
+
 enum purc_symbol_var _to_symbol(char symbol)
 {
     switch (symbol) {
@@ -605,6 +801,116 @@ pcintr_get_symbolized_var (pcintr_stack_t stack, unsigned int number,
     return PURC_VARIANT_INVALID;
 }
 
+/* index the constant anchor of a frame; a dynamic one may evaluate to
+   a different value at every lookup, so the frame is only marked */
+static void
+index_frame_anchor(pcintr_stack_t stack, struct pcintr_stack_frame *frame)
+{
+    frame->anchor_indexed = 1;
+
+    pcvdom_element_t elem = frame->pos;
+    if (!elem || elem->node.type == PCVDOM_NODE_DOCUMENT)
+        return;
+
+    const char *anchor;
+    struct pcvdom_attr *attr = pcvdom_element_anchor_attr(elem, &anchor);
+    if (!attr)
+        return;
+
+    if (anchor == NULL) {
+        frame->anchor_dynamic = 1;
+        return;
+    }
+
+    if (anchor[0] != '#')
+        return;
+    anchor++;
+
+    pcutils_map_entry *entry = pcutils_map_find(stack->anchor_index, anchor);
+    if (entry) {
+        frame->anchor_shadowed = (struct pcintr_stack_frame *)entry->val;
+        entry->val = frame;
+    }
+    else if (pcutils_map_insert(stack->anchor_index, anchor, frame)) {
+        return;
+    }
+
+    frame->anchor = anchor;
+}
+
+static bool
+match_dynamic_anchor(pcintr_stack_t stack, struct pcintr_stack_frame *frame,
+        const char *anchor)
+{
+    struct pcvdom_attr *attr = pcvdom_element_anchor_attr(frame->pos, NULL);
+    purc_variant_t elem_id;
+    elem_id = pcvdom_element_eval_attr_val(stack, frame->pos, attr->key);
+    if (!elem_id)
+        return false;
+
+    bool matched = false;
+    if (purc_variant_is_string(elem_id)) {
+        const char *id = purc_variant_get_string_const(elem_id);
+        matched = id && id[0] == '#' && strcmp(id + 1, anchor) == 0;
+    }
+
+    purc_variant_unref(elem_id);
+    return matched;
+}
+
+/* index the anchors of the frames pushed since the last lookup */
+static int
+index_frame_anchors(pcintr_stack_t stack)
+{
+    if (stack->anchor_index == NULL) {
+        stack->anchor_index = pcutils_map_create(copy_key_string,
+                free_key_string, NULL, NULL, comp_key_string, false);
+        if (stack->anchor_index == NULL) {
+            purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
+            return -1;
+        }
+    }
+
+    /* the indexed frames are always the outermost ones */
+    struct list_head *p = stack->frames.prev;
+    while (p != &stack->frames) {
+        struct pcintr_stack_frame *frame;
+        frame = container_of(p, struct pcintr_stack_frame, node);
+        if (frame->anchor_indexed)
+            break;
+        p = p->prev;
+    }
+
+    for (p = p->next; p != &stack->frames; p = p->next) {
+        index_frame_anchor(stack,
+                container_of(p, struct pcintr_stack_frame, node));
+    }
+
+    return 0;
+}
+
+void
+pcintr_unindex_frame_anchor(pcintr_stack_t stack,
+        struct pcintr_stack_frame *frame)
+{
+    if (frame->anchor) {
+        pcutils_map_entry *entry;
+        entry = pcutils_map_find(stack->anchor_index, frame->anchor);
+        PC_ASSERT(entry && entry->val == frame);
+
+        if (frame->anchor_shadowed)
+            entry->val = frame->anchor_shadowed;
+        else
+            pcutils_map_erase(stack->anchor_index, frame->anchor);
+
+        frame->anchor = NULL;
+        frame->anchor_shadowed = NULL;
+    }
+
+    frame->anchor_indexed = 0;
+    frame->anchor_dynamic = 0;
+}
+
 purc_variant_t
 pcintr_find_anchor_symbolized_var(pcintr_stack_t stack, const char *anchor,
         char symbol)
@@ -617,45 +923,34 @@ pcintr_find_anchor_symbolized_var(pcintr_stack_t stack, const char *anchor,
     }
 
     struct pcintr_stack_frame* frame = pcintr_stack_get_bottom_frame(stack);
+    if (!frame || index_frame_anchors(stack))
+        return PURC_VARIANT_INVALID;
+
+    pcutils_map_entry *entry = pcutils_map_find(stack->anchor_index, anchor);
+    struct pcintr_stack_frame *anchored = entry ?
+        (struct pcintr_stack_frame *)entry->val : NULL;
+
+    /* the anchored frame must be reachable from the bottom frame; the
+       dynamic anchors of the frames in between are evaluated on the way,
+       since an inner frame takes precedence */
+    while (frame && frame != anchored) {
+        if (frame->anchor_dynamic && match_dynamic_anchor(stack, frame, anchor))
+            break;
+        frame = pcintr_stack_frame_get_parent(frame);
+    }
 
-    while (frame) {
-        pcvdom_element_t elem = frame->pos;
-        purc_variant_t elem_id;
-        const char *name = elem->tag_name;
-        const struct pchvml_tag_entry* entry = pchvml_tag_static_search(name,
-                strlen(name));
-        if (entry &&
-                (entry->cats & (PCHVML_TAGCAT_TEMPLATE | PCHVML_TAGCAT_VERB))) {
-            elem_id = pcvdom_element_eval_attr_val(stack, elem, ATTR_KEY_IDD_BY);
+    if (frame) {
+        ret = pcintr_get_symbol_var(frame, symbol_var);
+        if (ret == PURC_VARIANT_INVALID) {
+            purc_set_error_with_info(PCVRNT_ERROR_NOT_FOUND,
+                    "symbol:%c", symbol);
         }
         else {
-            elem_id = pcvdom_element_eval_attr_val(stack, elem, ATTR_KEY_ID);
-        }
-        if (!elem_id) {
-            frame = pcintr_stack_frame_get_parent(frame);
-            continue;
+            purc_clr_error();
         }
-
-        if (purc_variant_is_string(elem_id)) {
-            const char *id = purc_variant_get_string_const(elem_id);
-            if (id && id[0] == '#' && strcmp(id+1, anchor) == 0) {
-                ret = pcintr_get_symbol_var(frame, symbol_var);
-                if (ret == PURC_VARIANT_INVALID) {
-                    purc_set_error_with_info(PCVRNT_ERROR_NOT_FOUND,
-                            "symbol:%c", symbol);
-                }
-                else {
-                    purc_clr_error();
-                }
-                purc_variant_unref(elem_id);
-                return ret;
-            }
-        }
-        purc_variant_unref(elem_id);
-        frame = pcintr_stack_frame_get_parent(frame);
     }
 
-    return PURC_VARIANT_INVALID;
+    return ret;
 }
 
 static bool
@@ -82,6 +82,11 @@ pcrdr_event_handler pcrdr_conn_get_event_handler(pcrdr_conn *conn)
     return conn->event_handler;
 }
 
+bool pcrdr_conn_has_buffered_input(pcrdr_conn *conn)
+{
+    return conn->rdbuf && conn->rdbuf_pos < conn->rdbuf_len;
+}
+
 pcrdr_event_handler pcrdr_conn_set_event_handler(pcrdr_conn *conn,
         pcrdr_event_handler event_handler)
 {
@@ -172,6 +177,10 @@ int pcrdr_free_connection(pcrdr_conn* conn)
         free(conn->uri);
     }
 
+    if (conn->rdbuf) {
+        free(conn->rdbuf);
+    }
+
     struct pending_request *pr, *n;
     list_for_each_entry_safe(pr, n, &conn->pending_requests, list) {
         if (pr->response_handler) {
@@ -489,6 +498,45 @@ int pcrdr_wait_and_dispatch_message(pcrdr_conn* conn, int timeout_ms)
     return retval;
 }
 
+int pcrdr_drain_and_dispatch_messages(pcrdr_conn* conn, size_t budget)
+{
+    size_t nr_dispatched = 0;
+    int retval = 0;
+
+    /* check extra source first */
+    if (conn->source_fn) {
+        pcrdr_msg *msg = conn->source_fn(conn, conn->source_ctxt);
+        if (msg) {
+            dispatch_message(conn, msg);
+            nr_dispatched++;
+        }
+    }
+
+    while (nr_dispatched < budget) {
+        retval = conn->wait_message(conn, 0);
+        if (retval < 0) {
+            purc_set_error(PCRDR_ERROR_BAD_SYSTEM_CALL);
+            break;
+        }
+        else if (retval == 0) {
+            break;
+        }
+
+        pcrdr_msg *msg = conn->read_message(conn);
+        if (msg == NULL) {
+            retval = -1;
+            break;
+        }
+
+        dispatch_message(conn, msg);
+        nr_dispatched++;
+    }
+
+    /* scan the pending requests once for the whole batch */
+    check_timeout_requests(conn);
+    return (retval < 0) ? -1 : (int)nr_dispatched;
+}
+
 #define MSG_POINTER_INVALID     ((pcrdr_msg *)(-1))
 
 static int
@@ -87,6 +87,11 @@ struct pcrdr_conn {
     /* the rdr page handles */
     struct list_head page_handles;
 
+    /* the read-ahead buffer of a stream connection */
+    char   *rdbuf;
+    size_t  rdbuf_pos;
+    size_t  rdbuf_len;
+
     /* operations */
     int (*wait_message) (pcrdr_conn* conn, int timeout_ms);
     pcrdr_msg *(*read_message) (pcrdr_conn* conn);
@@ -34,6 +34,49 @@
 #include <errno.h>
 #include <assert.h>
 
+purc_atom_t pcrdr_msg_resolve_event_type(pcrdr_msg *msg)
+{
+    msg->eventTypeAtom = 0;
+    msg->eventSubTypeOffset = 0;
+
+    if (msg->eventName == NULL)
+        return 0;
+
+    size_t len;
+    const char *event = purc_variant_get_string_const_ex(msg->eventName, &len);
+    if (event == NULL)
+        return 0;
+
+    const char *separator = strchr(event, MSG_EVENT_SEPARATOR);
+    if (separator) {
+        msg->eventSubTypeOffset = separator - event + 1;
+        len = separator - event;
+    }
+
+    if (len == 0)
+        return 0;
+
+    char buf[64];
+    char *type = buf;
+    if (len >= sizeof(buf)) {
+        type = strndup(event, len);
+        if (type == NULL) {
+            purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
+            return 0;
+        }
+    }
+    else {
+        memcpy(buf, event, len);
+        buf[len] = '\0';
+    }
+
+    msg->eventTypeAtom = purc_atom_try_string_ex(ATOM_BUCKET_MSG, type);
+    if (type != buf)
+        free(type);
+
+    return msg->eventTypeAtom;
+}
+
 pcrdr_msg *pcrdr_make_void_message(void)
 {
     pcrdr_msg *msg = pcinst_get_message();
@@ -199,6 +242,7 @@ pcrdr_msg *pcrdr_make_event_message(
     msg->eventName = purc_variant_make_string(event_name, true);
     if (msg->eventName == NULL)
         goto failed;
+    pcrdr_msg_resolve_event_type(msg);
 
     if (source_uri) {
         msg->sourceURI = purc_variant_make_string(source_uri, true);
@@ -346,6 +390,8 @@ pcrdr_msg *pcrdr_clone_message(const pcrdr_msg *src)
     else if (msg->type == PCRDR_MSG_TYPE_EVENT) {
         assert(src->eventName);
         msg->eventName = purc_variant_ref(src->eventName);
+        msg->eventTypeAtom = src->eventTypeAtom;
+        msg->eventSubTypeOffset = src->eventSubTypeOffset;
     }
 
     if (src->sourceURI) {
@@ -492,8 +538,10 @@ static bool on_operation(pcrdr_msg *msg, char *value)
 static bool on_event_name(pcrdr_msg *msg, char *value)
 {
     msg->eventName = purc_variant_make_string(value, true);
-    if (msg->eventName)
+    if (msg->eventName) {
+        pcrdr_msg_resolve_event_type(msg);
         return true;
+    }
     return false;
 }
 
@@ -51,13 +51,63 @@
 #define CLI_PATH    "/var/tmp/"
 #define CLI_PERM    S_IRWXU
 
-static inline int conn_read (int fd, void *buff, ssize_t sz)
+/* the size of the read-ahead buffer of a Unix socket connection */
+#define SZ_READ_AHEAD_BUFF      8192
+
+/*
+ * Reads exactly `sz` bytes from the connection. The bytes are taken from
+ * the read-ahead buffer first; when the buffer runs dry, we refill it with
+ * one read() so that all the frames the renderer has sent in a burst can be
+ * parsed without a system call for every header and payload.
+ */
+static int conn_read (pcrdr_conn* conn, void *buff, ssize_t sz)
 {
-    if (read (fd, buff, sz) == sz) {
-        return 0;
+    char *dst = buff;
+    ssize_t n;
+
+    if (conn->rdbuf == NULL) {
+        conn->rdbuf = malloc (SZ_READ_AHEAD_BUFF);
+        if (conn->rdbuf == NULL)
+            return PCRDR_ERROR_NOMEM;
+        conn->rdbuf_pos = conn->rdbuf_len = 0;
+    }
+
+    while (sz > 0) {
+        size_t avail = conn->rdbuf_len - conn->rdbuf_pos;
+        if (avail > 0) {
+            n = (avail > (size_t)sz) ? sz : (ssize_t)avail;
+            memcpy (dst, conn->rdbuf + conn->rdbuf_pos, n);
+            conn->rdbuf_pos += n;
+            dst += n;
+            sz -= n;
+            continue;
+        }
+
+        if (sz >= SZ_READ_AHEAD_BUFF) {
+            /* large payload: read it directly into the caller's buffer */
+            n = read (conn->fd, dst, sz);
+            if (n > 0) {
+                dst += n;
+                sz -= n;
+                continue;
+            }
+        }
+        else {
+            n = read (conn->fd, conn->rdbuf, SZ_READ_AHEAD_BUFF);
+            if (n > 0) {
+                conn->rdbuf_pos = 0;
+                conn->rdbuf_len = n;
+                continue;
+            }
+        }
+
+        if (n < 0 && errno == EINTR)
+            continue;
+
+        return PCRDR_ERROR_IO;
     }
 
-    return PCRDR_ERROR_IO;
+    return 0;
 }
 
 static inline int conn_write (int fd, const void *data, ssize_t sz)
@@ -74,6 +124,10 @@ static int my_wait_message (pcrdr_conn* conn, int timeout_ms)
     fd_set rfds;
     struct timeval tv;
 
+    /* the frames already read ahead are not visible to select() */
+    if (pcrdr_conn_has_buffered_input (conn))
+        return 1;
+
     FD_ZERO (&rfds);
     FD_SET (conn->fd, &rfds);
 
@@ -338,7 +392,7 @@ int pcrdr_socket_read_packet (pcrdr_conn* conn, char* packet_buf, size_t *sz_pac
     if (conn->type == CT_UNIX_SOCKET) {
         USFrameHeader header;
 
-        if (conn_read (conn->fd, &header, sizeof (USFrameHeader))) {
+        if (conn_read (conn, &header, sizeof (USFrameHeader))) {
             PC_DEBUG ("Failed to read frame header from Unix socket\n");
             err_code = PCRDR_ERROR_IO;
             goto done;
@@ -381,7 +435,7 @@ int pcrdr_socket_read_packet (pcrdr_conn* conn, char* packet_buf, size_t *sz_pac
                 is_text = 0;
             }
 
-            if (conn_read (conn->fd, packet_buf, header.sz_payload)) {
+            if (conn_read (conn, packet_buf, header.sz_payload)) {
                 PC_DEBUG ("Failed to read packet from Unix socket\n");
                 err_code = PCRDR_ERROR_IO;
                 goto done;
@@ -394,7 +448,7 @@ int pcrdr_socket_read_packet (pcrdr_conn* conn, char* packet_buf, size_t *sz_pac
                 left = 0;
             offset = header.sz_payload;
             while (left > 0) {
-                if (conn_read (conn->fd, &header, sizeof (USFrameHeader))) {
+                if (conn_read (conn, &header, sizeof (USFrameHeader))) {
                     PC_DEBUG ("Failed to read frame header from Unix socket\n");
                     err_code = PCRDR_ERROR_IO;
                     goto done;
@@ -407,7 +461,7 @@ int pcrdr_socket_read_packet (pcrdr_conn* conn, char* packet_buf, size_t *sz_pac
                     goto done;
                 }
 
-                if (conn_read (conn->fd, packet_buf + offset, header.sz_payload)) {
+                if (conn_read (conn, packet_buf + offset, header.sz_payload)) {
                     PC_DEBUG ("Failed to read packet from Unix socket\n");
                     err_code = PCRDR_ERROR_IO;
                     goto done;
@@ -459,7 +513,7 @@ int pcrdr_socket_read_packet_alloc (pcrdr_conn* conn, void **packet, size_t *sz_
     if (conn->type == CT_UNIX_SOCKET) {
         USFrameHeader header;
 
-        if (conn_read (conn->fd, &header, sizeof (USFrameHeader))) {
+        if (conn_read (conn, &header, sizeof (USFrameHeader))) {
             PC_DEBUG ("Failed to read frame header from Unix socket\n");
             err_code = PCRDR_ERROR_IO;
             goto done;
@@ -522,14 +576,14 @@ int pcrdr_socket_read_packet_alloc (pcrdr_conn* conn, void **packet, size_t *sz_
                 goto done;
             }
 
-            if (conn_read (conn->fd, packet_buf, header.sz_payload)) {
+            if (conn_read (conn, packet_buf, header.sz_payload)) {
                 PC_DEBUG ("Failed to read packet from Unix socket\n");
                 err_code = PCRDR_ERROR_IO;
                 goto done;
             }
 
             while (left > 0) {
-                if (conn_read (conn->fd, &header, sizeof (USFrameHeader))) {
+                if (conn_read (conn, &header, sizeof (USFrameHeader))) {
                     PC_DEBUG ("Failed to read frame header from Unix socket\n");
                     err_code = PCRDR_ERROR_IO;
                     goto done;
@@ -542,7 +596,7 @@ int pcrdr_socket_read_packet_alloc (pcrdr_conn* conn, void **packet, size_t *sz_
                     goto done;
                 }
 
-                if (conn_read (conn->fd, packet_buf + offset, header.sz_payload)) {
+                if (conn_read (conn, packet_buf + offset, header.sz_payload)) {
                     PC_DEBUG ("Failed to read packet from Unix socket\n");
                     err_code = PCRDR_ERROR_IO;
                     goto done;
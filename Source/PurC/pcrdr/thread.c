@@ -78,8 +78,7 @@ static pcrdr_msg *my_read_message(pcrdr_conn* conn)
 
     UNUSED_PARAM(conn);
 
-    msg = purc_inst_take_away_message(0);
-    if (msg == NULL) {
+    if (purc_inst_take_away_messages(&msg, 1) == 0) {
         purc_set_error(PCRDR_ERROR_UNEXPECTED);
         return NULL;
     }
@@ -140,8 +139,8 @@ static int my_disconnect(pcrdr_conn* conn)
         goto failed;
     }
 
-    pcrdr_msg *msg = purc_inst_take_away_message(0);
-    if (msg == NULL) {
+    pcrdr_msg *msg;
+    if (purc_inst_take_away_messages(&msg, 1) == 0) {
         err_code = PCRDR_ERROR_UNEXPECTED;
         goto failed;
     }
@@ -246,8 +245,7 @@ pcrdr_msg *pcrdr_thread_connect(const char* renderer_uri,
         goto failed;
     }
 
-    msg = purc_inst_take_away_message(0);
-    if (msg == NULL) {
+    if (purc_inst_take_away_messages(&msg, 1) == 0) {
         err_code = PCRDR_ERROR_UNEXPECTED;
         goto failed;
     }
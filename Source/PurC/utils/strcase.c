@@ -232,6 +232,21 @@ int pcutils_strncasecmp(const char *s1, const char *s2, size_t n)
     return 0;
 }
 
+void pcutils_utf8_casefold(const char *str,
+        pcutils_casefold_cb cb, void *ctxt)
+{
+    gunichar ucs[MAX_LOWER_CHARS];
+
+    locale_type lt = get_locale_type();
+
+    while (*str) {
+        str += utf8_char_to_lower(lt, str, ucs);
+
+        for (size_t i = 0; i < MAX_LOWER_CHARS && ucs[i]; i++)
+            cb(ctxt, ucs[i]);
+    }
+}
+
 char *pcutils_strcasestr(const char *haystack, const char *needle)
 {
     locale_type lt = get_locale_type();
@@ -331,6 +346,15 @@ int pcutils_strncasecmp(const char *s1, const char *s2, size_t n)
     return strncasecmp(s1, s2, n);
 }
 
+void pcutils_utf8_casefold(const char *str,
+        pcutils_casefold_cb cb, void *ctxt)
+{
+    while (*str) {
+        cb(ctxt, (uint32_t)purc_tolower((unsigned char)*str));
+        str++;
+    }
+}
+
 char *pcutils_strcasestr(const char *haystack, const char *needle)
 {
     char* p = (char *)haystack;
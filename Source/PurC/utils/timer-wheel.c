@@ -0,0 +1,237 @@
+/*
+ * @file timer-wheel.c
+ * @date 2026/10/16
+ * @brief The implementation of hierarchical timing wheel.
+ *
+ * Copyright (C) 2021 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#include "private/timer-wheel.h"
+
+#define LEVEL_BITS          PCUTILS_TWHEEL_LEVEL_BITS
+#define LEVEL_SIZE          PCUTILS_TWHEEL_LEVEL_SIZE
+#define LEVEL_MASK          (PCUTILS_TWHEEL_LEVEL_SIZE - 1)
+#define NR_LEVELS           PCUTILS_TWHEEL_NR_LEVELS
+
+#define LEVEL_SHIFT(l)      ((l) * LEVEL_BITS)
+/* the time span covered by one slot of the level */
+#define SLOT_SPAN(l)        ((uint64_t)1 << LEVEL_SHIFT(l))
+#define WHEEL_SPAN          ((uint64_t)1 << LEVEL_SHIFT(NR_LEVELS))
+
+#define NOT_IN_WHEEL        -1
+
+void pcutils_twheel_init(struct pcutils_twheel *wheel, uint64_t now)
+{
+    wheel->current = now;
+    wheel->nr_nodes = 0;
+    for (int l = 0; l < NR_LEVELS; l++) {
+        wheel->nr_level_nodes[l] = 0;
+        for (int i = 0; i < LEVEL_SIZE; i++) {
+            list_head_init(&wheel->slots[l][i]);
+        }
+    }
+}
+
+void pcutils_twheel_node_init(struct pcutils_twheel_node *node,
+        pcutils_twheel_expired_fn on_expired)
+{
+    list_head_init(&node->ln);
+    node->expires = 0;
+    node->on_expired = on_expired;
+    node->level = NOT_IN_WHEEL;
+}
+
+static void
+place_node(struct pcutils_twheel *wheel, struct pcutils_twheel_node *node)
+{
+    uint64_t expires = node->expires;
+    if (expires < wheel->current) {
+        /* already expired; fire it on the next tick */
+        expires = wheel->current;
+    }
+
+    uint64_t delta = expires - wheel->current;
+    if (delta >= WHEEL_SPAN) {
+        /* re-placed when the top level wraps */
+        delta = WHEEL_SPAN - 1;
+        expires = wheel->current + delta;
+    }
+
+    int level = 0;
+    while (level < NR_LEVELS - 1 && delta >= SLOT_SPAN(level + 1)) {
+        level++;
+    }
+
+    int idx = (expires >> LEVEL_SHIFT(level)) & LEVEL_MASK;
+    list_add_tail(&node->ln, &wheel->slots[level][idx]);
+    node->level = level;
+    wheel->nr_level_nodes[level]++;
+}
+
+void pcutils_twheel_add(struct pcutils_twheel *wheel,
+        struct pcutils_twheel_node *node, uint64_t expires)
+{
+    pcutils_twheel_remove(wheel, node);
+
+    node->expires = expires;
+    place_node(wheel, node);
+    wheel->nr_nodes++;
+}
+
+void pcutils_twheel_remove(struct pcutils_twheel *wheel,
+        struct pcutils_twheel_node *node)
+{
+    if (list_empty(&node->ln)) {
+        return;
+    }
+
+    list_del_init(&node->ln);
+    if (node->level != NOT_IN_WHEEL) {
+        wheel->nr_level_nodes[node->level]--;
+        wheel->nr_nodes--;
+        node->level = NOT_IN_WHEEL;
+    }
+}
+
+static void
+cascade_slot(struct pcutils_twheel *wheel, int level, int idx)
+{
+    LIST_HEAD(nodes);
+    list_splice_init(&wheel->slots[level][idx], &nodes);
+
+    struct pcutils_twheel_node *node, *next;
+    list_for_each_entry_safe(node, next, &nodes, ln) {
+        list_del(&node->ln);
+        wheel->nr_level_nodes[level]--;
+        place_node(wheel, node);
+    }
+}
+
+/* move the expired nodes in the level 0 slot of the tick to `expired` */
+static void
+collect_slot(struct pcutils_twheel *wheel, int idx, struct list_head *expired)
+{
+    struct pcutils_twheel_node *node, *next;
+    list_for_each_entry_safe(node, next, &wheel->slots[0][idx], ln) {
+        list_del(&node->ln);
+        list_add_tail(&node->ln, expired);
+        node->level = NOT_IN_WHEEL;
+        wheel->nr_level_nodes[0]--;
+        wheel->nr_nodes--;
+    }
+}
+
+size_t pcutils_twheel_expire(struct pcutils_twheel *wheel, uint64_t now)
+{
+    LIST_HEAD(expired);
+
+    while (wheel->current <= now) {
+        if (wheel->nr_nodes == 0) {
+            wheel->current = now + 1;
+            break;
+        }
+
+        uint64_t tick = wheel->current;
+        int idx = tick & LEVEL_MASK;
+        if (idx == 0) {
+            for (int l = 1; l < NR_LEVELS; l++) {
+                int i = (tick >> LEVEL_SHIFT(l)) & LEVEL_MASK;
+                cascade_slot(wheel, l, i);
+                if (i != 0)
+                    break;
+            }
+        }
+
+        collect_slot(wheel, idx, &expired);
+
+        /* skip the ticks having nothing to fire or to cascade */
+        int lowest = 0;
+        while (lowest < NR_LEVELS - 1 && wheel->nr_level_nodes[lowest] == 0) {
+            lowest++;
+        }
+
+        uint64_t next = (tick | (SLOT_SPAN(lowest) - 1)) + 1;
+        wheel->current = (next > now + 1) ? now + 1 : next;
+    }
+
+    size_t n = 0;
+    while (!list_empty(&expired)) {
+        struct pcutils_twheel_node *node;
+        node = list_first_entry(&expired, struct pcutils_twheel_node, ln);
+        list_del_init(&node->ln);
+        n++;
+
+        /* the callback may re-add or free the node */
+        node->on_expired(node);
+    }
+
+    return n;
+}
+
+int64_t pcutils_twheel_next_expiry(struct pcutils_twheel *wheel)
+{
+    if (wheel->nr_nodes == 0) {
+        return -1;
+    }
+
+    uint64_t current = wheel->current;
+    uint64_t earliest = UINT64_MAX;
+
+    if (wheel->nr_level_nodes[0]) {
+        for (int k = 0; k < LEVEL_SIZE; k++) {
+            int i = (current + k) & LEVEL_MASK;
+            if (!list_empty(&wheel->slots[0][i])) {
+                earliest = current + k;
+                break;
+            }
+        }
+    }
+
+    for (int l = 1; l < NR_LEVELS; l++) {
+        if (wheel->nr_level_nodes[l] == 0) {
+            continue;
+        }
+
+        uint64_t base = current >> LEVEL_SHIFT(l);
+        int i = base & LEVEL_MASK;
+        if ((current & (SLOT_SPAN(l) - 1)) == 0 &&
+                !list_empty(&wheel->slots[l][i])) {
+            /* the slot will be cascaded on the current tick */
+            earliest = current;
+            break;
+        }
+
+        /* the slot is cascaded when the level reaches it */
+        for (int k = 1; k <= LEVEL_SIZE; k++) {
+            i = (base + k) & LEVEL_MASK;
+            if (!list_empty(&wheel->slots[l][i])) {
+                uint64_t t = (base + k) << LEVEL_SHIFT(l);
+                if (t < earliest)
+                    earliest = t;
+                break;
+            }
+        }
+    }
+
+    return (int64_t)earliest;
+}
@@ -238,14 +238,14 @@ purc_variant_make_string_ex(const char* str_utf8, size_t len,
     }
     else {
         char* new_buf;
-        new_buf = malloc(len + 1);
+        new_buf = pcvariant_cache_alloc(len + 1);
         if(new_buf == NULL) {
             pcvariant_put (value);
             pcinst_set_error (PURC_ERROR_OUT_OF_MEMORY);
             return PURC_VARIANT_INVALID;
         }
 
-        value->flags = PCVRNT_FLAG_EXTRA_SIZE;
+        value->flags = PCVRNT_FLAG_EXTRA_SIZE | PCVRNT_FLAG_EXTRA_CACHED;
         // VWNOTE: sz_ptr[0] will be set in pcvariant_stat_set_extra_size
         value->sz_ptr[1] = (uintptr_t)new_buf;
         memcpy(new_buf, str_utf8, len);
@@ -416,9 +416,13 @@ void pcvariant_string_release (purc_variant_t string)
 
     if (IS_TYPE (string, PURC_VARIANT_TYPE_STRING)) {
         if (string->flags & PCVRNT_FLAG_EXTRA_SIZE) {
+            size_t sz_extra = string->sz_ptr[0];
             // VWNOTE: sz_ptr[0] will be set in pcvariant_stat_set_extra_size
             pcvariant_stat_set_extra_size (string, 0);
-            free ((void *)string->sz_ptr[1]);
+            if (string->flags & PCVRNT_FLAG_EXTRA_CACHED)
+                pcvariant_cache_free ((void *)string->sz_ptr[1], sz_extra);
+            else
+                free ((void *)string->sz_ptr[1]);
         }
     }
     else
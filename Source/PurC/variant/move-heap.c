@@ -136,6 +136,10 @@ struct pcmodule _module_mvheap = {
 static void
 move_variant_in(struct pcinst *inst, purc_variant_t v)
 {
+    /* frozen variants are always accounted in the move heap */
+    if (v->flags & PCVRNT_FLAG_FROZEN)
+        return;
+
     /* move directly and change the stat info */
 
     if (IS_CONTAINER(v->type) ||
@@ -168,7 +172,11 @@ move_or_clone_immutable(struct pcinst *inst, purc_variant_t v)
     if (IS_CONTAINER(v->type))
         return retv;
 
-    if (v == &inst->org_vrt_heap->v_undefined) {
+    if (v->flags & PCVRNT_FLAG_FROZEN) {
+        /* shared as is */
+        retv = v;
+    }
+    else if (v == &inst->org_vrt_heap->v_undefined) {
         retv = &move_heap.v_undefined;
         v->refc--;
         retv->refc++;
@@ -206,6 +214,7 @@ move_or_clone_immutable(struct pcinst *inst, purc_variant_t v)
 
         retv = pcvariant_alloc();
         memcpy(retv, v, sizeof(*retv));
+        retv->flags &= ~PCVRNT_FLAG_EXTRA_CACHED;
         retv->refc = 1;
 
         /* copy the extra space */
@@ -444,6 +453,9 @@ move_or_clone_mutable_descendants_in_array(struct travel_context *ctxt,
         purc_variant_t retv;
 
         UNUSED_PARAM(idx);
+        if (v->flags & PCVRNT_FLAG_FROZEN)
+            continue;
+
         switch (v->type) {
         case PURC_VARIANT_TYPE_ARRAY:
             if (v->refc == 1) {
@@ -480,7 +492,7 @@ move_or_clone_mutable_descendants_in_array(struct travel_context *ctxt,
 
             move_keys_in_cloned_container(ctxt, retv);
 
-            _p->val = retv;
+            pcvar_arr_replace_member(arr, idx, retv);
             pcutils_arrlist_append(ctxt->vrts_to_unref, v);
         }
 
@@ -500,6 +512,16 @@ move_or_clone_mutable_descendants_in_object(struct travel_context *ctxt,
         PC_DEBUG("a key when handling mutable variant: %s (%u)\n",
                 purc_variant_get_string_const(k), (unsigned)v->refc);
 
+        if (IS_CONTAINER(v->type) && (v->flags & PCVRNT_FLAG_FROZEN)) {
+            /* the frozen container is shared as is; only move in the key */
+            retk = move_or_clone_immutable(ctxt->inst, k);
+            if (retk != k) {
+                _node->key = retk;
+                pcutils_arrlist_append(ctxt->vrts_to_unref, k);
+            }
+            continue;
+        }
+
         switch (v->type) {
         case PURC_VARIANT_TYPE_ARRAY:
             if (v->refc == 1) {
@@ -568,6 +590,9 @@ move_or_clone_mutable_descendants_in_set(struct travel_context *ctxt,
     foreach_value_in_variant_set(set, v) {
         purc_variant_t retv;
 
+        if (v->flags & PCVRNT_FLAG_FROZEN)
+            continue;
+
         switch (v->type) {
         case PURC_VARIANT_TYPE_ARRAY:
             if (v->refc == 1) {
@@ -627,6 +652,9 @@ move_or_clone_mutable_descendants_in_tuple(struct travel_context *ctxt,
         v = members[idx];
         purc_variant_t retv;
 
+        if (v->flags & PCVRNT_FLAG_FROZEN)
+            continue;
+
         switch (v->type) {
         case PURC_VARIANT_TYPE_ARRAY:
             if (v->refc == 1) {
@@ -714,6 +742,9 @@ move_or_clone_immutable_descendants_in_array(struct travel_context *ctxt,
         purc_variant_t retv;
 
         UNUSED_PARAM(idx);
+        if (v->flags & PCVRNT_FLAG_FROZEN)
+            continue;
+
         switch (v->type) {
         case PURC_VARIANT_TYPE_ARRAY:
             move_or_clone_immutable_descendants_in_array(ctxt, v);
@@ -745,7 +776,7 @@ move_or_clone_immutable_descendants_in_array(struct travel_context *ctxt,
         }
 
         if (retv != v) {
-            _p->val = retv;
+            pcvar_arr_replace_member(arr, idx, retv);
             if (!(v->flags & PCVRNT_FLAG_NOFREE))
                 pcutils_arrlist_append(ctxt->vrts_to_unref, v);
         }
@@ -763,6 +794,10 @@ move_or_clone_immutable_descendants_in_object(struct travel_context *ctxt,
     foreach_key_value_in_variant_object(obj, k, v) {
         purc_variant_t retk, retv;
 
+        /* the key of a frozen container is moved in with mutable ones */
+        if (IS_CONTAINER(v->type) && (v->flags & PCVRNT_FLAG_FROZEN))
+            continue;
+
         switch (v->type) {
         case PURC_VARIANT_TYPE_ARRAY:
             move_or_clone_immutable_descendants_in_array(ctxt, v);
@@ -809,6 +844,9 @@ move_or_clone_immutable_descendants_in_set(struct travel_context *ctxt,
     foreach_value_in_variant_set(set, v) {
         purc_variant_t retv;
 
+        if (v->flags & PCVRNT_FLAG_FROZEN)
+            continue;
+
         switch (v->type) {
         case PURC_VARIANT_TYPE_ARRAY:
             move_or_clone_immutable_descendants_in_array(ctxt, v);
@@ -864,6 +902,9 @@ move_or_clone_immutable_descendants_in_tuple(struct travel_context *ctxt,
         v = members[idx];
         purc_variant_t retv;
 
+        if (v->flags & PCVRNT_FLAG_FROZEN)
+            continue;
+
         switch (v->type) {
         case PURC_VARIANT_TYPE_ARRAY:
             move_or_clone_immutable_descendants_in_array(ctxt, v);
@@ -936,6 +977,10 @@ purc_variant_t pcvariant_move_heap_in(purc_variant_t v)
     struct pcinst *inst = pcinst_current();
     struct travel_context ctxt;
 
+    /* a frozen variant can be shared by instances without moving */
+    if (v->flags & PCVRNT_FLAG_FROZEN)
+        return v;
+
     ctxt.inst = pcinst_current();
     ctxt.vrts_to_unref = pcutils_arrlist_new(cb_free_element);
     if (ctxt.vrts_to_unref == NULL) {
@@ -1020,6 +1065,9 @@ static purc_variant_t move_array_descendants_out(purc_variant_t arr)
         purc_variant_t retv;
 
         UNUSED_PARAM(idx);
+        if (v->flags & PCVRNT_FLAG_FROZEN)
+            continue;
+
         switch (v->type) {
         case PURC_VARIANT_TYPE_ARRAY:
             retv = move_array_descendants_out(v);
@@ -1046,7 +1094,7 @@ static purc_variant_t move_array_descendants_out(purc_variant_t arr)
             break;
         }
 
-        _p->val = retv;
+        pcvar_arr_replace_member(arr, idx, retv);
 
     } end_foreach;
 
@@ -1060,6 +1108,11 @@ static purc_variant_t move_object_descendants_out(purc_variant_t obj)
         purc_variant_t retk, retv;
 
         retk = move_variant_out(k);
+        if (v->flags & PCVRNT_FLAG_FROZEN) {
+            _node->key = retk;
+            continue;
+        }
+
         switch (v->type) {
         case PURC_VARIANT_TYPE_ARRAY:
             retv = move_array_descendants_out(v);
@@ -1100,6 +1153,9 @@ static purc_variant_t move_set_descendants_out(purc_variant_t set)
     foreach_value_in_variant_set(set, v) {
         purc_variant_t retv;
 
+        if (v->flags & PCVRNT_FLAG_FROZEN)
+            continue;
+
         switch (v->type) {
         case PURC_VARIANT_TYPE_ARRAY:
             retv = move_array_descendants_out(v);
@@ -1144,6 +1200,9 @@ static purc_variant_t move_tuple_descendants_out(purc_variant_t tuple)
         v = members[idx];
         purc_variant_t retv;
 
+        if (v->flags & PCVRNT_FLAG_FROZEN)
+            continue;
+
         switch (v->type) {
         case PURC_VARIANT_TYPE_ARRAY:
             retv = move_array_descendants_out(v);
@@ -1180,7 +1239,10 @@ static purc_variant_t move_variant_out(purc_variant_t v)
     purc_variant_t retv = v;
     struct pcinst *inst = pcinst_current();
 
-    if (v == &move_heap.v_undefined) {
+    if (v->flags & PCVRNT_FLAG_FROZEN) {
+        return retv;
+    }
+    else if (v == &move_heap.v_undefined) {
         retv = &inst->org_vrt_heap->v_undefined;
         v->refc--;
         retv->refc++;
@@ -1281,3 +1343,223 @@ void pcvariant_use_norm_heap(void)
     purc_mutex_unlock(&mh_lock);
 }
 
+bool pcvariant_is_using_move_heap(void)
+{
+    struct pcinst *inst = pcinst_current();
+    return inst->variant_heap == &move_heap;
+}
+
+static purc_variant_t freeze_variant(purc_variant_t v);
+
+static purc_variant_t freeze_scalar(purc_variant_t v)
+{
+    purc_variant_t retv = pcvariant_get(v->type);
+    if (retv == PURC_VARIANT_INVALID)
+        return retv;
+
+    /* the constants are per instance; make a private copy for them */
+    memcpy(retv, v, sizeof(*retv));
+    retv->flags &= ~(PCVRNT_FLAG_NOFREE | PCVRNT_FLAG_EXTRA_CACHED);
+    retv->refc = 1;
+    INIT_LIST_HEAD(&retv->listeners);
+
+    if ((v->type == PURC_VARIANT_TYPE_STRING ||
+                v->type == PURC_VARIANT_TYPE_BSEQUENCE) &&
+            (v->flags & PCVRNT_FLAG_EXTRA_SIZE)) {
+        void *extra = malloc(v->sz_ptr[0]);
+        if (extra == NULL) {
+            retv->flags &= ~PCVRNT_FLAG_EXTRA_SIZE;
+            pcvariant_put(retv);
+            purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
+            return PURC_VARIANT_INVALID;
+        }
+
+        memcpy(extra, (void *)v->sz_ptr[1], v->sz_ptr[0]);
+        retv->sz_ptr[1] = (uintptr_t)extra;
+
+        move_heap.stat.sz_mem[v->type] += v->sz_ptr[0];
+        move_heap.stat.sz_total_mem += v->sz_ptr[0];
+    }
+
+    return retv;
+}
+
+static purc_variant_t freeze_array(purc_variant_t arr)
+{
+    purc_variant_t retv;
+    retv = purc_variant_make_array(0, PURC_VARIANT_INVALID);
+    if (retv == PURC_VARIANT_INVALID)
+        return retv;
+
+    size_t idx;
+    purc_variant_t v;
+    foreach_value_in_variant_array(arr, v, idx) {
+        UNUSED_PARAM(idx);
+
+        purc_variant_t frozen = freeze_variant(v);
+        if (frozen == PURC_VARIANT_INVALID)
+            goto failed;
+
+        bool ok = purc_variant_array_append(retv, frozen);
+        purc_variant_unref(frozen);
+        if (!ok)
+            goto failed;
+    } end_foreach;
+
+    return retv;
+
+failed:
+    purc_variant_unref(retv);
+    return PURC_VARIANT_INVALID;
+}
+
+static purc_variant_t freeze_object(purc_variant_t obj)
+{
+    purc_variant_t retv = pcvar_make_obj();
+    if (retv == PURC_VARIANT_INVALID)
+        return retv;
+
+    purc_variant_t k, v;
+    foreach_key_value_in_variant_object(obj, k, v) {
+        purc_variant_t frozen_k, frozen_v;
+
+        frozen_k = freeze_variant(k);
+        if (frozen_k == PURC_VARIANT_INVALID)
+            goto failed;
+
+        frozen_v = freeze_variant(v);
+        if (frozen_v == PURC_VARIANT_INVALID) {
+            purc_variant_unref(frozen_k);
+            goto failed;
+        }
+
+        int r = pcvar_obj_set(retv, frozen_k, frozen_v);
+        purc_variant_unref(frozen_k);
+        purc_variant_unref(frozen_v);
+        if (r)
+            goto failed;
+    } end_foreach;
+
+    return retv;
+
+failed:
+    purc_variant_unref(retv);
+    return PURC_VARIANT_INVALID;
+}
+
+static purc_variant_t freeze_set(purc_variant_t set)
+{
+    purc_variant_t retv = pcvar_set_clone_struct(set);
+    if (retv == PURC_VARIANT_INVALID)
+        return retv;
+
+    purc_variant_t v;
+    foreach_value_in_variant_set(set, v) {
+        purc_variant_t frozen = freeze_variant(v);
+        if (frozen == PURC_VARIANT_INVALID)
+            goto failed;
+
+        int r = pcvar_set_add(retv, frozen);
+        purc_variant_unref(frozen);
+        if (r)
+            goto failed;
+    } end_foreach;
+
+    return retv;
+
+failed:
+    purc_variant_unref(retv);
+    return PURC_VARIANT_INVALID;
+}
+
+static purc_variant_t freeze_tuple(purc_variant_t tuple)
+{
+    size_t sz;
+    purc_variant_t *members = tuple_members(tuple, &sz);
+    assert(members);
+
+    purc_variant_t retv = purc_variant_make_tuple(sz, NULL);
+    if (retv == PURC_VARIANT_INVALID)
+        return retv;
+
+    /* replace the initial null members with the frozen ones */
+    purc_variant_t *frozen_members = tuple_members(retv, &sz);
+    for (size_t idx = 0; idx < sz; idx++) {
+        purc_variant_t frozen = freeze_variant(members[idx]);
+        if (frozen == PURC_VARIANT_INVALID) {
+            purc_variant_unref(retv);
+            return PURC_VARIANT_INVALID;
+        }
+
+        purc_variant_unref(frozen_members[idx]);
+        frozen_members[idx] = frozen;
+    }
+
+    return retv;
+}
+
+/* make a frozen copy of the variant; the descendants are frozen before
+   they are added to the copy, so no reverse update edge is built on them. */
+static purc_variant_t freeze_variant(purc_variant_t v)
+{
+    purc_variant_t retv;
+
+    if (v->flags & PCVRNT_FLAG_FROZEN)
+        return purc_variant_ref(v);
+
+    switch (v->type) {
+    case PURC_VARIANT_TYPE_DYNAMIC:
+    case PURC_VARIANT_TYPE_NATIVE:
+        purc_set_error(PURC_ERROR_NOT_SUPPORTED);
+        return PURC_VARIANT_INVALID;
+
+    case PURC_VARIANT_TYPE_ARRAY:
+        retv = freeze_array(v);
+        break;
+
+    case PURC_VARIANT_TYPE_OBJECT:
+        retv = freeze_object(v);
+        break;
+
+    case PURC_VARIANT_TYPE_SET:
+        retv = freeze_set(v);
+        break;
+
+    case PURC_VARIANT_TYPE_TUPLE:
+        retv = freeze_tuple(v);
+        break;
+
+    default:
+        retv = freeze_scalar(v);
+        break;
+    }
+
+    if (retv != PURC_VARIANT_INVALID)
+        retv->flags |= PCVRNT_FLAG_FROZEN;
+    return retv;
+}
+
+purc_variant_t purc_variant_freeze(purc_variant_t v)
+{
+    if (v == PURC_VARIANT_INVALID) {
+        purc_set_error(PURC_ERROR_INVALID_VALUE);
+        return PURC_VARIANT_INVALID;
+    }
+
+#if HAVE(STDATOMIC_H)
+    if (v->flags & PCVRNT_FLAG_FROZEN)
+        return purc_variant_ref(v);
+
+    /* frozen variants are allocated from and accounted in the move heap,
+       because they may be released by any instance. */
+    pcvariant_use_move_heap();
+    purc_variant_t retv = freeze_variant(v);
+    pcvariant_use_norm_heap();
+
+    return retv;
+#else
+    purc_set_error(PURC_ERROR_NOT_SUPPORTED);
+    return PURC_VARIANT_INVALID;
+#endif
+}
+
@@ -0,0 +1,704 @@
+/*
+ * @file numeric.c
+ * @date 2026/10/16
+ * @brief The aggregate and element-wise numeric kernels on linear containers.
+ *
+ * Copyright (C) 2021 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+#include "private/variant.h"
+#include "private/errors.h"
+#include "variant-internals.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * The members are unboxed into a fixed-size block on the stack, and the
+ * kernels run over the block with independent accumulators and without
+ * any branch on the variant type, so that the compiler can vectorize them.
+ * The numbers of a packed array are copied into the block as they are.
+ */
+#define NUMERIC_BLOCK_SIZE      64
+
+/* the size of a number in a packed array, for all packed types */
+#define PACKED_NUMBER_SIZE      8
+
+/* a linear source of numbers: the members of an array or a tuple, or
+   the numbers in a packed array */
+struct numeric_src {
+    purc_variant_t         *members;
+    const unsigned char    *bytes;
+    pcvrnt_packed_type_k    type;
+    size_t                  sz;
+};
+
+static bool
+linear_src(purc_variant_t container, struct numeric_src *src)
+{
+    if (container == PURC_VARIANT_INVALID)
+        return false;
+
+    src->bytes = NULL;
+    if (container->type == PURC_VARIANT_TYPE_ARRAY) {
+        variant_arr_t data = pcvar_arr_get_data(container);
+        src->members = data->members;
+        src->sz = data->nr_members;
+        return true;
+    }
+    else if (container->type == PURC_VARIANT_TYPE_TUPLE) {
+        src->members = tuple_members(container, &src->sz);
+        return true;
+    }
+
+    return false;
+}
+
+static bool
+packed_src(purc_variant_t packed, pcvrnt_packed_type_k type,
+        struct numeric_src *src)
+{
+    if (packed == PURC_VARIANT_INVALID ||
+            packed->type != PURC_VARIANT_TYPE_BSEQUENCE) {
+        pcinst_set_error(PURC_ERROR_WRONG_DATA_TYPE);
+        return false;
+    }
+
+    size_t nr_bytes;
+    const unsigned char *bytes = purc_variant_get_bytes_const(packed,
+            &nr_bytes);
+    if ((unsigned)type > PCVRNT_PACKED_TYPE_U64 ||
+            nr_bytes % PACKED_NUMBER_SIZE) {
+        pcinst_set_error(PURC_ERROR_INVALID_VALUE);
+        return false;
+    }
+
+    src->members = NULL;
+    src->bytes = bytes;
+    src->type = type;
+    src->sz = nr_bytes / PACKED_NUMBER_SIZE;
+    return true;
+}
+
+static bool
+unbox_doubles(purc_variant_t *members, size_t n, double *buf)
+{
+    for (size_t i = 0; i < n; i++) {
+        purc_variant_t v = members[i];
+        if (v->type == PURC_VARIANT_TYPE_NUMBER) {
+            buf[i] = v->d;
+        }
+        else if (!purc_variant_cast_to_number(v, buf + i, false)) {
+            pcinst_set_error(PURC_ERROR_WRONG_DATA_TYPE);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool
+unbox_longints(purc_variant_t *members, size_t n, int64_t *buf)
+{
+    for (size_t i = 0; i < n; i++) {
+        purc_variant_t v = members[i];
+        if (v->type == PURC_VARIANT_TYPE_LONGINT) {
+            buf[i] = v->i64;
+        }
+        else if (!purc_variant_cast_to_longint(v, buf + i, true)) {
+            pcinst_set_error(PURC_ERROR_WRONG_DATA_TYPE);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* the numbers in a packed array may be unaligned, so they are copied */
+static bool
+fetch_doubles(const struct numeric_src *src, size_t from, size_t n,
+        double *buf)
+{
+    if (src->members)
+        return unbox_doubles(src->members + from, n, buf);
+
+    const unsigned char *p = src->bytes + from * PACKED_NUMBER_SIZE;
+    size_t i;
+
+    switch (src->type) {
+    case PCVRNT_PACKED_TYPE_F64:
+        memcpy(buf, p, n * PACKED_NUMBER_SIZE);
+        break;
+
+    case PCVRNT_PACKED_TYPE_I64: {
+        int64_t i64s[NUMERIC_BLOCK_SIZE];
+        memcpy(i64s, p, n * PACKED_NUMBER_SIZE);
+        for (i = 0; i < n; i++)
+            buf[i] = (double)i64s[i];
+        break;
+    }
+
+    case PCVRNT_PACKED_TYPE_U64: {
+        uint64_t u64s[NUMERIC_BLOCK_SIZE];
+        memcpy(u64s, p, n * PACKED_NUMBER_SIZE);
+        for (i = 0; i < n; i++)
+            buf[i] = (double)u64s[i];
+        break;
+    }
+    }
+
+    return true;
+}
+
+/* the packed operands of the integer arithmetic are always longints */
+static bool
+fetch_longints(const struct numeric_src *src, size_t from, size_t n,
+        int64_t *buf)
+{
+    if (src->members)
+        return unbox_longints(src->members + from, n, buf);
+
+    assert(src->type == PCVRNT_PACKED_TYPE_I64);
+    memcpy(buf, src->bytes + from * PACKED_NUMBER_SIZE,
+            n * PACKED_NUMBER_SIZE);
+    return true;
+}
+
+static double
+kernel_sum(const double *a, size_t n)
+{
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        s0 += a[i];
+        s1 += a[i + 1];
+        s2 += a[i + 2];
+        s3 += a[i + 3];
+    }
+    for (; i < n; i++)
+        s0 += a[i];
+
+    return (s0 + s1) + (s2 + s3);
+}
+
+static double
+kernel_min(const double *a, size_t n, double m)
+{
+    double m0 = m, m1 = m, m2 = m, m3 = m;
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        m0 = a[i] < m0 ? a[i] : m0;
+        m1 = a[i + 1] < m1 ? a[i + 1] : m1;
+        m2 = a[i + 2] < m2 ? a[i + 2] : m2;
+        m3 = a[i + 3] < m3 ? a[i + 3] : m3;
+    }
+    for (; i < n; i++)
+        m0 = a[i] < m0 ? a[i] : m0;
+
+    m0 = m1 < m0 ? m1 : m0;
+    m2 = m3 < m2 ? m3 : m2;
+    return m2 < m0 ? m2 : m0;
+}
+
+static double
+kernel_max(const double *a, size_t n, double m)
+{
+    double m0 = m, m1 = m, m2 = m, m3 = m;
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        m0 = a[i] > m0 ? a[i] : m0;
+        m1 = a[i + 1] > m1 ? a[i + 1] : m1;
+        m2 = a[i + 2] > m2 ? a[i + 2] : m2;
+        m3 = a[i + 3] > m3 ? a[i + 3] : m3;
+    }
+    for (; i < n; i++)
+        m0 = a[i] > m0 ? a[i] : m0;
+
+    m0 = m1 > m0 ? m1 : m0;
+    m2 = m3 > m2 ? m3 : m2;
+    return m2 > m0 ? m2 : m0;
+}
+
+static double
+kernel_dot(const double *a, const double *b, size_t n)
+{
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        s0 += a[i] * b[i];
+        s1 += a[i + 1] * b[i + 1];
+        s2 += a[i + 2] * b[i + 2];
+        s3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < n; i++)
+        s0 += a[i] * b[i];
+
+    return (s0 + s1) + (s2 + s3);
+}
+
+static bool
+reduce_src(const struct numeric_src *src, pcvrnt_reduce_op_k op,
+        double *result)
+{
+    size_t sz = src->sz;
+
+    if (sz == 0) {
+        if (op != PCVRNT_REDUCE_OP_SUM) {
+            pcinst_set_error(PURC_ERROR_INVALID_VALUE);
+            return false;
+        }
+
+        *result = 0.0;
+        return true;
+    }
+
+    double buf[NUMERIC_BLOCK_SIZE];
+    double acc;
+    switch (op) {
+    case PCVRNT_REDUCE_OP_SUM:
+    case PCVRNT_REDUCE_OP_MEAN:
+        acc = 0.0;
+        break;
+    case PCVRNT_REDUCE_OP_MIN:
+        acc = INFINITY;
+        break;
+    case PCVRNT_REDUCE_OP_MAX:
+        acc = -INFINITY;
+        break;
+    default:
+        pcinst_set_error(PURC_ERROR_INVALID_VALUE);
+        return false;
+    }
+
+    for (size_t from = 0; from < sz; from += NUMERIC_BLOCK_SIZE) {
+        size_t n = sz - from;
+        if (n > NUMERIC_BLOCK_SIZE)
+            n = NUMERIC_BLOCK_SIZE;
+
+        if (!fetch_doubles(src, from, n, buf))
+            return false;
+
+        switch (op) {
+        case PCVRNT_REDUCE_OP_SUM:
+        case PCVRNT_REDUCE_OP_MEAN:
+            acc += kernel_sum(buf, n);
+            break;
+        case PCVRNT_REDUCE_OP_MIN:
+            acc = kernel_min(buf, n, acc);
+            break;
+        case PCVRNT_REDUCE_OP_MAX:
+            acc = kernel_max(buf, n, acc);
+            break;
+        }
+    }
+
+    if (op == PCVRNT_REDUCE_OP_MEAN)
+        acc /= (double)sz;
+
+    *result = acc;
+    return true;
+}
+
+bool
+purc_variant_numeric_reduce(purc_variant_t container,
+        pcvrnt_reduce_op_k op, double *result)
+{
+    struct numeric_src src;
+    if (!linear_src(container, &src)) {
+        pcinst_set_error(PURC_ERROR_WRONG_DATA_TYPE);
+        return false;
+    }
+
+    return reduce_src(&src, op, result);
+}
+
+bool
+purc_variant_packed_reduce(purc_variant_t packed, pcvrnt_packed_type_k type,
+        pcvrnt_reduce_op_k op, double *result)
+{
+    struct numeric_src src;
+    if (!packed_src(packed, type, &src))
+        return false;
+
+    return reduce_src(&src, op, result);
+}
+
+static bool
+dot_src(const struct numeric_src *src1, const struct numeric_src *src2,
+        double *result)
+{
+    if (src1->sz != src2->sz) {
+        pcinst_set_error(PURC_ERROR_INVALID_VALUE);
+        return false;
+    }
+
+    double buf1[NUMERIC_BLOCK_SIZE], buf2[NUMERIC_BLOCK_SIZE];
+    double acc = 0.0;
+    for (size_t from = 0; from < src1->sz; from += NUMERIC_BLOCK_SIZE) {
+        size_t n = src1->sz - from;
+        if (n > NUMERIC_BLOCK_SIZE)
+            n = NUMERIC_BLOCK_SIZE;
+
+        if (!fetch_doubles(src1, from, n, buf1) ||
+                !fetch_doubles(src2, from, n, buf2))
+            return false;
+
+        acc += kernel_dot(buf1, buf2, n);
+    }
+
+    *result = acc;
+    return true;
+}
+
+bool
+purc_variant_numeric_dot(purc_variant_t c1, purc_variant_t c2,
+        double *result)
+{
+    struct numeric_src src1, src2;
+    if (!linear_src(c1, &src1) || !linear_src(c2, &src2)) {
+        pcinst_set_error(PURC_ERROR_WRONG_DATA_TYPE);
+        return false;
+    }
+
+    return dot_src(&src1, &src2, result);
+}
+
+bool
+purc_variant_packed_dot(purc_variant_t p1, purc_variant_t p2,
+        pcvrnt_packed_type_k type, double *result)
+{
+    struct numeric_src src1, src2;
+    if (!packed_src(p1, type, &src1) || !packed_src(p2, type, &src2))
+        return false;
+
+    return dot_src(&src1, &src2, result);
+}
+
+static bool
+pack_number(purc_variant_t v, pcvrnt_packed_type_k type, unsigned char *p)
+{
+    bool ok = false;
+
+    switch (type) {
+    case PCVRNT_PACKED_TYPE_F64: {
+        double d;
+        if ((ok = purc_variant_cast_to_number(v, &d, false)))
+            memcpy(p, &d, sizeof(d));
+        break;
+    }
+
+    case PCVRNT_PACKED_TYPE_I64: {
+        int64_t i64;
+        if ((ok = purc_variant_cast_to_longint(v, &i64, false)))
+            memcpy(p, &i64, sizeof(i64));
+        break;
+    }
+
+    case PCVRNT_PACKED_TYPE_U64: {
+        uint64_t u64;
+        if ((ok = purc_variant_cast_to_ulongint(v, &u64, false)))
+            memcpy(p, &u64, sizeof(u64));
+        break;
+    }
+    }
+
+    return ok;
+}
+
+purc_variant_t
+purc_variant_make_packed_array(pcvrnt_packed_type_k type,
+        purc_variant_t container)
+{
+    struct numeric_src src;
+    if (!linear_src(container, &src)) {
+        pcinst_set_error(PURC_ERROR_WRONG_DATA_TYPE);
+        return PURC_VARIANT_INVALID;
+    }
+
+    if ((unsigned)type > PCVRNT_PACKED_TYPE_U64) {
+        pcinst_set_error(PURC_ERROR_INVALID_VALUE);
+        return PURC_VARIANT_INVALID;
+    }
+
+    if (src.sz == 0)
+        return purc_variant_make_byte_sequence_empty();
+
+    size_t nr_bytes = src.sz * PACKED_NUMBER_SIZE;
+    unsigned char *bytes = malloc(nr_bytes);
+    if (bytes == NULL) {
+        pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
+        return PURC_VARIANT_INVALID;
+    }
+
+    for (size_t i = 0; i < src.sz; i++) {
+        if (!pack_number(src.members[i], type,
+                    bytes + i * PACKED_NUMBER_SIZE)) {
+            free(bytes);
+            pcinst_set_error(PURC_ERROR_WRONG_DATA_TYPE);
+            return PURC_VARIANT_INVALID;
+        }
+    }
+
+    purc_variant_t packed = purc_variant_make_byte_sequence_reuse_buff(bytes,
+            nr_bytes, nr_bytes);
+    if (packed == PURC_VARIANT_INVALID)
+        free(bytes);
+    return packed;
+}
+
+purc_variant_t
+purc_variant_packed_array_get(purc_variant_t packed,
+        pcvrnt_packed_type_k type, size_t idx)
+{
+    struct numeric_src src;
+    if (!packed_src(packed, type, &src))
+        return PURC_VARIANT_INVALID;
+
+    if (idx >= src.sz) {
+        pcinst_set_error(PURC_ERROR_OVERFLOW);
+        return PURC_VARIANT_INVALID;
+    }
+
+    const unsigned char *p = src.bytes + idx * PACKED_NUMBER_SIZE;
+    switch (type) {
+    case PCVRNT_PACKED_TYPE_F64: {
+        double d;
+        memcpy(&d, p, sizeof(d));
+        return purc_variant_make_number(d);
+    }
+
+    case PCVRNT_PACKED_TYPE_I64: {
+        int64_t i64;
+        memcpy(&i64, p, sizeof(i64));
+        return purc_variant_make_longint(i64);
+    }
+
+    case PCVRNT_PACKED_TYPE_U64: {
+        uint64_t u64;
+        memcpy(&u64, p, sizeof(u64));
+        return purc_variant_make_ulongint(u64);
+    }
+    }
+
+    return PURC_VARIANT_INVALID;
+}
+
+/* returns false on a zero divisor or a negative exponent */
+static bool
+kernel_arith(int op, const int64_t *l, const int64_t *r, int64_t *res,
+        size_t n)
+{
+    size_t i;
+
+    switch (op) {
+    case '+':
+        for (i = 0; i < n; i++)
+            res[i] = l[i] + r[i];
+        break;
+
+    case '-':
+        for (i = 0; i < n; i++)
+            res[i] = l[i] - r[i];
+        break;
+
+    case '*':
+        for (i = 0; i < n; i++)
+            res[i] = l[i] * r[i];
+        break;
+
+    case '/':
+        for (i = 0; i < n; i++) {
+            if (r[i] == 0)
+                return false;
+            res[i] = l[i] / r[i];
+        }
+        break;
+
+    case '%':
+        for (i = 0; i < n; i++) {
+            if (r[i] == 0)
+                return false;
+            res[i] = l[i] % r[i];
+        }
+        break;
+
+    case '^':
+        for (i = 0; i < n; i++) {
+            int64_t e = r[i];
+            if (e < 0)
+                return false;
+
+            int64_t v = 1;
+            while (e) {
+                v *= l[i];
+                e--;
+            }
+            res[i] = v;
+        }
+        break;
+    }
+
+    return true;
+}
+
+/* fills the block with the numbers of the source or with the broadcast
+   scalar if there is no source */
+static bool
+operand_block(const struct numeric_src *src, int64_t scalar, size_t from,
+        size_t n, int64_t *buf)
+{
+    if (src)
+        return fetch_longints(src, from, n, buf);
+
+    for (size_t i = 0; i < n; i++)
+        buf[i] = scalar;
+    return true;
+}
+
+/* an operand of the arithmetic: a linear container, a packed array of
+   longints, or a scalar; returns the source or NULL for a scalar */
+static bool
+arith_operand(purc_variant_t v, struct numeric_src *src,
+        const struct numeric_src **srcp, int64_t *scalar)
+{
+    if (linear_src(v, src)) {
+        *srcp = src;
+        return true;
+    }
+
+    if (v->type == PURC_VARIANT_TYPE_BSEQUENCE) {
+        *srcp = src;
+        return packed_src(v, PCVRNT_PACKED_TYPE_I64, src);
+    }
+
+    *srcp = NULL;
+    if (!purc_variant_cast_to_longint(v, scalar, true)) {
+        pcinst_set_error(PURC_ERROR_WRONG_DATA_TYPE);
+        return false;
+    }
+    return true;
+}
+
+purc_variant_t
+pcvariant_numeric_arith(int op, purc_variant_t l, purc_variant_t r)
+{
+    struct numeric_src lbody, rbody;
+    const struct numeric_src *lsrc, *rsrc;
+    int64_t ls = 0, rs = 0;
+
+    switch (op) {
+    case '+': case '-': case '*': case '/': case '%': case '^':
+        break;
+    default:
+        pcinst_set_error(PURC_ERROR_INVALID_VALUE);
+        return PURC_VARIANT_INVALID;
+    }
+
+    if (!arith_operand(l, &lbody, &lsrc, &ls) ||
+            !arith_operand(r, &rbody, &rsrc, &rs))
+        return PURC_VARIANT_INVALID;
+
+    size_t sz;
+    if (lsrc && rsrc) {
+        if (lsrc->sz != rsrc->sz) {
+            pcinst_set_error(PURC_ERROR_INVALID_VALUE);
+            return PURC_VARIANT_INVALID;
+        }
+        sz = lsrc->sz;
+    }
+    else {
+        sz = lsrc ? lsrc->sz : rsrc->sz;
+    }
+
+    /* the result is packed as well if either operand is packed */
+    bool packed = (lsrc && lsrc->bytes) || (rsrc && rsrc->bytes);
+    unsigned char *bytes = NULL;
+    purc_variant_t arr = PURC_VARIANT_INVALID;
+    if (packed) {
+        if (sz == 0)
+            return purc_variant_make_byte_sequence_empty();
+
+        bytes = malloc(sz * PACKED_NUMBER_SIZE);
+        if (bytes == NULL) {
+            pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
+            return PURC_VARIANT_INVALID;
+        }
+    }
+    else {
+        arr = pcvar_make_arr();
+        if (arr == PURC_VARIANT_INVALID)
+            return PURC_VARIANT_INVALID;
+    }
+
+    int64_t lbuf[NUMERIC_BLOCK_SIZE], rbuf[NUMERIC_BLOCK_SIZE];
+    int64_t res[NUMERIC_BLOCK_SIZE];
+    for (size_t from = 0; from < sz; from += NUMERIC_BLOCK_SIZE) {
+        size_t n = sz - from;
+        if (n > NUMERIC_BLOCK_SIZE)
+            n = NUMERIC_BLOCK_SIZE;
+
+        if (!operand_block(lsrc, ls, from, n, lbuf) ||
+                !operand_block(rsrc, rs, from, n, rbuf))
+            goto failed;
+
+        if (!kernel_arith(op, lbuf, rbuf, res, n)) {
+            pcinst_set_error(PURC_ERROR_INVALID_VALUE);
+            goto failed;
+        }
+
+        if (packed) {
+            memcpy(bytes + from * PACKED_NUMBER_SIZE, res,
+                    n * PACKED_NUMBER_SIZE);
+            continue;
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            purc_variant_t v = purc_variant_make_longint(res[i]);
+            if (v == PURC_VARIANT_INVALID)
+                goto failed;
+
+            int ret = pcvar_arr_append(arr, v);
+            purc_variant_unref(v);
+            if (ret)
+                goto failed;
+        }
+    }
+
+    if (packed) {
+        arr = purc_variant_make_byte_sequence_reuse_buff(bytes,
+                sz * PACKED_NUMBER_SIZE, sz * PACKED_NUMBER_SIZE);
+        if (arr == PURC_VARIANT_INVALID)
+            free(bytes);
+    }
+
+    return arr;
+
+failed:
+    if (arr)
+        purc_variant_unref(arr);
+    free(bytes);
+    return PURC_VARIANT_INVALID;
+}
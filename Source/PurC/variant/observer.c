@@ -36,6 +36,12 @@ register_listener(purc_variant_t v, unsigned int flags,
     struct list_head *listeners;
     listeners = &v->listeners;
 
+    /* a frozen variant never changes and may be shared among instances */
+    if (v->flags & PCVRNT_FLAG_FROZEN) {
+        pcinst_set_error(PURC_ERROR_NOT_ALLOWED);
+        return NULL;
+    }
+
     struct pcvar_listener *listener;
     listener = (struct pcvar_listener*)calloc(1, sizeof(*listener));
     if (!listener) {
@@ -143,6 +149,11 @@ bool pcvariant_on_pre_fired(
     op &= PCVAR_OPERATION_ALL;
     PC_ASSERT(op != PCVAR_OPERATION_ALL);
 
+    if (source->flags & PCVRNT_FLAG_FROZEN) {
+        pcinst_set_error(PURC_ERROR_NOT_ALLOWED);
+        return false;
+    }
+
     struct list_head *listeners;
     listeners = &source->listeners;
 
@@ -196,6 +207,9 @@ void
 pcvar_break_rue_downward(purc_variant_t val)
 {
     PC_ASSERT(val != PURC_VARIANT_INVALID);
+    if (val->flags & PCVRNT_FLAG_FROZEN)
+        return;
+
     switch (val->type) {
         case PURC_VARIANT_TYPE_ARRAY:
             if (pcvar_container_belongs_to_set(val))
@@ -237,7 +251,8 @@ pcvar_break_edge_to_parent(purc_variant_t val,
         struct pcvar_rev_update_edge *edge)
 {
     PC_ASSERT(val != PURC_VARIANT_INVALID);
-    if (pcvariant_is_mutable(val) == false)
+    if (pcvariant_is_mutable(val) == false ||
+            (val->flags & PCVRNT_FLAG_FROZEN))
         return;
 
     switch (val->type) {
@@ -262,6 +277,9 @@ int
 pcvar_build_rue_downward(purc_variant_t val)
 {
     PC_ASSERT(val != PURC_VARIANT_INVALID);
+    if (val->flags & PCVRNT_FLAG_FROZEN)
+        return 0;
+
     switch (val->type) {
         case PURC_VARIANT_TYPE_ARRAY:
             return pcvar_array_build_rue_downward(val);
@@ -297,7 +315,8 @@ pcvar_build_edge_to_parent(purc_variant_t val,
         struct pcvar_rev_update_edge *edge)
 {
     PC_ASSERT(val != PURC_VARIANT_INVALID);
-    if (pcvariant_is_mutable(val) == false)
+    if (pcvariant_is_mutable(val) == false ||
+            (val->flags & PCVRNT_FLAG_FROZEN))
         return 0;
 
     switch (val->type) {
@@ -22,6 +22,7 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+
 #define _GNU_SOURCE
 
 #include "config.h"
@@ -36,11 +37,17 @@
 #include <stdlib.h>
 #include <string.h>
 
+#define ARR_MIN_SZ_MEMBERS      8
+
+/* the token locating a member in the reverse update chain of the member */
+struct arr_node {
+    purc_variant_t   val;
+};
+
 static size_t
 variant_arr_length(variant_arr_t data)
 {
-    struct pcutils_array_list *al = &data->al;
-    return pcutils_array_list_length(al);
+    return data->nr_members;
 }
 
 static inline bool
@@ -129,95 +136,110 @@ pcvar_arr_get_data(purc_variant_t arr)
     return (variant_arr_t)arr->sz_ptr[1];
 }
 
-static void
-break_rev_update_chain(purc_variant_t arr, struct arr_node *node)
+/* makes room for `count` members with an amortized growth */
+static int
+variant_arr_reserve(variant_arr_t data, size_t count)
 {
-    struct pcvar_rev_update_edge edge = {
-        .parent        = arr,
-        .arr_me        = node,
-    };
+    if (count <= data->sz_members)
+        return 0;
 
-    pcvar_break_edge_to_parent(node->val, &edge);
-    pcvar_break_rue_downward(node->val);
-}
+    size_t sz = data->sz_members ? data->sz_members : ARR_MIN_SZ_MEMBERS;
+    while (sz < count)
+        sz *= 2;
 
-static void
-arr_node_release(purc_variant_t arr, struct arr_node *node)
-{
-    if (!node)
-        return;
+    purc_variant_t *members;
+    members = (purc_variant_t*)realloc(data->members, sz * sizeof(*members));
+    if (!members) {
+        pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
+        return -1;
+    }
+    data->members = members;
 
-    break_rev_update_chain(arr, node);
+    if (data->edges) {
+        struct arr_node **edges;
+        edges = (struct arr_node**)realloc(data->edges, sz * sizeof(*edges));
+        if (!edges) {
+            pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
+            return -1;
+        }
+        data->edges = edges;
+    }
 
-    if (node->node.idx != (size_t)-1) {
-        variant_arr_t data = pcvar_arr_get_data(arr);
-        PC_ASSERT(data);
+    data->sz_members = sz;
+    return 0;
+}
 
-        struct pcutils_array_list *al = &data->al;
-        PC_ASSERT(al);
+static struct arr_node*
+edge_token(variant_arr_t data, size_t idx)
+{
+    if (!data->edges) {
+        data->edges = (struct arr_node**)calloc(data->sz_members,
+                sizeof(*data->edges));
+        if (!data->edges) {
+            pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
+            return NULL;
+        }
+    }
 
-        struct pcutils_array_list_node *p;
-        int r = pcutils_array_list_remove(al, node->node.idx, &p);
-        PC_ASSERT(r == 0);
-        PC_ASSERT(&node->node == p);
-        PC_ASSERT(node->node.idx == (size_t)-1);
+    struct arr_node *node = data->edges[idx];
+    if (!node) {
+        node = (struct arr_node*)pcvariant_cache_alloc(sizeof(*node));
+        if (!node) {
+            pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
+            return NULL;
+        }
+        data->edges[idx] = node;
     }
 
-    PURC_VARIANT_SAFE_CLEAR(node->val);
+    node->val = data->members[idx];
+    return node;
 }
 
 static void
-arr_node_destroy(purc_variant_t arr, struct arr_node *node)
+release_edges(variant_arr_t data)
 {
-    if (!node)
+    if (!data->edges)
         return;
 
-    arr_node_release(arr, node);
-    free(node);
+    for (size_t i = 0; i < data->nr_members; i++)
+        pcvariant_cache_free(data->edges[i], sizeof(struct arr_node));
+    free(data->edges);
+    data->edges = NULL;
 }
 
-static purc_variant_t
-variant_arr_make_pos(variant_arr_t data, size_t idx)
+static void
+break_rev_update_chain(purc_variant_t arr, size_t idx)
 {
-    size_t len = variant_arr_length(data);
-    if (idx > len)
-        idx = len;
+    variant_arr_t data = pcvar_arr_get_data(arr);
+    purc_variant_t val = data->members[idx];
 
-    return purc_variant_make_longint(idx);
-}
+    struct arr_node *node = data->edges ? data->edges[idx] : NULL;
+    if (node) {
+        struct pcvar_rev_update_edge edge = {
+            .parent        = arr,
+            .arr_me        = node,
+        };
 
-static struct arr_node*
-arr_node_create(purc_variant_t val)
-{
-    struct arr_node *node;
-    node = (struct arr_node*)calloc(1, sizeof(*node));
-    if (!node) {
-        pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
-        return NULL;
+        pcvar_break_edge_to_parent(val, &edge);
     }
 
-    node->node.idx = (size_t)-1;
-
-    node->val = val;
-    purc_variant_ref(val);
-
-    return node;
+    pcvar_break_rue_downward(val);
 }
 
 static int
-build_rev_update_chain(purc_variant_t arr, struct arr_node *node)
+build_edge(purc_variant_t arr, size_t idx)
 {
-    if (!pcvar_container_belongs_to_set(arr))
-        return 0;
-
-    int r;
+    variant_arr_t data = pcvar_arr_get_data(arr);
+    struct arr_node *node = edge_token(data, idx);
+    if (!node)
+        return -1;
 
     struct pcvar_rev_update_edge edge = {
         .parent        = arr,
         .arr_me        = node,
     };
 
-    r = pcvar_build_edge_to_parent(node->val, &edge);
+    int r = pcvar_build_edge_to_parent(node->val, &edge);
     if (r == 0) {
         r = pcvar_build_rue_downward(node->val);
     }
@@ -225,6 +247,46 @@ build_rev_update_chain(purc_variant_t arr, struct arr_node *node)
     return r ? -1 : 0;
 }
 
+static int
+build_rev_update_chain(purc_variant_t arr, size_t idx)
+{
+    if (!pcvar_container_belongs_to_set(arr))
+        return 0;
+
+    return build_edge(arr, idx);
+}
+
+/* takes the member at idx out of the array; the caller owns the reference */
+static purc_variant_t
+variant_arr_take(variant_arr_t data, size_t idx)
+{
+    PC_ASSERT(idx < data->nr_members);
+
+    purc_variant_t val = data->members[idx];
+    size_t nr_moved = data->nr_members - idx - 1;
+
+    memmove(data->members + idx, data->members + idx + 1,
+            nr_moved * sizeof(*data->members));
+    if (data->edges) {
+        pcvariant_cache_free(data->edges[idx], sizeof(struct arr_node));
+        memmove(data->edges + idx, data->edges + idx + 1,
+                nr_moved * sizeof(*data->edges));
+    }
+
+    data->nr_members--;
+    return val;
+}
+
+static purc_variant_t
+variant_arr_make_pos(variant_arr_t data, size_t idx)
+{
+    size_t len = variant_arr_length(data);
+    if (idx > len)
+        idx = len;
+
+    return purc_variant_make_longint(idx);
+}
+
 static int
 check_grow(purc_variant_t arr, size_t idx, purc_variant_t val)
 {
@@ -280,10 +342,7 @@ variant_arr_insert_before(purc_variant_t arr, size_t idx, purc_variant_t val,
     variant_arr_t data = pcvar_arr_get_data(arr);
     PC_ASSERT(data);
 
-    struct pcutils_array_list *al = &data->al;
-    PC_ASSERT(al);
-
-    size_t nr = pcutils_array_list_length(al);
+    size_t nr = variant_arr_length(data);
     if (idx > nr)
         idx = nr;
 
@@ -291,7 +350,7 @@ variant_arr_insert_before(purc_variant_t arr, size_t idx, purc_variant_t val,
     if (pos == PURC_VARIANT_INVALID)
         return -1;
 
-    struct arr_node *node = NULL;
+    bool inserted = false;
 
     do {
         if (check) {
@@ -302,22 +361,22 @@ variant_arr_insert_before(purc_variant_t arr, size_t idx, purc_variant_t val,
                 break;
         }
 
-        node = arr_node_create(val);
-        if (!node)
+        if (variant_arr_reserve(data, nr + 1))
             break;
 
-        int r;
-        PC_ASSERT(node->node.idx == (size_t)-1);
-        r = pcutils_array_list_insert_before(al, idx, &node->node);
-        if (r) {
-            PC_ASSERT(node->node.idx == (size_t)-1);
-            purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
-            break;
+        memmove(data->members + idx + 1, data->members + idx,
+                (nr - idx) * sizeof(*data->members));
+        data->members[idx] = purc_variant_ref(val);
+        if (data->edges) {
+            memmove(data->edges + idx + 1, data->edges + idx,
+                    (nr - idx) * sizeof(*data->edges));
+            data->edges[idx] = NULL;
         }
-        PC_ASSERT(node->node.idx != (size_t)-1);
+        data->nr_members++;
+        inserted = true;
 
         if (check) {
-            if (build_rev_update_chain(arr, node))
+            if (build_rev_update_chain(arr, idx))
                 break;
 
             pcvar_adjust_set_by_descendant(arr);
@@ -329,7 +388,10 @@ variant_arr_insert_before(purc_variant_t arr, size_t idx, purc_variant_t val,
         return 0;
     } while (0);
 
-    arr_node_destroy(arr, node);
+    if (inserted) {
+        break_rev_update_chain(arr, idx);
+        purc_variant_unref(variant_arr_take(data, idx));
+    }
     purc_variant_unref(pos);
 
     return -1;
@@ -342,9 +404,11 @@ refresh_extra(purc_variant_t arr)
     variant_arr_t data = pcvar_arr_get_data(arr);
     if (data) {
         extra += sizeof(*data);
-        struct pcutils_array_list *al = &data->al;
-        extra += al->sz * sizeof(*al->nodes);
-        extra += al->nr * sizeof(struct arr_node);
+        extra += data->sz_members * sizeof(*data->members);
+        if (data->edges) {
+            extra += data->sz_members * sizeof(*data->edges);
+            extra += data->nr_members * sizeof(struct arr_node);
+        }
     }
     pcvariant_stat_set_extra_size(arr, extra);
 }
@@ -354,8 +418,7 @@ variant_arr_append(purc_variant_t arr, purc_variant_t val,
         bool check)
 {
     variant_arr_t data = pcvar_arr_get_data(arr);
-    struct pcutils_array_list *al = &data->al;
-    size_t nr = pcutils_array_list_length(al);
+    size_t nr = variant_arr_length(data);
     int r = variant_arr_insert_before(arr, nr, val, check);
     refresh_extra(arr);
     return r ? -1 : 0;
@@ -371,19 +434,14 @@ variant_arr_prepend(purc_variant_t arr, purc_variant_t val,
 static purc_variant_t
 variant_arr_get(variant_arr_t data, size_t idx)
 {
-    struct pcutils_array_list *al = &data->al;
-    struct pcutils_array_list_node *p;
-    p = pcutils_array_list_get(al, idx);
-    if (p == NULL)
+    if (idx >= data->nr_members)
         return PURC_VARIANT_INVALID;
 
-    struct arr_node *node;
-    node = (struct arr_node*)container_of(p, struct arr_node, node);
-    return node->val;
+    return data->members[idx];
 }
 
 static int
-check_change(purc_variant_t arr, struct arr_node *node, purc_variant_t val)
+check_change(purc_variant_t arr, size_t idx, purc_variant_t val)
 {
     if (!pcvar_container_belongs_to_set(arr))
         return 0;
@@ -398,10 +456,10 @@ check_change(purc_variant_t arr, struct arr_node *node, purc_variant_t val)
         size_t i;
         purc_variant_t v;
         foreach_value_in_variant_array(arr, v, i) {
-            if (i == node->node.idx) {
+            if (i == idx) {
                 found = true;
             }
-            r = pcvar_arr_append(_new, i == node->node.idx ? val : v);
+            r = pcvar_arr_append(_new, i == idx ? val : v);
             if (r)
                 break;
         } end_foreach;
@@ -431,23 +489,15 @@ variant_arr_set(purc_variant_t arr, size_t idx, purc_variant_t val,
     variant_arr_t data = pcvar_arr_get_data(arr);
     PC_ASSERT(data);
 
-    struct pcutils_array_list *al = &data->al;
-    PC_ASSERT(al);
-
-    size_t nr = pcutils_array_list_length(al);
+    size_t nr = variant_arr_length(data);
     if (idx >= nr) {
         purc_set_error(PURC_ERROR_OVERFLOW);
         return -1;
     }
 
-    struct pcutils_array_list_node *p;
-    p = pcutils_array_list_get(al, idx);
-    PC_ASSERT(p);
-
-    struct arr_node *old_node;
-    old_node = (struct arr_node*)container_of(p, struct arr_node, node);
-    PC_ASSERT(old_node->val != PURC_VARIANT_INVALID);
-    if (old_node->val == val) {
+    purc_variant_t old = data->members[idx];
+    PC_ASSERT(old != PURC_VARIANT_INVALID);
+    if (old == val) {
         // NOTE: keep refc intact
         return 0;
     }
@@ -457,28 +507,28 @@ variant_arr_set(purc_variant_t arr, size_t idx, purc_variant_t val,
         return -1;
 
     do {
-        purc_variant_t old = old_node->val;
-
         if (check) {
             if (!change(arr, pos, old, val, check))
                 break;
 
-            if (check_change(arr, old_node, val))
+            if (check_change(arr, idx, val))
                 break;
 
-            old_node->val = val;
+            data->members[idx] = val;
 
-            if (build_rev_update_chain(arr, old_node)) {
-                break_rev_update_chain(arr, old_node);
-                old_node->val = old;
+            if (build_rev_update_chain(arr, idx)) {
+                break_rev_update_chain(arr, idx);
+                data->members[idx] = old;
                 break;
             }
 
-            old_node->val = old;
-            break_rev_update_chain(arr, old_node);
+            data->members[idx] = old;
+            break_rev_update_chain(arr, idx);
         }
 
-        old_node->val = purc_variant_ref(val);
+        data->members[idx] = purc_variant_ref(val);
+        if (data->edges && data->edges[idx])
+            data->edges[idx]->val = val;
 
         if (check) {
             pcvar_adjust_set_by_descendant(arr);
@@ -492,13 +542,15 @@ variant_arr_set(purc_variant_t arr, size_t idx, purc_variant_t val,
         return 0;
     } while (0);
 
+    if (data->edges && data->edges[idx])
+        data->edges[idx]->val = data->members[idx];
     purc_variant_unref(pos);
 
     return -1;
 }
 
 static int
-check_shrink(purc_variant_t arr, struct arr_node *node)
+check_shrink(purc_variant_t arr, size_t idx)
 {
     if (!pcvar_container_belongs_to_set(arr))
         return 0;
@@ -513,7 +565,7 @@ check_shrink(purc_variant_t arr, struct arr_node *node)
         size_t i;
         purc_variant_t v;
         foreach_value_in_variant_array(arr, v, i) {
-            if (i == node->node.idx) {
+            if (i == idx) {
                 PC_ASSERT(!found);
                 found = true;
                 continue;
@@ -548,10 +600,7 @@ variant_arr_remove(purc_variant_t arr, size_t idx,
     variant_arr_t data = pcvar_arr_get_data(arr);
     PC_ASSERT(data);
 
-    struct pcutils_array_list *al = &data->al;
-    PC_ASSERT(al);
-
-    size_t nr = pcutils_array_list_length(al);
+    size_t nr = variant_arr_length(data);
     if (idx >= nr) {
         // FIXME: failure or success???
         return 0;
@@ -561,38 +610,28 @@ variant_arr_remove(purc_variant_t arr, size_t idx,
     if (pos == PURC_VARIANT_INVALID)
         return -1;
 
-    struct pcutils_array_list_node *p, *n;
-    p = pcutils_array_list_get(al, idx);
-    PC_ASSERT(p);
-
-    struct arr_node *node;
-    node = (struct arr_node*)container_of(p, struct arr_node, node);
-    PC_ASSERT(node->val);
+    purc_variant_t val = data->members[idx];
+    PC_ASSERT(val);
 
     do {
         if (check) {
-            if (!shrink(arr, pos, node->val, check))
+            if (!shrink(arr, pos, val, check))
                 break;
 
-            if (check_shrink(arr, node))
+            if (check_shrink(arr, idx))
                 break;
-
-            break_rev_update_chain(arr, node);
         }
 
-        PC_ASSERT(node->node.idx != (size_t)-1);
-        int r = pcutils_array_list_remove(al, idx, &n);
-        PC_ASSERT(r == 0);
-        PC_ASSERT(&node->node == n);
-        PC_ASSERT(node->node.idx == (size_t)-1);
+        break_rev_update_chain(arr, idx);
+        variant_arr_take(data, idx);
 
         if (check) {
             pcvar_adjust_set_by_descendant(arr);
 
-            shrunk(arr, pos, node->val, check);
+            shrunk(arr, pos, val, check);
         }
 
-        arr_node_destroy(arr, node);
+        purc_variant_unref(val);
         purc_variant_unref(pos);
 
         return 0;
@@ -610,20 +649,20 @@ array_release (purc_variant_t arr)
     if (!data)
         return;
 
-    struct pcutils_array_list *al = &data->al;
-    struct arr_node *p, *n;
-    array_list_for_each_entry_reverse_safe(al, p, n, node) {
-        arr_node_destroy(arr, p);
-    };
+    for (size_t i = data->nr_members; i > 0; i--) {
+        break_rev_update_chain(arr, i - 1);
+        purc_variant_unref(variant_arr_take(data, i - 1));
+    }
 
-    pcutils_array_list_reset(al);
+    free(data->members);
+    free(data->edges);
 
     if (data->rev_update_chain) {
         pcvar_destroy_rev_update_chain(data->rev_update_chain);
         data->rev_update_chain = NULL;
     }
 
-    free(data);
+    pcvariant_cache_free(data, sizeof(*data));
     arr->sz_ptr[1] = (uintptr_t)NULL;
 
     pcvariant_stat_set_extra_size(arr, 0);
@@ -642,23 +681,16 @@ make_array(size_t sz)
         var->flags         = PCVRNT_FLAG_EXTRA_SIZE;
         var->refc          = 1;
 
-        size_t initial_size = ARRAY_LIST_DEFAULT_SIZE;
-        if (sz>initial_size)
-            initial_size = sz;
-
-        variant_arr_t data = (variant_arr_t)calloc(1, sizeof(*data));
+        variant_arr_t data;
+        data = (variant_arr_t)pcvariant_cache_alloc_0(sizeof(*data));
         if (!data) {
             pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
             break;
         }
 
-        struct pcutils_array_list *al;
-        al = &data->al;
-        pcutils_array_list_init(al);
-        if (pcutils_array_list_expand(al, initial_size)) {
-            pcutils_array_list_reset(al);
-            free(data);
-            pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
+        /* the storage of an empty array is allocated on demand */
+        if (variant_arr_reserve(data, sz)) {
+            pcvariant_cache_free(data, sizeof(*data));
             break;
         }
 
@@ -689,6 +721,17 @@ pcvar_arr_append(purc_variant_t arr, purc_variant_t val)
     return variant_arr_append(arr, val, check);
 }
 
+void
+pcvar_arr_replace_member(purc_variant_t arr, size_t idx, purc_variant_t val)
+{
+    variant_arr_t data = pcvar_arr_get_data(arr);
+    PC_ASSERT(idx < data->nr_members);
+
+    data->members[idx] = val;
+    if (data->edges && data->edges[idx])
+        data->edges[idx]->val = val;
+}
+
 static purc_variant_t
 pv_make_array_n (bool check, size_t sz, purc_variant_t value0, va_list ap)
 {
@@ -870,16 +913,32 @@ struct arr_user_data {
     void *ud;
 };
 
-static int
-sort_cmp(struct pcutils_array_list_node *l, struct pcutils_array_list_node *r,
-        void *ud)
+/* the members are sorted through their edge tokens if there are any,
+   so that the tokens move along with the members */
+static inline purc_variant_t
+sort_item_val(const void *p, bool by_edges)
 {
-    struct arr_node *l_n, *r_n;
-    l_n = container_of(l, struct arr_node, node);
-    r_n = container_of(r, struct arr_node, node);
+    if (by_edges)
+        return (*(struct arr_node* const*)p)->val;
+    return *(const purc_variant_t*)p;
+}
 
-    struct arr_user_data *d = (struct arr_user_data*)ud;
-    return d->cmp(l_n->val, r_n->val, d->ud);
+struct arr_sort_data {
+    struct arr_user_data     *d;
+    bool                      by_edges;
+};
+
+#if OS(HURD) || OS(LINUX)
+static int sort_cmp(const void *l, const void *r, void *ud)
+#elif OS(DARWIN) || OS(FREEBSD) || OS(NETBSD) || OS(OPENBSD) || OS(WINDOWS)
+static int sort_cmp(void *ud, const void *l, const void *r)
+#else
+#error Unsupported operating system.
+#endif
+{
+    struct arr_sort_data *sd = (struct arr_sort_data*)ud;
+    return sd->d->cmp(sort_item_val(l, sd->by_edges),
+            sort_item_val(r, sd->by_edges), sd->d->ud);
 }
 
 static int vrtcmp(purc_variant_t l, purc_variant_t r, void *ud)
@@ -902,6 +961,11 @@ int pcvariant_array_sort(purc_variant_t arr, void *ud,
     if (!arr || arr->type != PURC_VARIANT_TYPE_ARRAY)
         return -1;
 
+    if (arr->flags & PCVRNT_FLAG_FROZEN) {
+        pcinst_set_error(PURC_ERROR_ACCESS_DENIED);
+        return -1;
+    }
+
     variant_arr_t data = pcvar_arr_get_data(arr);
 
     struct arr_user_data d = {
@@ -913,7 +977,63 @@ int pcvariant_array_sort(purc_variant_t arr, void *ud,
         d.cmp = vrtcmp;
     }
 
-    pcutils_array_list_sort(&data->al, &d, sort_cmp);
+    struct arr_sort_data sd = {
+        .d        = &d,
+        .by_edges = false,
+    };
+
+    void *base = data->members;
+    size_t sz_item = sizeof(*data->members);
+    if (data->edges) {
+        for (size_t i = 0; i < data->nr_members; i++) {
+            if (!edge_token(data, i))
+                return -1;
+        }
+
+        sd.by_edges = true;
+        base = data->edges;
+        sz_item = sizeof(*data->edges);
+    }
+
+#if OS(HURD) || OS(LINUX)
+    qsort_r(base, data->nr_members, sz_item, sort_cmp, &sd);
+#elif OS(DARWIN) || OS(FREEBSD) || OS(NETBSD) || OS(OPENBSD)
+    qsort_r(base, data->nr_members, sz_item, &sd, sort_cmp);
+#elif OS(WINDOWS)
+    qsort_s(base, data->nr_members, sz_item, sort_cmp, &sd);
+#endif
+
+    if (sd.by_edges) {
+        for (size_t i = 0; i < data->nr_members; i++)
+            data->members[i] = data->edges[i]->val;
+    }
+
+    return 0;
+}
+
+int pcvariant_array_swap(purc_variant_t arr, size_t i, size_t j)
+{
+    if (!arr || arr->type != PURC_VARIANT_TYPE_ARRAY)
+        return -1;
+
+    if (arr->flags & PCVRNT_FLAG_FROZEN) {
+        pcinst_set_error(PURC_ERROR_ACCESS_DENIED);
+        return -1;
+    }
+
+    variant_arr_t data = pcvar_arr_get_data(arr);
+    if (i >= data->nr_members || j >= data->nr_members)
+        return -1;
+
+    purc_variant_t v = data->members[i];
+    data->members[i] = data->members[j];
+    data->members[j] = v;
+
+    if (data->edges) {
+        struct arr_node *node = data->edges[i];
+        data->edges[i] = data->edges[j];
+        data->edges[j] = node;
+    }
 
     return 0;
 }
@@ -921,8 +1041,10 @@ int pcvariant_array_sort(purc_variant_t arr, void *ud,
 purc_variant_t
 pcvariant_array_clone(purc_variant_t arr, bool recursively)
 {
+    variant_arr_t data = pcvar_arr_get_data(arr);
+
     purc_variant_t var;
-    var = purc_variant_make_array(0, PURC_VARIANT_INVALID);
+    var = make_array(data->nr_members);
     if (var == PURC_VARIANT_INVALID)
         return PURC_VARIANT_INVALID;
 
@@ -963,15 +1085,13 @@ pcvar_array_break_rue_downward(purc_variant_t arr)
     if (!data)
         return;
 
-    struct arr_node *p;
-    foreach_in_variant_array(arr, p) {
-        struct pcvar_rev_update_edge edge = {
-            .parent         = arr,
-            .arr_me         = p,
-        };
-        pcvar_break_edge_to_parent(p->val, &edge);
-        pcvar_break_rue_downward(p->val);
+    for (size_t i = 0; i < data->nr_members; i++) {
+        break_rev_update_chain(arr, i);
     }
+
+    /* the array does not belong to a set any more */
+    release_edges(data);
+    refresh_extra(arr);
 }
 
 void
@@ -998,20 +1118,12 @@ pcvar_array_build_rue_downward(purc_variant_t arr)
     if (!data)
         return 0;
 
-    struct arr_node *p;
-    foreach_in_variant_array(arr, p) {
-        struct pcvar_rev_update_edge edge = {
-            .parent         = arr,
-            .arr_me         = p,
-        };
-        int r = pcvar_build_edge_to_parent(p->val, &edge);
-        if (r)
-            return -1;
-        r = pcvar_build_rue_downward(p->val);
-        if (r)
+    for (size_t i = 0; i < data->nr_members; i++) {
+        if (build_edge(arr, i))
             return -1;
     }
 
+    refresh_extra(arr);
     return 0;
 }
 
@@ -1042,67 +1154,27 @@ pcvar_array_build_edge_to_parent(purc_variant_t arr,
     return r ? -1 : 0;
 }
 
-static struct pcutils_array_list_node*
-next_node(struct pcutils_array_list *al, struct pcutils_array_list_node *node)
-{
-    if (!node)
-        return NULL;
-    size_t count = pcutils_array_list_length(al);
-    size_t idx = node->idx + 1;
-    if (idx >= count)
-        return NULL;
-
-    return pcutils_array_list_get(al, idx);
-}
-
-static struct pcutils_array_list_node*
-prev_node(struct pcutils_array_list *al, struct pcutils_array_list_node *node)
+static void
+it_refresh(struct arr_iterator *it, size_t idx)
 {
-    if (!node)
-        return NULL;
-    if (node->idx == 0)
-        return NULL;
-
-    size_t count = pcutils_array_list_length(al);
-    size_t idx = node->idx - 1;
-    if (idx >= count)
-        return NULL;
-
-    return pcutils_array_list_get(al, idx);
+    variant_arr_t data = pcvar_arr_get_data(it->arr);
+    purc_variant_t *members = data->members;
+    size_t sz = data->nr_members;
+
+    it->nr_members = sz;
+    it->idx = idx;
+    it->curr = members[idx];
+    it->prev = idx > 0 ? members[idx - 1] : PURC_VARIANT_INVALID;
+    it->next = idx < sz - 1 ? members[idx + 1] : PURC_VARIANT_INVALID;
 }
 
 static void
-it_refresh(struct arr_iterator *it,
-        struct pcutils_array_list *al,
-        struct pcutils_array_list_node *curr)
+it_end(struct arr_iterator *it)
 {
-    struct pcutils_array_list_node *next  = NULL;
-    struct pcutils_array_list_node *prev  = NULL;
-    if (curr) {
-        next  = next_node(al, curr);
-        prev  = prev_node(al, curr);
-    }
-
-    if (curr) {
-        it->curr = container_of(curr, struct arr_node, node);
-    }
-    else {
-        it->curr = NULL;
-    }
-
-    if (next) {
-        it->next = container_of(next, struct arr_node, node);
-    }
-    else {
-        it->next = NULL;
-    }
-
-    if (prev) {
-        it->prev = container_of(prev, struct arr_node, node);
-    }
-    else {
-        it->prev = NULL;
-    }
+    it->idx = -1;
+    it->curr = PURC_VARIANT_INVALID;
+    it->next = PURC_VARIANT_INVALID;
+    it->prev = PURC_VARIANT_INVALID;
 }
 
 struct arr_iterator
@@ -1110,6 +1182,11 @@ pcvar_arr_it_first(purc_variant_t arr)
 {
     struct arr_iterator it = {
         .arr         = arr,
+        .nr_members  = 0,
+        .idx         = -1,
+        .curr        = PURC_VARIANT_INVALID,
+        .next        = PURC_VARIANT_INVALID,
+        .prev        = PURC_VARIANT_INVALID,
     };
     if (arr == PURC_VARIANT_INVALID)
         return it;
@@ -1119,12 +1196,7 @@ pcvar_arr_it_first(purc_variant_t arr)
     if (count == 0)
         return it;
 
-    struct pcutils_array_list *al = &data->al;
-
-    struct pcutils_array_list_node *first;
-    first = pcutils_array_list_get_first(al);
-
-    it_refresh(&it, al, first);
+    it_refresh(&it, 0);
 
     return it;
 }
@@ -1134,6 +1206,11 @@ pcvar_arr_it_last(purc_variant_t arr)
 {
     struct arr_iterator it = {
         .arr         = arr,
+        .nr_members  = 0,
+        .idx         = -1,
+        .curr        = PURC_VARIANT_INVALID,
+        .next        = PURC_VARIANT_INVALID,
+        .prev        = PURC_VARIANT_INVALID,
     };
     if (arr == PURC_VARIANT_INVALID)
         return it;
@@ -1143,12 +1220,7 @@ pcvar_arr_it_last(purc_variant_t arr)
     if (count == 0)
         return it;
 
-    struct pcutils_array_list *al = &data->al;
-
-    struct pcutils_array_list_node *last;
-    last = pcutils_array_list_get_last(al);
-
-    it_refresh(&it, al, last);
+    it_refresh(&it, count - 1);
 
     return it;
 }
@@ -1156,45 +1228,30 @@ pcvar_arr_it_last(purc_variant_t arr)
 void
 pcvar_arr_it_next(struct arr_iterator *it)
 {
-    if (it->curr == NULL)
+    if (it->curr == PURC_VARIANT_INVALID)
         return;
 
-    if (it->next) {
-        variant_arr_t data = pcvar_arr_get_data(it->arr);
-        struct pcutils_array_list *al = &data->al;
-
-        struct pcutils_array_list_node *next;
-        next = &it->next->node;
-
-        it_refresh(it, al, next);
+    variant_arr_t data = pcvar_arr_get_data(it->arr);
+    size_t idx = it->idx + 1;
+    if (idx < variant_arr_length(data)) {
+        it_refresh(it, idx);
     }
     else {
-        it->curr = NULL;
-        it->next = NULL;
-        it->prev = NULL;
+        it_end(it);
     }
 }
 
 void
 pcvar_arr_it_prev(struct arr_iterator *it)
 {
-    if (it->curr == NULL)
+    if (it->curr == PURC_VARIANT_INVALID)
         return;
 
-    if (it->prev) {
-        variant_arr_t data = pcvar_arr_get_data(it->arr);
-        struct pcutils_array_list *al = &data->al;
-
-        struct pcutils_array_list_node *prev;
-        prev = &it->prev->node;
-
-        it_refresh(it, al, prev);
+    variant_arr_t data = pcvar_arr_get_data(it->arr);
+    if (it->idx > 0 && it->idx - 1 < variant_arr_length(data)) {
+        it_refresh(it, it->idx - 1);
     }
     else {
-        it->curr = NULL;
-        it->next = NULL;
-        it->prev = NULL;
+        it_end(it);
     }
 }
-
-
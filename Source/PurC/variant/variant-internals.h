@@ -189,12 +189,22 @@ pcvar_obj_it_next(struct obj_iterator *it);
 void
 pcvar_obj_it_prev(struct obj_iterator *it);
 
+// The nodes of an object are kept in the order of insertion; this returns
+// them sorted by key for the order-independent comparison and digest.
+// `buf` is used if it can hold all nodes; otherwise the returned array
+// must be freed by the caller. Returns NULL on failure of allocation.
+struct obj_node **
+pcvar_obj_sorted_nodes(purc_variant_t obj, struct obj_node **buf,
+        size_t sz_buf);
+
 struct arr_iterator {
     purc_variant_t                arr;
+    size_t                        nr_members;
+    size_t                        idx;
 
-    struct arr_node              *curr;
-    struct arr_node              *next;
-    struct arr_node              *prev;
+    purc_variant_t                curr;
+    purc_variant_t                next;
+    purc_variant_t                prev;
 };
 
 struct arr_iterator
@@ -288,6 +298,12 @@ pcvar_make_arr(void);
 int
 pcvar_arr_append(purc_variant_t arr, purc_variant_t val);
 
+/* Replaces the member at idx in place, taking over the reference of val
+ * and keeping the edge token (if any) in sync; the reference of the old
+ * member is left to the caller. */
+void
+pcvar_arr_replace_member(purc_variant_t arr, size_t idx, purc_variant_t val);
+
 purc_variant_t
 pcvar_make_obj(void);
 
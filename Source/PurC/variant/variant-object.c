@@ -25,6 +25,7 @@
 
 #include "config.h"
 #include "private/variant.h"
+#include "private/hashtable.h"
 #include "private/errors.h"
 #include "purc-errors.h"
 #include "variant-internals.h"
@@ -36,7 +37,15 @@
 #include <string.h>
 
 #define OBJ_EXTRA_SIZE(data) (sizeof(*data) + \
-        (data->size) * sizeof(struct obj_node))
+        (data->nr_nodes) * sizeof(struct obj_node) + \
+        (data->nr_slots) * sizeof(struct obj_node *))
+
+#define OBJ_MIN_NR_SLOTS        32
+
+struct obj_node_block {
+    struct obj_node_block  *next;
+    struct obj_node         nodes[];
+};
 
 static inline bool
 grow(purc_variant_t obj, purc_variant_t key, purc_variant_t val,
@@ -139,7 +148,7 @@ static purc_variant_t v_object_new_with_capacity(void)
     var->flags         = PCVRNT_FLAG_EXTRA_SIZE;
 
     variant_obj_t data;
-    data = (variant_obj_t)calloc(1, sizeof(*data));
+    data = (variant_obj_t)pcvariant_cache_alloc_0(sizeof(*data));
 
     if (!data) {
         pcvariant_put(var);
@@ -147,8 +156,6 @@ static purc_variant_t v_object_new_with_capacity(void)
         return PURC_VARIANT_INVALID;
     }
 
-    data->kvs = RB_ROOT;
-
     var->sz_ptr[1]     = (uintptr_t)data;
     var->refc          = 1;
 
@@ -170,6 +177,183 @@ break_rev_update_chain(purc_variant_t obj, struct obj_node *node)
     pcvar_break_rue_downward(node->val);
 }
 
+static inline uint32_t
+obj_key_hash(const char *key)
+{
+    return (uint32_t)pchash_perllike_str_hash(key);
+}
+
+static struct obj_node *
+obj_find(variant_obj_t data, const char *key, uint32_t hash)
+{
+    if (data->slots == NULL) {
+        struct obj_node *node;
+        for (node = data->first; node; node = node->next) {
+            if (node->hash == hash &&
+                    strcmp(key, purc_variant_get_string_const(node->key)) == 0)
+                return node;
+        }
+
+        return NULL;
+    }
+
+    size_t mask = data->nr_slots - 1;
+    for (size_t i = hash & mask; data->slots[i]; i = (i + 1) & mask) {
+        struct obj_node *node = data->slots[i];
+        if (node->hash == hash &&
+                strcmp(key, purc_variant_get_string_const(node->key)) == 0)
+            return node;
+    }
+
+    return NULL;
+}
+
+static void
+index_put(struct obj_node **slots, size_t nr_slots, struct obj_node *node)
+{
+    size_t mask = nr_slots - 1;
+    size_t i = node->hash & mask;
+    while (slots[i])
+        i = (i + 1) & mask;
+    slots[i] = node;
+}
+
+/* removes a node from the index by shifting the following entries back */
+static void
+index_remove(variant_obj_t data, struct obj_node *node)
+{
+    size_t mask = data->nr_slots - 1;
+    size_t i = node->hash & mask;
+    while (data->slots[i] != node) {
+        PC_ASSERT(data->slots[i]);
+        i = (i + 1) & mask;
+    }
+
+    size_t j = i;
+    for (;;) {
+        data->slots[i] = NULL;
+        for (;;) {
+            j = (j + 1) & mask;
+            if (data->slots[j] == NULL)
+                return;
+
+            /* the entry at j may fill the hole at i unless its home slot
+               lies cyclically in (i, j] */
+            size_t k = data->slots[j]->hash & mask;
+            if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+                continue;
+            break;
+        }
+
+        data->slots[i] = data->slots[j];
+        i = j;
+    }
+}
+
+/* makes room in the index for one more node */
+static void
+index_reserve(variant_obj_t data)
+{
+    size_t nr_slots = data->nr_slots;
+    if (data->size + 1 <= OBJ_MAX_LINEAR_NODES)
+        return;
+
+    /* keep the load factor no more than 1/2 */
+    if (data->slots && (data->size + 1) * 2 <= nr_slots)
+        return;
+
+    nr_slots = nr_slots ? nr_slots * 2 : OBJ_MIN_NR_SLOTS;
+    while ((data->size + 1) * 2 > nr_slots)
+        nr_slots *= 2;
+
+    struct obj_node **slots;
+    slots = (struct obj_node **)calloc(nr_slots, sizeof(*slots));
+    if (slots == NULL) {
+        /* the linear search still works, though slowly */
+        free(data->slots);
+        data->slots = NULL;
+        data->nr_slots = 0;
+        return;
+    }
+
+    struct obj_node *node;
+    for (node = data->first; node; node = node->next) {
+        index_put(slots, nr_slots, node);
+    }
+
+    free(data->slots);
+    data->slots = slots;
+    data->nr_slots = nr_slots;
+}
+
+static struct obj_node *
+obj_node_alloc(variant_obj_t data)
+{
+    if (data->free_nodes == NULL) {
+        /* double the capacity with a new block */
+        size_t nr = data->nr_nodes ? data->nr_nodes : OBJ_NR_FIRST_NODES;
+        struct obj_node_block *block;
+        block = (struct obj_node_block *)malloc(sizeof(*block) +
+                sizeof(struct obj_node) * nr);
+        if (block == NULL)
+            return NULL;
+
+        block->next = data->blocks;
+        data->blocks = block;
+        data->nr_nodes += nr;
+        for (size_t i = nr; i > 0; i--) {
+            block->nodes[i - 1].next = data->free_nodes;
+            data->free_nodes = block->nodes + i - 1;
+        }
+    }
+
+    struct obj_node *node = data->free_nodes;
+    data->free_nodes = node->next;
+    memset(node, 0, sizeof(*node));
+    return node;
+}
+
+static inline bool
+obj_node_is_linked(variant_obj_t data, struct obj_node *node)
+{
+    return node->prev || data->first == node;
+}
+
+static void
+obj_node_link(variant_obj_t data, struct obj_node *node)
+{
+    index_reserve(data);
+    if (data->slots)
+        index_put(data->slots, data->nr_slots, node);
+
+    node->prev = data->last;
+    node->next = NULL;
+    if (data->last)
+        data->last->next = node;
+    else
+        data->first = node;
+    data->last = node;
+    ++data->size;
+}
+
+static void
+obj_node_unlink(variant_obj_t data, struct obj_node *node)
+{
+    if (data->slots)
+        index_remove(data, node);
+
+    if (node->prev)
+        node->prev->next = node->next;
+    else
+        data->first = node->next;
+    if (node->next)
+        node->next->prev = node->prev;
+    else
+        data->last = node->prev;
+    node->prev = node->next = NULL;
+    --data->size;
+}
+
 static void
 obj_node_release(purc_variant_t obj, struct obj_node *node)
 {
@@ -181,11 +365,8 @@ obj_node_release(purc_variant_t obj, struct obj_node *node)
     variant_obj_t data = pcvar_obj_get_data(obj);
     PC_ASSERT(data);
 
-    struct rb_root *root = &data->kvs;
-    if (&node->node == root->rb_node || node->node.rb_parent) {
-        --data->size;
-        pcutils_rbtree_erase(&node->node, root);
-        node->node.rb_parent = NULL;
+    if (obj_node_is_linked(data, node)) {
+        obj_node_unlink(data, node);
     }
 
     PURC_VARIANT_SAFE_CLEAR(node->key);
@@ -200,11 +381,14 @@ obj_node_destroy(purc_variant_t obj, struct obj_node *node)
 
     obj_node_release(obj, node);
 
-    free(node);
+    variant_obj_t data = pcvar_obj_get_data(obj);
+    node->next = data->free_nodes;
+    data->free_nodes = node;
 }
 
 static struct obj_node*
-obj_node_create(purc_variant_t k, purc_variant_t v)
+obj_node_create(purc_variant_t obj, purc_variant_t k, purc_variant_t v,
+        uint32_t hash)
 {
     if (k->type != PVT(_STRING)) {
         pcinst_set_error(PURC_ERROR_INVALID_VALUE);
@@ -212,7 +396,7 @@ obj_node_create(purc_variant_t k, purc_variant_t v)
     }
 
     struct obj_node *node;
-    node = (struct obj_node*)calloc(1, sizeof(*node));
+    node = obj_node_alloc(pcvar_obj_get_data(obj));
     if (!node) {
         pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
         return NULL;
@@ -220,6 +404,7 @@ obj_node_create(purc_variant_t k, purc_variant_t v)
 
     node->key = purc_variant_ref(k);
     node->val = purc_variant_ref(v);
+    node->hash = hash;
 
     return node;
 }
@@ -295,29 +480,8 @@ v_object_remove(purc_variant_t obj, const char *key, bool silently,
         bool check)
 {
     variant_obj_t data = pcvar_obj_get_data(obj);
-    struct rb_root *root = &data->kvs;
-    struct rb_node **pnode = &root->rb_node;
-    struct rb_node *parent = NULL;
-    struct rb_node *entry = NULL;
-    while (*pnode) {
-        struct obj_node *node;
-        node = container_of(*pnode, struct obj_node, node);
-        const char *sk = purc_variant_get_string_const(node->key);
-        int ret = strcmp(key, sk);
-
-        parent = *pnode;
-
-        if (ret < 0)
-            pnode = &parent->rb_left;
-        else if (ret > 0)
-            pnode = &parent->rb_right;
-        else{
-            entry = *pnode;
-            break;
-        }
-    }
-
-    if (!entry) {
+    struct obj_node *node = obj_find(data, key, obj_key_hash(key));
+    if (!node) {
         if (silently)
             return 0;
 
@@ -325,8 +489,6 @@ v_object_remove(purc_variant_t obj, const char *key, bool silently,
         return -1;
     }
 
-    struct obj_node *node;
-    node = container_of(entry, struct obj_node, node);
     purc_variant_t k = node->key;
     purc_variant_t v = node->val;
 
@@ -341,10 +503,7 @@ v_object_remove(purc_variant_t obj, const char *key, bool silently,
             break_rev_update_chain(obj, node);
         }
 
-        --data->size;
-        PC_ASSERT(entry == root->rb_node || entry->rb_parent);
-        pcutils_rbtree_erase(entry, root);
-        entry->rb_parent = NULL;
+        obj_node_unlink(data, node);
 
         if (check) {
             pcvar_adjust_set_by_descendant(obj);
@@ -473,30 +632,10 @@ v_object_set(purc_variant_t obj, purc_variant_t key, purc_variant_t val,
     variant_obj_t data = pcvar_obj_get_data(obj);
     PC_ASSERT(data);
 
-    struct rb_root *root = &data->kvs;
-    struct rb_node **pnode = &root->rb_node;
-    struct rb_node *parent = NULL;
-    struct rb_node *entry = NULL;
-    while (*pnode) {
-        struct obj_node *node;
-        node = container_of(*pnode, struct obj_node, node);
-        const char *sko = purc_variant_get_string_const(node->key);
-        int ret = strcmp(sk, sko);
-
-        parent = *pnode;
-
-        if (ret < 0)
-            pnode = &parent->rb_left;
-        else if (ret > 0)
-            pnode = &parent->rb_right;
-        else{
-            entry = *pnode;
-            break;
-        }
-    }
-
-    if (!entry) { //new the entry
-        struct obj_node *node = obj_node_create(key, val);
+    uint32_t hash = obj_key_hash(sk);
+    struct obj_node *node = obj_find(data, sk, hash);
+    if (!node) { //new the entry
+        node = obj_node_create(obj, key, val, hash);
         if (!node)
             return -1;
 
@@ -509,12 +648,7 @@ v_object_set(purc_variant_t obj, purc_variant_t key, purc_variant_t val,
                     break;
             }
 
-            entry = &node->node;
-
-            pcutils_rbtree_link_node(entry, parent, pnode);
-            pcutils_rbtree_insert_color(entry, root);
-
-            ++data->size;
+            obj_node_link(data, node);
 
             if (check) {
                 if (build_rev_update_chain(obj, node))
@@ -536,8 +670,6 @@ v_object_set(purc_variant_t obj, purc_variant_t key, purc_variant_t val,
         return -1;
     }
 
-    struct obj_node *node;
-    node = container_of(entry, struct obj_node, node);
     if (node->val == val) {
         // NOTE: keep refc intact
         return 0;
@@ -752,22 +884,28 @@ void pcvariant_object_release (purc_variant_t value)
 {
     variant_obj_t data = pcvar_obj_get_data(value);
 
-    struct rb_root *root = &data->kvs;
-
-    struct rb_node *p, *n;
-    pcutils_rbtree_for_each_safe(pcutils_rbtree_first(root), p, n) {
-        struct obj_node *node;
-        node = container_of(p, struct obj_node, node);
-
+    /* release the members in the reverse order of insertion, so that
+       a member added later (e.g. a native entity revoking a listener on
+       an earlier member) goes before the members it depends on */
+    struct obj_node *node, *prev;
+    for (node = data->last; node; node = prev) {
+        prev = node->prev;
         obj_node_destroy(value, node);
     }
 
+    free(data->slots);
+    struct obj_node_block *block, *next_block;
+    for (block = data->blocks; block; block = next_block) {
+        next_block = block->next;
+        free(block);
+    }
+
     if (data->rev_update_chain) {
         pcvar_destroy_rev_update_chain(data->rev_update_chain);
         data->rev_update_chain = NULL;
     }
 
-    free(data);
+    pcvariant_cache_free(data, sizeof(*data));
 
     value->sz_ptr[1] = (uintptr_t)NULL; // say no to double free
 
@@ -804,38 +942,13 @@ purc_variant_object_get_by_ckey(purc_variant_t obj, const char* key)
         PURC_VARIANT_INVALID);
 
     variant_obj_t data = pcvar_obj_get_data(obj);
-    struct rb_root *root = &data->kvs;
-
-    struct rb_node **pnode = &root->rb_node;
-    struct rb_node *parent = NULL;
-    struct rb_node *entry = NULL;
-    while (*pnode) {
-        struct obj_node *node;
-        node = container_of(*pnode, struct obj_node, node);
-        const char *sk = purc_variant_get_string_const(node->key);
-
-        int ret = strcmp(key, sk);
-
-        parent = *pnode;
-
-        if (ret < 0)
-            pnode = &parent->rb_left;
-        else if (ret > 0)
-            pnode = &parent->rb_right;
-        else{
-            entry = *pnode;
-            break;
-        }
-    }
-
-    if (!entry) {
+    struct obj_node *node = obj_find(data, key, obj_key_hash(key));
+    if (!node) {
         pcinst_set_error(PCVRNT_ERROR_NO_SUCH_KEY);
 
         return PURC_VARIANT_INVALID;
     }
 
-    struct obj_node *node;
-    node = container_of(entry, struct obj_node, node);
     return node->val;
 }
 
@@ -1039,11 +1152,8 @@ pcvar_object_break_rue_downward(purc_variant_t obj)
     if (!data)
         return;
 
-    struct rb_root *root = &data->kvs;
-    struct rb_node *p = pcutils_rbtree_first(root);
-    for (; p; p = pcutils_rbtree_next(p)) {
-        struct obj_node *node;
-        node = container_of(p, struct obj_node, node);
+    struct obj_node *node;
+    for (node = data->first; node; node = node->next) {
         struct pcvar_rev_update_edge edge = {
             .parent         = obj,
             .obj_me         = node,
@@ -1076,11 +1186,8 @@ pcvar_object_build_rue_downward(purc_variant_t obj)
     if (!data)
         return 0;
 
-    struct rb_root *root = &data->kvs;
-    struct rb_node *p = pcutils_rbtree_first(root);
-    for (; p; p = pcutils_rbtree_next(p)) {
-        struct obj_node *node;
-        node = container_of(p, struct obj_node, node);
+    struct obj_node *node;
+    for (node = data->first; node; node = node->next) {
         struct pcvar_rev_update_edge edge = {
             .parent         = obj,
             .obj_me         = node,
@@ -1124,35 +1231,11 @@ pcvar_object_build_edge_to_parent(purc_variant_t obj,
 }
 
 static void
-it_refresh(struct obj_iterator *it, struct rb_node *curr)
+it_refresh(struct obj_iterator *it, struct obj_node *curr)
 {
-    struct rb_node *next  = NULL;
-    struct rb_node *prev  = NULL;
-    if (curr) {
-        next  = pcutils_rbtree_next(curr);
-        prev  = pcutils_rbtree_prev(curr);
-    }
-
-    if (curr) {
-        it->curr = container_of(curr, struct obj_node, node);
-    }
-    else {
-        it->curr = NULL;
-    }
-
-    if (next) {
-        it->next = container_of(next, struct obj_node, node);
-    }
-    else {
-        it->next = NULL;
-    }
-
-    if (prev) {
-        it->prev = container_of(prev, struct obj_node, node);
-    }
-    else {
-        it->prev = NULL;
-    }
+    it->curr = curr;
+    it->next = curr ? curr->next : NULL;
+    it->prev = curr ? curr->prev : NULL;
 }
 
 struct obj_iterator
@@ -1168,10 +1251,7 @@ pcvar_obj_it_first(purc_variant_t obj)
     if (data->size==0)
         return it;
 
-    struct rb_root *root = &data->kvs;
-
-    struct rb_node *first = pcutils_rbtree_first(root);
-    it_refresh(&it, first);
+    it_refresh(&it, data->first);
 
     return it;
 }
@@ -1189,10 +1269,7 @@ pcvar_obj_it_last(purc_variant_t obj)
     if (data->size==0)
         return it;
 
-    struct rb_root *root = &data->kvs;
-
-    struct rb_node *last = pcutils_rbtree_last(root);
-    it_refresh(&it, last);
+    it_refresh(&it, data->last);
 
     return it;
 }
@@ -1203,15 +1280,7 @@ pcvar_obj_it_next(struct obj_iterator *it)
     if (it->curr == NULL)
         return;
 
-    if (it->next) {
-        struct rb_node *next = &it->next->node;
-        it_refresh(it, next);
-    }
-    else {
-        it->curr = NULL;
-        it->next = NULL;
-        it->prev = NULL;
-    }
+    it_refresh(it, it->next);
 }
 
 void
@@ -1220,15 +1289,41 @@ pcvar_obj_it_prev(struct obj_iterator *it)
     if (it->curr == NULL)
         return;
 
-    if (it->prev) {
-        struct rb_node *prev = &it->prev->node;
-        it_refresh(it, prev);
+    it_refresh(it, it->prev);
+}
+
+static int
+cmp_node_keys(const void *l, const void *r)
+{
+    const struct obj_node *ln = *(const struct obj_node **)l;
+    const struct obj_node *rn = *(const struct obj_node **)r;
+    return strcmp(purc_variant_get_string_const(ln->key),
+            purc_variant_get_string_const(rn->key));
+}
+
+struct obj_node **
+pcvar_obj_sorted_nodes(purc_variant_t obj, struct obj_node **buf,
+        size_t sz_buf)
+{
+    variant_obj_t data = pcvar_obj_get_data(obj);
+
+    struct obj_node **nodes = buf;
+    if (data->size > sz_buf) {
+        nodes = (struct obj_node **)malloc(sizeof(*nodes) * data->size);
+        if (nodes == NULL) {
+            pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
+            return NULL;
+        }
     }
-    else {
-        it->curr = NULL;
-        it->next = NULL;
-        it->prev = NULL;
+
+    size_t n = 0;
+    struct obj_node *node;
+    for (node = data->first; node; node = node->next) {
+        nodes[n++] = node;
     }
+
+    qsort(nodes, n, sizeof(*nodes), cmp_node_keys);
+    return nodes;
 }
 
 ssize_t
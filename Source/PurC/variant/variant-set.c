@@ -37,6 +37,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#define SET_MIN_NR_SLOTS        16
+
 static bool
 grow(purc_variant_t set, purc_variant_t value,
         bool check)
@@ -138,6 +140,7 @@ variant_set_get_extra_size(variant_set_t data)
 
     extra += sz_record * count;
     extra += sizeof(struct set_node*)*(data->al.nr);
+    extra += sizeof(struct set_node*)*(data->nr_slots);
 
     return extra;
 }
@@ -148,71 +151,6 @@ pcv_set_set_data(purc_variant_t set, variant_set_t data)
     set->sz_ptr[1]     = (uintptr_t)data;
 }
 
-static int
-obj_node_diff(struct obj_node *l, struct obj_node *r)
-{
-    int diff = 0;
-
-    purc_variant_t lk, rk;
-    lk = l->key;
-    rk = r->key;
-    PC_ASSERT(lk);
-    PC_ASSERT(rk);
-
-    if (lk != rk) {
-        diff = pcvariant_diff(lk, rk);
-        if (diff)
-            return diff;
-    }
-
-    purc_variant_t lv, rv;
-    lv = l->val;
-    rv = r->val;
-    PC_ASSERT(lv);
-    PC_ASSERT(rv);
-
-    if (lv != rv) {
-        diff = pcvariant_diff(lv, rv);
-    }
-
-    return diff;
-}
-
-static int
-variant_set_compare_by_set_keys(purc_variant_t set,
-        purc_variant_t l, purc_variant_t r)
-{
-    PC_ASSERT(set != PURC_VARIANT_INVALID);
-    PC_ASSERT(purc_variant_is_set(set));
-    PC_ASSERT(l != PURC_VARIANT_INVALID);
-    PC_ASSERT(r != PURC_VARIANT_INVALID);
-    PC_ASSERT(pcvariant_is_mutable(l));
-    PC_ASSERT(pcvariant_is_mutable(r));
-
-    int diff;
-
-    struct kv_iterator lit, rit;
-    lit = pcvar_kv_it_first(set, l);
-    rit = pcvar_kv_it_first(set, r);
-    while (1) {
-        struct obj_node *ln = lit.it.curr;
-        struct obj_node *rn = rit.it.curr;
-        if (ln == NULL && rn == NULL)
-            return 0;
-        if (ln == NULL)
-            return -1;
-        if (rn == NULL)
-            return 1;
-
-        diff = obj_node_diff(ln, rn);
-        if (diff)
-            return diff;
-
-        pcvar_kv_it_next(&lit);
-        pcvar_kv_it_next(&rit);
-    }
-}
-
 static int
 variant_set_init(variant_set_t data, const char *unique_key, bool caseless)
 {
@@ -279,7 +217,7 @@ pcv_set_new(void)
     set->type          = PVT(_SET);
     set->flags         = PCVRNT_FLAG_EXTRA_SIZE;
 
-    variant_set_t data  = (variant_set_t)calloc(1, sizeof(*data));
+    variant_set_t data  = (variant_set_t)pcvariant_cache_alloc_0(sizeof(*data));
     pcv_set_set_data(set, data);
 
     if (!data) {
@@ -434,6 +372,110 @@ _compare(purc_variant_t _new, purc_variant_t _old,
     return _compare_by_unique_keys(_new, _old, data);
 }
 
+static void
+index_put(struct set_node **slots, size_t nr_slots, struct set_node *node)
+{
+    size_t mask = nr_slots - 1;
+    size_t i = (size_t)node->hash & mask;
+    while (slots[i])
+        i = (i + 1) & mask;
+    slots[i] = node;
+}
+
+/* removes a node from the index by shifting the following entries back */
+static void
+index_remove(variant_set_t data, struct set_node *node)
+{
+    if (data->slots == NULL)
+        return;
+
+    size_t mask = data->nr_slots - 1;
+    size_t i = (size_t)node->hash & mask;
+    while (data->slots[i] != node) {
+        PC_ASSERT(data->slots[i]);
+        i = (i + 1) & mask;
+    }
+
+    size_t j = i;
+    for (;;) {
+        data->slots[i] = NULL;
+        for (;;) {
+            j = (j + 1) & mask;
+            if (data->slots[j] == NULL)
+                return;
+
+            /* the entry at j may fill the hole at i unless its home slot
+               lies cyclically in (i, j] */
+            size_t k = (size_t)data->slots[j]->hash & mask;
+            if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+                continue;
+            break;
+        }
+
+        data->slots[i] = data->slots[j];
+        i = j;
+    }
+}
+
+/* makes room in the index for one more node */
+static void
+index_reserve(variant_set_t data)
+{
+    size_t count = pcutils_array_list_length(&data->al);
+    size_t nr_slots = data->nr_slots;
+
+    /* keep the load factor no more than 1/2 */
+    if (data->slots && (count + 1) * 2 <= nr_slots)
+        return;
+
+    /* the index was dropped for lack of memory */
+    if (data->slots == NULL && count > 0)
+        return;
+
+    nr_slots = nr_slots ? nr_slots * 2 : SET_MIN_NR_SLOTS;
+    while ((count + 1) * 2 > nr_slots)
+        nr_slots *= 2;
+
+    struct set_node **slots;
+    slots = (struct set_node **)calloc(nr_slots, sizeof(*slots));
+    if (slots == NULL) {
+        /* the lookup still works with the rbtree, though slowly */
+        free(data->slots);
+        data->slots = NULL;
+        data->nr_slots = 0;
+        return;
+    }
+
+    struct pcutils_array_list_node *p;
+    array_list_for_each(&data->al, p) {
+        struct set_node *sn = container_of(p, struct set_node, alnode);
+        index_put(slots, nr_slots, sn);
+    }
+
+    free(data->slots);
+    data->slots = slots;
+    data->nr_slots = nr_slots;
+}
+
+static struct set_node*
+index_find(purc_variant_t set, purc_variant_t kvs, uint64_t hash)
+{
+    variant_set_t data = pcvar_set_get_data(set);
+    PC_ASSERT(data->slots);
+
+    /* compare the values only when the hashes collide */
+    size_t mask = data->nr_slots - 1;
+    for (size_t i = (size_t)hash & mask; data->slots[i]; i = (i + 1) & mask) {
+        struct set_node *node = data->slots[i];
+        if (node->hash == hash && _compare(kvs, node->val, data) == 0)
+            return node;
+    }
+
+    return NULL;
+}
+
+/* the tree is ordered by the values, which gives the order of iteration
+   and comparison; the hashes only serve the index */
 static void
 find_element_rb_node(struct element_rb_node *node,
         purc_variant_t set, purc_variant_t kvs)
@@ -443,22 +485,11 @@ find_element_rb_node(struct element_rb_node *node,
     struct rb_node **pnode = &root->rb_node;
     struct rb_node *parent = NULL;
     struct rb_node *entry = NULL;
-    char md5[33];
-    pcvariant_md5_by_set(md5, kvs, set);
 
     while (*pnode) {
         struct set_node *on;
         on = container_of(*pnode, struct set_node, rbnode);
-        int diff;
-        if (0) {
-            diff = variant_set_compare_by_set_keys(set, kvs, on->val);
-        }
-        else if (0) {
-            diff = pcvariant_diff_by_set(md5, kvs, on->md5, on->val, set);
-        }
-        else {
-            diff = _compare(kvs, on->val, data);
-        }
+        int diff = _compare(kvs, on->val, data);
 
         parent = *pnode;
 
@@ -482,6 +513,13 @@ find_element_rb_node(struct element_rb_node *node,
 static struct set_node*
 find_element(purc_variant_t set, purc_variant_t kvs)
 {
+    variant_set_t data = pcvar_set_get_data(set);
+    if (pcutils_array_list_length(&data->al) == 0)
+        return NULL;
+
+    if (data->slots)
+        return index_find(set, kvs, pcvariant_hash_by_set(kvs, set));
+
     struct element_rb_node node;
     find_element_rb_node(&node, set, kvs);
 
@@ -574,6 +612,7 @@ elem_node_remove(purc_variant_t set, struct set_node *node)
     PC_ASSERT(data);
 
     pcutils_rbtree_erase(&node->rbnode, &data->elems);
+    index_remove(data, node);
 
     int r;
     struct pcutils_array_list_node *old;
@@ -603,7 +642,7 @@ elem_node_destroy(purc_variant_t set, struct set_node *node)
         return;
 
     elem_node_release(set, node);
-    free(node);
+    pcvariant_cache_free(node, sizeof(*node));
 }
 
 static int
@@ -646,6 +685,10 @@ variant_set_release_elems(purc_variant_t set, variant_set_t data)
     }
 
     pcutils_array_list_reset(&data->al);
+
+    free(data->slots);
+    data->slots = NULL;
+    data->nr_slots = 0;
 }
 
 static void
@@ -704,19 +747,20 @@ variant_set_create_kvs_n(variant_set_t set, purc_variant_t v1, va_list ap)
 }
 
 static struct set_node*
-variant_set_create_elem_node(purc_variant_t set, purc_variant_t val)
+variant_set_create_elem_node(purc_variant_t set, purc_variant_t val,
+        uint64_t hash)
 {
     variant_set_t data = pcvar_set_get_data(set);
     PC_ASSERT(data);
 
-    struct set_node *_new = (struct set_node*)calloc(1, sizeof(*_new));
+    struct set_node *_new;
+    _new = (struct set_node*)pcvariant_cache_alloc_0(sizeof(*_new));
     if (!_new) {
         pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
         return NULL;
     }
 
-    pcvariant_md5_by_set(_new->md5, val, set);
-
+    _new->hash = hash;
     _new->alnode.idx = (size_t)-1;
     _new->val = val;
     purc_variant_ref(val);
@@ -840,7 +884,7 @@ check_grow(purc_variant_t set, purc_variant_t val)
 
 static int
 insert(purc_variant_t set, variant_set_t data,
-        purc_variant_t val,
+        purc_variant_t val, uint64_t hash,
         struct rb_node *parent, struct rb_node **pnode,
         bool check)
 {
@@ -855,10 +899,12 @@ insert(purc_variant_t set, variant_set_t data,
                 break;
         }
 
-        node = variant_set_create_elem_node(set, val);
+        node = variant_set_create_elem_node(set, val, hash);
         if (!node)
             break;
 
+        index_reserve(data);
+
         PC_ASSERT(node->alnode.idx == (size_t)-1);
         int r = pcutils_array_list_append(&data->al, &node->alnode);
         if (r)
@@ -873,6 +919,9 @@ insert(purc_variant_t set, variant_set_t data,
         pcutils_rbtree_link_node(entry, parent, pnode);
         pcutils_rbtree_insert_color(entry, &data->elems);
 
+        if (data->slots)
+            index_put(data->slots, data->nr_slots, node);
+
         if (check) {
             if (!elem_node_setup_constraints(set, node))
                 break;
@@ -896,6 +945,12 @@ pcvar_set_add(purc_variant_t set, purc_variant_t val)
     variant_set_t data = pcvar_set_get_data(set);
     PC_ASSERT(data);
 
+    uint64_t hash = pcvariant_hash_by_set(val, set);
+    if (data->slots && index_find(set, val, hash)) {
+        purc_set_error(PURC_ERROR_DUPLICATED);
+        return -1;
+    }
+
     struct element_rb_node rbn;
     find_element_rb_node(&rbn, set, val);
 
@@ -905,7 +960,7 @@ pcvar_set_add(purc_variant_t set, purc_variant_t val)
     }
 
     bool check = false;
-    return insert(set, data, val, rbn.parent, rbn.pnode, check);
+    return insert(set, data, val, hash, rbn.parent, rbn.pnode, check);
 }
 
 static int
@@ -961,17 +1016,25 @@ insert_or_replace(purc_variant_t set,
         variant_set_t data, purc_variant_t val, pcvrnt_cr_method_k cr_method,
         bool check)
 {
-    struct element_rb_node rbn;
-    find_element_rb_node(&rbn, set, val);
+    uint64_t hash = pcvariant_hash_by_set(val, set);
+    struct set_node *curr = NULL;
+    if (data->slots)
+        curr = index_find(set, val, hash);
 
-    if (!rbn.entry) {
-        int r = insert(set, data, val, rbn.parent, rbn.pnode, check);
+    if (!curr) {
+        /* a new member: only its position in the ordered tree is needed */
+        struct element_rb_node rbn;
+        find_element_rb_node(&rbn, set, val);
 
-        return (r == 0) ? 1 : 0;
-    }
+        if (!rbn.entry) {
+            int r = insert(set, data, val, hash, rbn.parent, rbn.pnode,
+                    check);
+
+            return (r == 0) ? 1 : 0;
+        }
 
-    struct set_node *curr;
-    curr = container_of(rbn.entry, struct set_node, rbnode);
+        curr = container_of(rbn.entry, struct set_node, rbnode);
+    }
 
     if (curr->val == val) {
         return 0;
@@ -1527,7 +1590,7 @@ pcvariant_set_release(purc_variant_t value)
     PC_ASSERT(data);
 
     variant_set_release(value, data);
-    free(data);
+    pcvariant_cache_free(data, sizeof(*data));
     pcv_set_set_data(value, NULL);
 
     pcvariant_stat_set_extra_size(value, 0);
@@ -1595,6 +1658,11 @@ int pcvariant_set_sort(purc_variant_t value, void *ud,
 {
     PC_ASSERT(value != PURC_VARIANT_INVALID);
 
+    if (value->flags & PCVRNT_FLAG_FROZEN) {
+        pcinst_set_error(PURC_ERROR_ACCESS_DENIED);
+        return -1;
+    }
+
     variant_set_t data = pcvar_set_get_data(value);
     struct pcutils_array_list *al = &data->al;
 
@@ -2113,6 +2181,10 @@ pcvar_readjust_set(purc_variant_t set, struct set_node *node)
     variant_set_t data = pcvar_set_get_data(set);
 
     pcutils_rbtree_erase(&node->rbnode, &data->elems);
+    index_remove(data, node);
+
+    /* the member was changed in place; hash it again */
+    node->hash = pcvariant_hash_by_set(node->val, set);
 
     struct element_rb_node rbn;
     find_element_rb_node(&rbn, set, node->val);
@@ -2123,6 +2195,9 @@ pcvar_readjust_set(purc_variant_t set, struct set_node *node)
     pcutils_rbtree_link_node(entry, rbn.parent, rbn.pnode);
     pcutils_rbtree_insert_color(entry, &data->elems);
 
+    if (data->slots)
+        index_put(data->slots, data->nr_slots, node);
+
     return 0;
 }
 
@@ -184,6 +184,11 @@ bool purc_variant_tuple_set(purc_variant_t tuple,
     if (members == NULL || idx >= sz)
         return false;
 
+    if (tuple->flags & PCVRNT_FLAG_FROZEN) {
+        pcinst_set_error(PURC_ERROR_ACCESS_DENIED);
+        return false;
+    }
+
     assert(value);
     /* do not change */
     if (value == members[idx])
@@ -31,6 +31,7 @@
 #include "private/debug.h"
 #include "private/dvobjs.h"
 #include "private/utils.h"
+#include "private/utf8.h"
 #include "variant-internals.h"
 
 #include <stdlib.h>
@@ -39,6 +40,18 @@
 #include <math.h>
 #include <float.h>
 
+#if HAVE(STDATOMIC_H)
+#include <stdatomic.h>
+
+#define _COMPILE_TIME_ASSERT(name, x)               \
+       typedef int _dummy_ ## name[(x) * 2 - 1]
+_COMPILE_TIME_ASSERT(refc, sizeof(atomic_uint) == sizeof(unsigned int));
+#undef _COMPILE_TIME_ASSERT
+
+/* the reference count of a frozen variant is shared among instances */
+#define FROZEN_REFC(v)      ((atomic_uint *)&(v)->refc)
+#endif
+
 #if OS(LINUX) || OS(UNIX)
     #include <dlfcn.h>
 #endif
@@ -100,18 +113,107 @@ void pcvariant_free(purc_variant *v) {
 }
 #else
 purc_variant *pcvariant_alloc(void) {
-    return (purc_variant *)malloc(sizeof(purc_variant));
+    return (purc_variant *)pcvariant_cache_alloc(sizeof(purc_variant));
 }
 
 purc_variant *pcvariant_alloc_0(void) {
-    return (purc_variant *)calloc(1, sizeof(purc_variant));
+    return (purc_variant *)pcvariant_cache_alloc_0(sizeof(purc_variant));
 }
 
 void pcvariant_free(purc_variant *v) {
-    return free(v);
+    return pcvariant_cache_free(v, sizeof(purc_variant));
 }
 #endif
 
+static struct pcvariant_heap *cache_heap(void)
+{
+    struct pcinst *inst = pcinst_current();
+
+    /* the block caches are per instance: always use the original heap,
+       even when the move heap is in use. */
+    return inst ? inst->org_vrt_heap : NULL;
+}
+
+static inline size_t cache_class(size_t size)
+{
+    return (size - 1) >> CACHE_CLASS_SHIFT;
+}
+
+static inline size_t cache_class_size(size_t cls)
+{
+    return (cls + 1) << CACHE_CLASS_SHIFT;
+}
+
+void *pcvariant_cache_alloc(size_t size)
+{
+    if (size == 0 || size > CACHE_MAX_BLOCK_SIZE)
+        return malloc(size);
+
+    size_t cls = cache_class(size);
+    struct pcvariant_heap *heap = cache_heap();
+    if (heap && heap->cache_free[cls]) {
+        void *block = heap->cache_free[cls];
+        heap->cache_free[cls] = *(void **)block;
+        heap->cache_nr_free[cls]--;
+        heap->stat.nr_blocks_cached--;
+        heap->stat.sz_blocks_cached -= cache_class_size(cls);
+        return block;
+    }
+
+    return malloc(pcvariant_cache_block_size(size));
+}
+
+void *pcvariant_cache_alloc_0(size_t size)
+{
+    void *block = pcvariant_cache_alloc(size);
+    if (block)
+        memset(block, 0, size);
+    return block;
+}
+
+void pcvariant_cache_free(void *block, size_t size)
+{
+    if (block == NULL)
+        return;
+
+    struct pcvariant_heap *heap;
+    if (size == 0 || size > CACHE_MAX_BLOCK_SIZE ||
+            (heap = cache_heap()) == NULL) {
+        free(block);
+        return;
+    }
+
+    size_t cls = cache_class(size);
+    if (heap->cache_nr_free[cls] + 1 > MAX_CACHED_BLOCKS) {
+        free(block);
+        return;
+    }
+
+    *(void **)block = heap->cache_free[cls];
+    heap->cache_free[cls] = block;
+    heap->cache_nr_free[cls]++;
+    heap->stat.nr_blocks_cached++;
+    heap->stat.sz_blocks_cached += cache_class_size(cls);
+}
+
+static void cache_release_all(struct pcvariant_heap *heap)
+{
+    for (size_t cls = 0; cls < CACHE_NR_CLASSES; cls++) {
+        void *block = heap->cache_free[cls];
+        while (block) {
+            void *next = *(void **)block;
+            free(block);
+            block = next;
+        }
+
+        heap->cache_free[cls] = NULL;
+        heap->cache_nr_free[cls] = 0;
+    }
+
+    heap->stat.nr_blocks_cached = 0;
+    heap->stat.sz_blocks_cached = 0;
+}
+
 purc_atom_t pcvariant_atom_grow;
 purc_atom_t pcvariant_atom_shrink;
 purc_atom_t pcvariant_atom_change;
@@ -166,6 +268,9 @@ static void _cleanup_instance(struct pcinst *inst)
     }
 #endif
 
+    /* the reserved variants above may have been cached as blocks */
+    cache_release_all(heap);
+
     assert(heap->v_undefined.refc == 0);
     assert(heap->v_null.refc == 0);
     assert(heap->v_true.refc == 0);
@@ -226,6 +331,9 @@ static int _init_instance(struct pcinst *curr_inst,
 
     stat->nr_reserved = 0;
     stat->nr_max_reserved = MAX_RESERVED_VARIANTS;
+    stat->nr_blocks_cached = 0;
+    stat->sz_blocks_cached = 0;
+    stat->nr_max_blocks_cached = MAX_CACHED_BLOCKS * CACHE_NR_CLASSES;
 
 #if !USE(LOOP_BUFFER_FOR_RESERVED)
     INIT_LIST_HEAD(&inst->variant_heap->v_reserved);
@@ -293,6 +401,12 @@ enum purc_variant_type purc_variant_get_type(purc_variant_t value)
     return value->type;
 }
 
+bool purc_variant_is_frozen(purc_variant_t value)
+{
+    PC_ASSERT(value);
+    return (value->flags & PCVRNT_FLAG_FROZEN);
+}
+
 bool pcvariant_is_mutable(purc_variant_t val)
 {
     switch (val->type) {
@@ -344,13 +458,42 @@ purc_variant_t purc_variant_ref (purc_variant_t value)
         return PURC_VARIANT_INVALID;
     }
 
-    value->refc++;
+#if HAVE(STDATOMIC_H)
+    if (value->flags & PCVRNT_FLAG_FROZEN)
+        atomic_fetch_add(FROZEN_REFC(value), 1);
+    else
+#endif
+        value->refc++;
 
     referenced(value);
 
     return value;
 }
 
+#if HAVE(STDATOMIC_H)
+static unsigned int
+unref_frozen(purc_variant_t value)
+{
+    unsigned int refc = atomic_fetch_sub(FROZEN_REFC(value), 1) - 1;
+    if (refc > 0)
+        return refc;
+
+    /* frozen variants are accounted in the move heap */
+    bool nested = pcvariant_is_using_move_heap();
+    if (!nested)
+        pcvariant_use_move_heap();
+
+    pcvariant_release_fn release_fn = variant_releasers[value->type];
+    if (release_fn)
+        release_fn(value);
+    pcvariant_put(value);
+
+    if (!nested)
+        pcvariant_use_norm_heap();
+    return 0;
+}
+#endif
+
 unsigned int purc_variant_unref(purc_variant_t value)
 {
     PC_ASSERT(value);
@@ -364,6 +507,11 @@ unsigned int purc_variant_unref(purc_variant_t value)
     // FIXME: pre or post?
     unreferenced(value);
 
+#if HAVE(STDATOMIC_H)
+    if (value->flags & PCVRNT_FLAG_FROZEN)
+        return unref_frozen(value);
+#endif
+
     value->refc--;
 
     // VWNOTE: only non-constant values has a releaser
@@ -773,6 +921,66 @@ bool purc_variant_is_equal_to(purc_variant_t v1, purc_variant_t v2)
 #endif
 }
 
+#define HASH_MIX(h, v)      ((h) * 31 + (size_t)(v))
+
+size_t pcvariant_shallow_hash(purc_variant_t v)
+{
+    const char *str;
+    size_t len;
+
+    if (v == NULL)
+        return 0;
+
+    size_t hash = v->type + 1;
+    switch (v->type) {
+        case PURC_VARIANT_TYPE_BOOLEAN:
+            hash = HASH_MIX(hash, v->b);
+            break;
+
+        case PURC_VARIANT_TYPE_EXCEPTION:
+            hash = HASH_MIX(hash, v->atom);
+            break;
+
+        case PURC_VARIANT_TYPE_LONGINT:
+        case PURC_VARIANT_TYPE_ULONGINT:
+            hash = HASH_MIX(hash, v->u64);
+            break;
+
+        case PURC_VARIANT_TYPE_ATOMSTRING:
+            str = purc_atom_to_string(v->atom);
+            hash = HASH_MIX(hash,
+                    pcutils_hash_hash((const unsigned char *)str, strlen(str)));
+            break;
+
+        case PURC_VARIANT_TYPE_STRING:
+        case PURC_VARIANT_TYPE_BSEQUENCE:
+            if (v->flags & (PCVRNT_FLAG_STRING_STATIC | PCVRNT_FLAG_EXTRA_SIZE)) {
+                str = (const char*)v->sz_ptr[1];
+                len = v->sz_ptr[0];
+            }
+            else {
+                str = (const char*)v->bytes;
+                len = v->size;
+            }
+            hash = HASH_MIX(hash,
+                    pcutils_hash_hash((const unsigned char *)str, len));
+            break;
+
+        case PURC_VARIANT_TYPE_DYNAMIC:
+        case PURC_VARIANT_TYPE_NATIVE:
+            hash = HASH_MIX(hash, (uintptr_t)v->ptr_ptr[0]);
+            hash = HASH_MIX(hash, (uintptr_t)v->ptr_ptr[1]);
+            break;
+
+        /* the numbers are compared with a tolerance, and the containers
+           are compared recursively; only the type is hashed for them. */
+        default:
+            break;
+    }
+
+    return hash;
+}
+
 bool
 purc_variant_is_true(purc_variant_t v)
 {
@@ -1488,6 +1696,9 @@ static int compare_number_method (purc_variant_t v1, purc_variant_t v2)
     return ret;
 }
 
+static ssize_t
+stringify_alloc_ex(char **strp, purc_variant_t value, bool sort_keys);
+
 static char *
 compare_stringify (purc_variant_t v, char *stackbuffer, size_t size)
 {
@@ -1501,7 +1712,8 @@ compare_stringify (purc_variant_t v, char *stackbuffer, size_t size)
         case PURC_VARIANT_TYPE_ARRAY:
         case PURC_VARIANT_TYPE_SET:
         case PURC_VARIANT_TYPE_TUPLE:
-            num_write = purc_variant_stringify_alloc (&buffer, v);
+            /* the result must not depend on the order of insertion */
+            num_write = stringify_alloc_ex (&buffer, v, true);
             if (num_write < 0) {
                 buffer = 0;
                 stackbuffer[0] = '\0';
@@ -2178,11 +2390,16 @@ purc_variant_booleanize(purc_variant_t value)
     return false;
 }
 
+#define NR_SORTED_NODES_ON_STACK    16
+
 struct stringify_arg
 {
     void (*cb)(struct stringify_arg *arg, const void *src, size_t len);
     void *arg;
     unsigned int flags;
+    /* stringify the members of objects in the order of keys, so that
+       the digests do not depend on the order of insertion */
+    bool sort_keys;
 };
 
 static void
@@ -2242,6 +2459,23 @@ stringify_kv(struct stringify_arg *arg, const char *key, purc_variant_t val)
 static void
 stringify_object(struct stringify_arg *arg, purc_variant_t value)
 {
+    struct obj_node *buf[NR_SORTED_NODES_ON_STACK];
+    struct obj_node **nodes = NULL;
+    if (arg->sort_keys)
+        nodes = pcvar_obj_sorted_nodes(value, buf, PCA_TABLESIZE(buf));
+
+    if (nodes) {
+        size_t sz = purc_variant_object_get_size(value);
+        for (size_t i = 0; i < sz; i++) {
+            const char *sk = purc_variant_get_string_const(nodes[i]->key);
+            stringify_kv(arg, sk, nodes[i]->val);
+        }
+
+        if (nodes != buf)
+            free(nodes);
+        return;
+    }
+
     purc_variant_t k, v;
     foreach_key_value_in_variant_object(value, k, v)
         const char *sk = purc_variant_get_string_const(k);
@@ -2466,9 +2700,9 @@ do_stringify_stream(struct stringify_arg *arg, const void *src, size_t len)
     ud->accu += len;
 }
 
-ssize_t
-purc_variant_stringify(purc_rwstream_t stream, purc_variant_t value,
-        unsigned int flags, size_t *len_expected)
+static ssize_t
+stringify_ex(purc_rwstream_t stream, purc_variant_t value,
+        unsigned int flags, size_t *len_expected, bool sort_keys)
 {
     if (value == PURC_VARIANT_INVALID) {
         purc_set_error(PURC_ERROR_INVALID_VALUE);
@@ -2487,6 +2721,7 @@ purc_variant_stringify(purc_rwstream_t stream, purc_variant_t value,
     arg.cb    = do_stringify_stream;
     arg.arg   = &ud;
     arg.flags = flags;
+    arg.sort_keys = sort_keys;
 
     variant_stringify(&arg, value);
 
@@ -2507,7 +2742,14 @@ purc_variant_stringify(purc_rwstream_t stream, purc_variant_t value,
 }
 
 ssize_t
-purc_variant_stringify_alloc(char **strp, purc_variant_t value)
+purc_variant_stringify(purc_rwstream_t stream, purc_variant_t value,
+        unsigned int flags, size_t *len_expected)
+{
+    return stringify_ex(stream, value, flags, len_expected, false);
+}
+
+static ssize_t
+stringify_alloc_ex(char **strp, purc_variant_t value, bool sort_keys)
 {
     purc_rwstream_t stream;
     stream = purc_rwstream_new_buffer(0, 0);
@@ -2515,7 +2757,7 @@ purc_variant_stringify_alloc(char **strp, purc_variant_t value)
         return -1;
 
     unsigned int flags = 0;
-    ssize_t sz = purc_variant_stringify(stream, value, flags, NULL);
+    ssize_t sz = stringify_ex(stream, value, flags, NULL, sort_keys);
     if (sz == -1) {
         purc_rwstream_destroy(stream);
         return -1;
@@ -2543,6 +2785,12 @@ purc_variant_stringify_alloc(char **strp, purc_variant_t value)
     return sz_content;
 }
 
+ssize_t
+purc_variant_stringify_alloc(char **strp, purc_variant_t value)
+{
+    return stringify_alloc_ex(strp, value, false);
+}
+
 ssize_t pcvariant_serialize(char *buf, size_t sz, purc_variant_t val)
 {
     PC_ASSERT(val != PURC_VARIANT_INVALID);
@@ -2818,6 +3066,7 @@ purc_ejson_parsing_tree_destroy(struct purc_ejson_parsing_tree *parse_tree)
     pcvcm_node_destroy((struct pcvcm_node *)parse_tree);
 }
 
+/* compares the members of two objects in the order of keys */
 static int
 cmp_by_obj(purc_variant_t l, purc_variant_t r,
         bool caseless, bool unify_number)
@@ -2829,17 +3078,19 @@ cmp_by_obj(purc_variant_t l, purc_variant_t r,
     rd = (variant_obj_t)r->sz_ptr[1];
     PC_ASSERT(ld);
     PC_ASSERT(rd);
-    struct rb_root *lroot = &ld->kvs;
-    struct rb_root *rroot = &rd->kvs;
-    struct rb_node *lnode = pcutils_rbtree_first(lroot);
-    struct rb_node *rnode = pcutils_rbtree_first(rroot);
-    for (;
-        lnode && rnode;
-        lnode = pcutils_rbtree_next(lnode), rnode = pcutils_rbtree_next(rnode))
-    {
-        struct obj_node *lo, *ro;
-        lo = container_of(lnode, struct obj_node, node);
-        ro = container_of(rnode, struct obj_node, node);
+    struct obj_node *lbuf[NR_SORTED_NODES_ON_STACK];
+    struct obj_node *rbuf[NR_SORTED_NODES_ON_STACK];
+    struct obj_node **lnodes, **rnodes;
+    lnodes = pcvar_obj_sorted_nodes(l, lbuf, PCA_TABLESIZE(lbuf));
+    rnodes = pcvar_obj_sorted_nodes(r, rbuf, PCA_TABLESIZE(rbuf));
+    if (lnodes == NULL || rnodes == NULL) {
+        diff = (ld->size < rd->size) ? -1 : 1;
+        goto done;
+    }
+
+    size_t i;
+    for (i = 0; i < ld->size && i < rd->size; i++) {
+        struct obj_node *lo = lnodes[i], *ro = rnodes[i];
         PC_ASSERT(lo->key);
         PC_ASSERT(ro->key);
         const char *lk = purc_variant_get_string_const(lo->key);
@@ -2850,7 +3101,7 @@ cmp_by_obj(purc_variant_t l, purc_variant_t r,
         // NOTE: ignore caseless for keyname
         diff = strcmp(lk, rk);
         if (diff)
-            return diff;
+            goto done;
 
         purc_variant_t lv = lo->val;
         purc_variant_t rv = ro->val;
@@ -2859,15 +3110,22 @@ cmp_by_obj(purc_variant_t l, purc_variant_t r,
 
         diff = pcvar_compare_ex(lv, rv, caseless, unify_number);
         if (diff)
-            return diff;
+            goto done;
     }
 
-    if (lnode)
-        return 1;
-    else if (rnode)
-        return -1;
+    if (i < ld->size)
+        diff = 1;
+    else if (i < rd->size)
+        diff = -1;
     else
-        return 0;
+        diff = 0;
+
+done:
+    if (lnodes && lnodes != lbuf)
+        free(lnodes);
+    if (rnodes && rnodes != rbuf)
+        free(rnodes);
+    return diff;
 }
 
 static int
@@ -2882,23 +3140,10 @@ cmp_by_arr(purc_variant_t l, purc_variant_t r,
     PC_ASSERT(ld);
     PC_ASSERT(rd);
 
-    struct pcutils_array_list *la = &ld->al;
-    struct pcutils_array_list *ra = &rd->al;
-
-    struct pcutils_array_list_node *lnode = pcutils_array_list_get_first(la);
-    struct pcutils_array_list_node *rnode = pcutils_array_list_get_first(ra);
-
-    for (;
-        lnode && rnode;
-        lnode = pcutils_array_list_get(la, lnode->idx + 1),
-        rnode = pcutils_array_list_get(ra, rnode->idx + 1))
-    {
-        struct arr_node *lo, *ro;
-        lo = container_of(lnode, struct arr_node, node);
-        ro = container_of(rnode, struct arr_node, node);
-
-        purc_variant_t lv = lo->val;
-        purc_variant_t rv = ro->val;
+    size_t i;
+    for (i = 0; i < ld->nr_members && i < rd->nr_members; i++) {
+        purc_variant_t lv = ld->members[i];
+        purc_variant_t rv = rd->members[i];
         PC_ASSERT(lv != PURC_VARIANT_INVALID);
         PC_ASSERT(rv != PURC_VARIANT_INVALID);
 
@@ -2907,9 +3152,9 @@ cmp_by_arr(purc_variant_t l, purc_variant_t r,
             return diff;
     }
 
-    if (lnode)
+    if (i < ld->nr_members)
         return 1;
-    else if (rnode)
+    else if (i < rd->nr_members)
         return -1;
     else
         return 0;
@@ -3576,6 +3821,7 @@ void pcvariant_md5_ex(char *md5, purc_variant_t val, const char *salt,
     arg.cb    = do_stringify_md5;
     arg.arg   = &ud;
     arg.flags = serialize_flags;
+    arg.sort_keys = true;
 
     variant_stringify(&arg, val);
 
@@ -3589,108 +3835,137 @@ void pcvariant_md5_ex(char *md5, purc_variant_t val, const char *salt,
     pcutils_bin2hex(md5_digest, MD5_DIGEST_SIZE, md5, uppercase);
 }
 
-void
-pcvariant_md5_by_set(char *md5, purc_variant_t val, purc_variant_t set)
-{
-    PC_ASSERT(md5);
-    PC_ASSERT(val != PURC_VARIANT_INVALID);
-    PC_ASSERT(set != PURC_VARIANT_INVALID);
+/* 64-bit FNV-1a */
+#define HASH64_OFFSET_BASIS     0xcbf29ce484222325ULL
+#define HASH64_PRIME            0x100000001b3ULL
 
-    variant_set_t data = pcvar_set_get_data(set);
-    PC_ASSERT(data);
+struct stringify_hash {
+    uint64_t                  hash;
+    bool                      caseless;
+    /* the comparison stops at the first null character */
+    bool                      ended;
+    /* the caseless text is folded as a whole, for the folding of
+       a character may depend on the following ones */
+    struct pcutils_mystring   text;
+};
 
-    if (data->unique_key == NULL) {
-        pcvariant_md5(md5, val);
-        return;
-    }
+static inline uint64_t
+hash_byte(uint64_t hash, unsigned char c)
+{
+    hash ^= c;
+    hash *= HASH64_PRIME;
+    return hash;
+}
 
-    purc_variant_t undefined = purc_variant_make_undefined();
-    PC_ASSERT(undefined);
+static void
+hash_folded_char(void *ctxt, uint32_t uc)
+{
+    struct stringify_hash *ud = (struct stringify_hash *)ctxt;
+    uint64_t hash = ud->hash;
 
-    if (val->type != PVT(_OBJECT)) {
-        pcvariant_md5(md5, undefined);
-        purc_variant_unref(undefined);
-        return;
+    for (int i = 0; i < 4; i++) {
+        hash = hash_byte(hash, (unsigned char)uc);
+        uc >>= 8;
     }
 
-    pcutils_md5_ctxt ud;
+    ud->hash = hash;
+}
 
-    pcutils_md5_begin(&ud);
+static void
+do_stringify_hash(struct stringify_arg *arg, const void *src, size_t len)
+{
+    struct stringify_hash *ud;
+    ud = (struct stringify_hash*)(arg->arg);
 
-    struct stringify_arg arg;
-    arg.cb    = do_stringify_md5;
-    arg.arg   = &ud;
-    arg.flags = 0;
+    if (ud->ended)
+        return;
 
-    for (size_t i=0; i<data->nr_keynames; ++i) {
-        purc_variant_t v;
-        v = purc_variant_object_get_by_ckey(val, data->keynames[i]);
-        if (v == PURC_VARIANT_INVALID) {
-            v = undefined;
-        }
-        stringify_kv(&arg, data->keynames[i], v);
+    if (len == 0)
+        len = strlen(src);
+
+    const unsigned char *p = (const unsigned char *)src;
+    const void *nul = memchr(p, 0, len);
+    if (nul) {
+        len = (const unsigned char *)nul - p;
+        ud->ended = true;
     }
 
-    unsigned char md5_digest[MD5_DIGEST_SIZE];
-    pcutils_md5_end(&ud, md5_digest);
+    if (ud->caseless) {
+        /* the text is hashed when it is flushed */
+        if (len > 0)
+            pcutils_mystring_append_mchar(&ud->text, p, len);
+        return;
+    }
 
-    bool uppercase = true;
-    pcutils_bin2hex(md5_digest, MD5_DIGEST_SIZE, md5, uppercase);
+    uint64_t hash = ud->hash;
+    for (size_t i = 0; i < len; i++)
+        hash = hash_byte(hash, p[i]);
 
-    purc_variant_unref(undefined);
+    ud->hash = hash;
 }
 
-int
-pcvariant_diff_by_set(const char *md5l, purc_variant_t l,
-        const char *md5r, purc_variant_t r, purc_variant_t set)
+/* hashes the buffered caseless text in the same way as it is compared */
+static void
+stringify_hash_flush(struct stringify_hash *ud)
 {
-    // TODO: https://gitlab.fmsoft.cn/hvml/hvml-docs/-/blob/master/zh/hvml-spec-v1.0-zh.md#21610-%E9%9B%86%E5%90%88%E5%8F%98%E9%87%8F
+    if (!ud->caseless || ud->text.nr_bytes == 0)
+        return;
 
-    PC_ASSERT(md5l);
-    PC_ASSERT(l != PURC_VARIANT_INVALID);
-    PC_ASSERT(md5r);
-    PC_ASSERT(r != PURC_VARIANT_INVALID);
+    if (pcutils_mystring_done(&ud->text) == 0)
+        pcutils_utf8_casefold(ud->text.buff, hash_folded_char, ud);
 
-    PC_ASSERT(set != PURC_VARIANT_INVALID);
+    pcutils_mystring_free(&ud->text);
+    pcutils_mystring_init(&ud->text);
+}
 
-    int diff;
+uint64_t
+pcvariant_hash_by_set(purc_variant_t val, purc_variant_t set)
+{
+    PC_ASSERT(val != PURC_VARIANT_INVALID);
+    PC_ASSERT(set != PURC_VARIANT_INVALID);
 
     variant_set_t data = pcvar_set_get_data(set);
     PC_ASSERT(data);
 
-    if (data->unique_key == NULL) {
-        return pcvariant_diff(l, r);
-    }
+    struct stringify_hash ud = {
+        .hash             = HASH64_OFFSET_BASIS,
+        .caseless         = data->caseless,
+        .ended            = false,
+    };
+    pcutils_mystring_init(&ud.text);
 
-    diff = strcmp(md5l, md5r);
-    if (diff)
-        return diff;
+    struct stringify_arg arg;
+    arg.cb    = do_stringify_hash;
+    arg.arg   = &ud;
+    arg.flags = 0;
+    arg.sort_keys = true;
 
-    purc_variant_t undefined = purc_variant_make_undefined();
-    PC_ASSERT(undefined);
+    if (data->unique_key == NULL) {
+        variant_stringify(&arg, val);
+        stringify_hash_flush(&ud);
+        return ud.hash;
+    }
 
     for (size_t i=0; i<data->nr_keynames; ++i) {
-        purc_variant_t vl = PURC_VARIANT_INVALID;
-        purc_variant_t vr = PURC_VARIANT_INVALID;
-
-        if (l->type == PVT(_OBJECT))
-            vl = purc_variant_object_get_by_ckey(l, data->keynames[i]);
-        if (r->type == PVT(_OBJECT))
-            vr = purc_variant_object_get_by_ckey(r, data->keynames[i]);
+        purc_variant_t v = PURC_VARIANT_INVALID;
+        if (val->type == PVT(_OBJECT)) {
+            v = purc_variant_object_get_by_ckey(val, data->keynames[i]);
+            if (v == PURC_VARIANT_INVALID)
+                purc_clr_error();
+        }
 
-        if (vl == PURC_VARIANT_INVALID)
-            vl = undefined;
-        if (vr == PURC_VARIANT_INVALID)
-            vr = undefined;
+        /* the values of the unique keys are compared one by one */
+        ud.ended = false;
+        if (v == PURC_VARIANT_INVALID)
+            arg.cb(&arg, "undefined", 0);
+        else
+            variant_stringify(&arg, v);
 
-        diff = pcvariant_diff(vl, vr);
-        if (diff)
-            break;
+        stringify_hash_flush(&ud);
+        ud.hash = hash_byte(ud.hash, '\n');
     }
 
-    purc_variant_unref(undefined);
-
-    return diff;
+    return ud.hash;
 }
 
 bool pcvariant_is_scalar(purc_variant_t v)
@@ -28,34 +28,51 @@ static int
 parallel_walk(purc_variant_t l, purc_variant_t r, void *ctxt,
         int (*cb)(purc_variant_t l, purc_variant_t r, void *ctxt));
 
+#define NR_SORTED_NODES_ON_STACK    16
+
+/* walks the members of two objects in the order of keys */
 static int
 obj_parallel_walk(purc_variant_t l, purc_variant_t r, void *ctxt,
         int (*cb)(purc_variant_t l, purc_variant_t r, void *ctxt))
 {
-    struct obj_iterator lit, rit;
-    lit = pcvar_obj_it_first(l);
-    rit = pcvar_obj_it_first(r);
+    struct obj_node *lbuf[NR_SORTED_NODES_ON_STACK];
+    struct obj_node *rbuf[NR_SORTED_NODES_ON_STACK];
+    struct obj_node **ln, **rn;
+    size_t lsz = purc_variant_object_get_size(l);
+    size_t rsz = purc_variant_object_get_size(r);
+
+    ln = pcvar_obj_sorted_nodes(l, lbuf, PCA_TABLESIZE(lbuf));
+    rn = pcvar_obj_sorted_nodes(r, rbuf, PCA_TABLESIZE(rbuf));
+
+    int ret = 0;
+    size_t i = 0;
+    if (ln == NULL || rn == NULL) {
+        /* compare two different nodes to report the difference */
+        ret = cb(l, PURC_VARIANT_INVALID, ctxt);
+        goto done;
+    }
 
-    while (lit.curr && rit.curr) {
-        int r = cb(lit.curr->key, rit.curr->key, ctxt);
-        if (r)
-            return r;
+    for (; i < lsz && i < rsz; i++) {
+        ret = cb(ln[i]->key, rn[i]->key, ctxt);
+        if (ret)
+            goto done;
 
-        r = parallel_walk(lit.curr->val, rit.curr->val, ctxt, cb);
-        if (r)
-            return r;
-
-        pcvar_obj_it_next(&lit);
-        pcvar_obj_it_next(&rit);
+        ret = parallel_walk(ln[i]->val, rn[i]->val, ctxt, cb);
+        if (ret)
+            goto done;
     }
 
-    if (lit.curr == NULL && rit.curr == NULL)
-        return 0;
-
-    if (lit.curr)
-        return parallel_walk(lit.curr->val, PURC_VARIANT_INVALID, ctxt, cb);
-    else
-        return parallel_walk(PURC_VARIANT_INVALID, rit.curr->val, ctxt, cb);
+    if (i < lsz)
+        ret = parallel_walk(ln[i]->val, PURC_VARIANT_INVALID, ctxt, cb);
+    else if (i < rsz)
+        ret = parallel_walk(PURC_VARIANT_INVALID, rn[i]->val, ctxt, cb);
+
+done:
+    if (ln && ln != lbuf)
+        free(ln);
+    if (rn && rn != rbuf)
+        free(rn);
+    return ret;
 }
 
 static int
@@ -67,7 +84,7 @@ arr_parallel_walk(purc_variant_t l, purc_variant_t r, void *ctxt,
     rit = pcvar_arr_it_first(r);
 
     while (lit.curr && rit.curr) {
-        int r = parallel_walk(lit.curr->val, rit.curr->val, ctxt, cb);
+        int r = parallel_walk(lit.curr, rit.curr, ctxt, cb);
         if (r)
             return r;
 
@@ -79,9 +96,9 @@ arr_parallel_walk(purc_variant_t l, purc_variant_t r, void *ctxt,
         return 0;
 
     if (lit.curr)
-        return parallel_walk(lit.curr->val, PURC_VARIANT_INVALID, ctxt, cb);
+        return parallel_walk(lit.curr, PURC_VARIANT_INVALID, ctxt, cb);
     else
-        return parallel_walk(PURC_VARIANT_INVALID, rit.curr->val, ctxt, cb);
+        return parallel_walk(PURC_VARIANT_INVALID, rit.curr, ctxt, cb);
 }
 
 static int
@@ -71,6 +71,7 @@ pcvcm_eval_stack_frame_create(struct pcvcm_node *node, size_t return_pos)
         purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
         goto out_destroy_frame;
     }
+    frame->variables->transient = 1;
 
     frame->node = node;
     frame->pos = 0;
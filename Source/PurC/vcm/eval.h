@@ -180,6 +180,11 @@ purc_variant_t pcvcm_eval_again_full(struct pcvcm_node *tree,
 purc_variant_t pcvcm_eval_sub_expr_full(struct pcvcm_node *tree,
         struct pcvcm_eval_ctxt *ctxt, purc_variant_t args, bool silently);
 
+/* find the variable named `name` for the `getVariable` node */
+purc_variant_t
+pcvcm_eval_find_var(struct pcvcm_eval_ctxt *ctxt, struct pcvcm_node *node,
+        const char *name);
+
 #ifdef __cplusplus
 }
 #endif  /* __cplusplus */
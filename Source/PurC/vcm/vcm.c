@@ -509,6 +509,48 @@ void pcvcm_node_destroy(struct pcvcm_node *root)
     }
 }
 
+struct pcvcm_node *
+pcvcm_node_clone(struct pcvcm_node *node)
+{
+    struct pcvcm_node *n = pcvcm_node_new(node->type, node->is_closed);
+    if (!n) {
+        return NULL;
+    }
+
+    /* copy the value, but not the links in the tree and the result */
+    memcpy(n, node, sizeof(*n));
+    memset(&n->tree_node, 0, sizeof(n->tree_node));
+    n->attach = 0;
+
+    if ((node->type == PCVCM_NODE_TYPE_STRING
+                || node->type == PCVCM_NODE_TYPE_BYTE_SEQUENCE
+        ) && node->sz_ptr[1]) {
+        size_t nr_bytes = node->sz_ptr[0];
+        uint8_t *buf = (uint8_t*)malloc(nr_bytes + 1);
+        if (!buf) {
+            pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
+            free(n);
+            return NULL;
+        }
+        memcpy(buf, (const void *)node->sz_ptr[1], nr_bytes);
+        buf[nr_bytes] = 0;
+        n->sz_ptr[1] = (uintptr_t)buf;
+    }
+
+    struct pcvcm_node *child = pcvcm_node_first_child(node);
+    while (child) {
+        struct pcvcm_node *cloned = pcvcm_node_clone(child);
+        if (!cloned) {
+            pcvcm_node_destroy(n);
+            return NULL;
+        }
+        pcvcm_node_append_child(n, cloned);
+        child = (struct pcvcm_node *)pctree_node_next(&child->tree_node);
+    }
+
+    return n;
+}
+
 static inline bool
 is_digit(char c)
 {
@@ -548,6 +590,24 @@ find_stack_var(void *ctxt, const char *name)
     return pcintr_find_named_var(ctxt, name);
 }
 
+purc_variant_t
+pcvcm_eval_find_var(struct pcvcm_eval_ctxt *ctxt, struct pcvcm_node *node,
+        const char *name)
+{
+    /* the resolution of a constant name of a named stack variable is
+       cached by the stack for the node */
+    if (ctxt->find_var == find_stack_var && name[0] && !is_digit(name[0]) &&
+            name[0] != '#' && !(name[1] == 0 && purc_ispunct(name[0]))) {
+        struct pcvcm_node *child = pcvcm_node_first_child(node);
+        if (child && child->type == PCVCM_NODE_TYPE_STRING) {
+            return pcintr_find_named_var_at_site(ctxt->find_var_ctxt, name,
+                    node);
+        }
+    }
+
+    return ctxt->find_var(ctxt->find_var_ctxt, name);
+}
+
 purc_variant_t
 pcvcm_eval(struct pcvcm_node *tree, struct pcintr_stack *stack, bool silently)
 {
@@ -81,6 +81,10 @@ struct pcvdom_document {
 
     atomic_ulong            refc;
 
+    // the documents derived from this one, e.g., for concurrent calls;
+    // created on demand.
+    _Atomic(struct pcutils_map *) derived_docs;
+
     unsigned int            quirks:1;
 };
 
@@ -110,6 +114,12 @@ struct pcvdom_element {
 
     pcutils_array_t        *attrs;
 
+    // the attribute giving the anchor of the element: `idd-by` for
+    // the verb and template elements, `id` for the others.
+    struct pcvdom_attr     *anchor_attr;
+    // the value of the anchor attribute if it is a constant string
+    const char             *static_anchor;
+
     unsigned int            self_closing:1;
 };
 
@@ -29,6 +29,7 @@
 #include "private/utils.h"
 #include "private/vdom.h"
 #include "private/stringbuilder.h"
+#include "private/map.h"
 
 #include "hvml-attr.h"
 
@@ -342,6 +343,31 @@ pcvdom_document_append_comment(struct pcvdom_document *doc,
     return 0;
 }
 
+#define ATTR_KEY_ID             "id"
+#define ATTR_KEY_IDD_BY         "idd-by"
+
+/* keep the anchor attribute, and its value if it is a constant string,
+   so that the anchor of the element can be matched without evaluating */
+static void
+check_anchor_attr(struct pcvdom_element *elem, struct pcvdom_attr *attr)
+{
+    const char *key = ATTR_KEY_ID;
+    const struct pchvml_tag_entry *entry;
+    entry = pchvml_tag_static_search(elem->tag_name, strlen(elem->tag_name));
+    if (entry &&
+            (entry->cats & (PCHVML_TAGCAT_TEMPLATE | PCHVML_TAGCAT_VERB))) {
+        key = ATTR_KEY_IDD_BY;
+    }
+
+    if (strcmp(attr->key, key))
+        return;
+
+    elem->anchor_attr = attr;
+    if (attr->val && attr->val->type == PCVCM_NODE_TYPE_STRING) {
+        elem->static_anchor = (const char *)attr->val->sz_ptr[1];
+    }
+}
+
 int
 pcvdom_element_append_attr(struct pcvdom_element *elem,
         struct pcvdom_attr *attr)
@@ -358,6 +384,8 @@ pcvdom_element_append_attr(struct pcvdom_element *elem,
     PC_ASSERT(r==0);
 
     attr->parent = elem;
+    if (elem->anchor_attr == NULL)
+        check_anchor_attr(elem, attr);
 
     return 0;
 }
@@ -626,6 +654,177 @@ pcvdom_node_destroy(struct pcvdom_node *node)
     vdom_node_destroy(node);
 }
 
+static struct pcvdom_attr*
+attr_clone(struct pcvdom_attr *attr)
+{
+    struct pcvdom_attr *clone = attr_create();
+    if (!clone)
+        return NULL;
+
+    clone->op = attr->op;
+    clone->pre_defined = attr->pre_defined;
+    if (attr->pre_defined) {
+        clone->key = (char*)attr->pre_defined->name;
+    } else {
+        clone->key = strdup(attr->key);
+        if (!clone->key) {
+            pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
+            attr_destroy(clone);
+            return NULL;
+        }
+    }
+
+    if (attr->val) {
+        clone->val = pcvcm_node_clone(attr->val);
+        if (!clone->val) {
+            attr_destroy(clone);
+            return NULL;
+        }
+    }
+
+    return clone;
+}
+
+static struct pcvdom_element*
+element_clone(struct pcvdom_element *elem)
+{
+    struct pcvdom_element *clone = element_create();
+    if (!clone)
+        return NULL;
+
+    clone->tag_id = elem->tag_id;
+    if (elem->tag_id == VTT(_UNDEF)) {
+        clone->tag_name = strdup(elem->tag_name);
+        if (!clone->tag_name) {
+            pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
+            goto failed;
+        }
+    } else {
+        clone->tag_name = elem->tag_name;
+    }
+    clone->self_closing = elem->self_closing;
+
+    size_t nr = pcutils_array_length(elem->attrs);
+    for (size_t i = 0; i < nr; i++) {
+        struct pcvdom_attr *attr;
+        attr = attr_clone(pcutils_array_get(elem->attrs, i));
+        if (!attr)
+            goto failed;
+
+        pcvdom_element_append_attr(clone, attr);
+    }
+
+    struct pcvdom_node *child = pcvdom_node_first_child(&elem->node);
+    for (; child; child = pcvdom_node_next_sibling(child)) {
+        struct pcvdom_node *node = pcvdom_node_clone(child);
+        if (!node)
+            goto failed;
+
+        bool b = pctree_node_append_child(&clone->node.node, &node->node);
+        PC_ASSERT(b);
+    }
+
+    return clone;
+
+failed:
+    element_destroy(clone);
+    return NULL;
+}
+
+struct pcvdom_node*
+pcvdom_node_clone(struct pcvdom_node *node)
+{
+    struct pcvdom_element *elem;
+    struct pcvdom_content *content;
+    struct pcvdom_comment *comment;
+
+    switch (node->type) {
+    case VDT(ELEMENT):
+        elem = element_clone(PCVDOM_ELEMENT_FROM_NODE(node));
+        return elem ? &elem->node : NULL;
+
+    case VDT(CONTENT):
+        content = PCVDOM_CONTENT_FROM_NODE(node);
+        struct pcvcm_node *vcm = pcvcm_node_clone(content->vcm);
+        if (!vcm)
+            return NULL;
+        content = content_create(vcm);
+        if (!content) {
+            pcvcm_node_destroy(vcm);
+            return NULL;
+        }
+        return &content->node;
+
+    case VDT(COMMENT):
+        comment = comment_create(PCVDOM_COMMENT_FROM_NODE(node)->text);
+        return comment ? &comment->node : NULL;
+
+    default:
+        break;
+    }
+
+    pcinst_set_error(PURC_ERROR_NOT_SUPPORTED);
+    return NULL;
+}
+
+static void
+free_derived_doc(void *val)
+{
+    pcvdom_document_unref(val);
+}
+
+struct pcvdom_document*
+pcvdom_document_find_derived(struct pcvdom_document *doc, const char *key)
+{
+    struct pcvdom_document *derived = NULL;
+    struct pcutils_map *derived_docs = atomic_load(&doc->derived_docs);
+
+    if (derived_docs) {
+        pcutils_map_entry *entry;
+        entry = pcutils_map_find_and_lock(derived_docs, key);
+        if (entry) {
+            derived = entry->val;
+            pcutils_map_unlock(derived_docs);
+        }
+    }
+
+    return derived;
+}
+
+struct pcvdom_document*
+pcvdom_document_cache_derived(struct pcvdom_document *doc, const char *key,
+        struct pcvdom_document *derived)
+{
+    struct pcutils_map *derived_docs = atomic_load(&doc->derived_docs);
+
+    if (derived_docs == NULL) {
+        struct pcutils_map *map = pcutils_map_create(copy_key_string,
+                free_key_string, NULL, free_derived_doc, comp_key_string, true);
+        if (map == NULL) {
+            pcvdom_document_unref(derived);
+            pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
+            return NULL;
+        }
+
+        /* the document may be shared by the coroutines in other runners */
+        if (atomic_compare_exchange_strong(&doc->derived_docs,
+                    &derived_docs, map)) {
+            derived_docs = map;
+        }
+        else {
+            pcutils_map_destroy(map);
+        }
+    }
+
+    pcvdom_document_ref(derived);
+    if (pcutils_map_insert(derived_docs, key, derived) == 0)
+        return derived;
+
+    /* another one was cached meanwhile; use it and discard ours */
+    pcvdom_document_unref(derived);
+    return pcvdom_document_find_derived(doc, key);
+}
+
 
 
 // traverse all vdom_node
@@ -1018,6 +1217,11 @@ document_reset(struct pcvdom_document *doc)
 static void
 document_destroy(struct pcvdom_document *doc)
 {
+    struct pcutils_map *derived_docs = atomic_load(&doc->derived_docs);
+    if (derived_docs) {
+        pcutils_map_destroy(derived_docs);
+    }
+
     document_reset(doc);
     PC_ASSERT(doc->node.node.first_child == NULL);
     free(doc);
@@ -1366,6 +1570,15 @@ out:
     return attr;
 }
 
+struct pcvdom_attr*
+pcvdom_element_anchor_attr(struct pcvdom_element *element,
+        const char **static_anchor)
+{
+    if (static_anchor)
+        *static_anchor = element->static_anchor;
+    return element->anchor_attr;
+}
+
 purc_variant_t
 pcvdom_element_eval_attr_val(pcintr_stack_t stack, pcvdom_element_t element,
         const char *key)
@@ -96,6 +96,11 @@ public:
 #if USE(GLIB_EVENT_LOOP)
     WTF_EXPORT_PRIVATE GMainContext* mainContext() const { return m_mainContext.get(); }
     WTF_EXPORT_PRIVATE void setIdleCallback(PurCWTF::Function<void()>&& function);
+    // Called from the idle callback: do not call it again until
+    // resumeIdleCallback() is called or the timeout elapses.
+    WTF_EXPORT_PRIVATE void suspendIdleCallback(Seconds timeout);
+    // Thread-safe.
+    WTF_EXPORT_PRIVATE void resumeIdleCallback();
     WTF_EXPORT_PRIVATE uintptr_t addFdMonitor(gint fd, GIOCondition condition,
             Function<gboolean(gint, GIOCondition)>&& callback);
     WTF_EXPORT_PRIVATE void removeFdMonitor(uintptr_t handle);
@@ -239,6 +244,13 @@ private:
 
     GRefPtr<GSource> m_idleSource;
     Function<void()> m_idleCallback;
+    void rearmIdleSource();
+
+    Lock m_idleLock;
+    bool m_idleSuspendRequested { false };
+    bool m_idleResumeRequested { false };
+    bool m_idleSuspended { false };
+    Seconds m_idleTimeout;
 
     Vector<RefPtr<GFdMonitor>> m_fdMonitors;
 #elif USE(GENERIC_EVENT_LOOP)
@@ -71,15 +71,25 @@ RunLoop::RunLoop()
     }, this, nullptr);
     g_source_attach(m_source.get(), m_mainContext.get());
 
-    m_idleSource = adoptGRef(g_idle_source_new());
+    // The idle source is driven by its ready time: it is always ready unless
+    // the idle callback suspends itself, in which case the main context can
+    // block in poll() until resumeIdleCallback() or the timeout.
+    m_idleSource = adoptGRef(g_source_new(&runLoopSourceFunctions, sizeof(GSource)));
     g_source_set_priority(m_idleSource.get(), RunLoopSourcePriority::RunLoopDispatcher);
     g_source_set_name(m_idleSource.get(), "[PurCFetcher] RunLoop idle");
     g_source_set_can_recurse(m_idleSource.get(), TRUE);
     g_source_set_callback(m_idleSource.get(), [](gpointer userData) -> gboolean {
         RunLoop* runloop = static_cast<RunLoop*>(userData);
+        {
+            auto locker = holdLock(runloop->m_idleLock);
+            runloop->m_idleSuspendRequested = false;
+            runloop->m_idleResumeRequested = false;
+            runloop->m_idleSuspended = false;
+        }
         if (runloop->m_idleCallback) {
             runloop->m_idleCallback();
         }
+        runloop->rearmIdleSource();
         return G_SOURCE_CONTINUE;
     }, this, nullptr);
 }
@@ -101,10 +111,52 @@ void RunLoop::setIdleCallback(PurCWTF::Function<void()>&& function)
     RunLoop& runloop = RunLoop::current();
     runloop.m_idleCallback = WTFMove(function);
     if (runloop.m_idleCallback && runloop.m_idleSource->context == NULL) {
+        g_source_set_ready_time(runloop.m_idleSource.get(), 0);
         g_source_attach(runloop.m_idleSource.get(), runloop.m_mainContext.get());
     }
 }
 
+void RunLoop::suspendIdleCallback(Seconds timeout)
+{
+    auto locker = holdLock(m_idleLock);
+    m_idleSuspendRequested = true;
+    m_idleTimeout = timeout;
+}
+
+void RunLoop::resumeIdleCallback()
+{
+    auto locker = holdLock(m_idleLock);
+    if (m_idleSuspended) {
+        m_idleSuspended = false;
+        g_source_set_ready_time(m_idleSource.get(), 0);
+    }
+    else {
+        // the idle callback is running or about to run; make sure it will
+        // not suspend itself after this call.
+        m_idleResumeRequested = true;
+    }
+}
+
+void RunLoop::rearmIdleSource()
+{
+    auto locker = holdLock(m_idleLock);
+    if (!m_idleSuspendRequested || m_idleResumeRequested) {
+        g_source_set_ready_time(m_idleSource.get(), 0);
+        return;
+    }
+
+    m_idleSuspended = true;
+    if (m_idleTimeout == Seconds::infinity()) {
+        g_source_set_ready_time(m_idleSource.get(), -1);
+        return;
+    }
+
+    gint64 currentTime = g_get_monotonic_time();
+    gint64 timeout = std::max<gint64>(0, m_idleTimeout.microsecondsAs<gint64>());
+    gint64 targetTime = currentTime + std::min<gint64>(G_MAXINT64 - currentTime, timeout);
+    g_source_set_ready_time(m_idleSource.get(), targetTime);
+}
+
 uintptr_t RunLoop::addFdMonitor(gint fd, GIOCondition condition,
             Function<gboolean(gint, GIOCondition)>&& callback)
 {
@@ -97,6 +97,7 @@ macro(PURC_OPTION_BEGIN)
     PURC_OPTION_DEFINE(ENABLE_API_TESTS "Enable public API unit tests" PUBLIC ON)
     PURC_OPTION_DEFINE(ENABLE_DEVELOPER_MODE "Toggle developer mode" PUBLIC OFF)
     PURC_OPTION_DEFINE(ENABLE_RDR_FOIL "Toggle the built-in `foil` renderer in `purc`" PUBLIC ON)
+    PURC_OPTION_DEFINE(ENABLE_LOCKFREE_MSG_QUEUE "Toggle the lock-free message queues of coroutines" PUBLIC OFF)
 
     PURC_OPTION_DEFINE(USE_SYSTEM_MALLOC "Toggle system allocator instead of PurC's custom allocator" PUBLIC ${USE_SYSTEM_MALLOC_DEFAULT})
     PURC_OPTION_DEFINE(ENABLE_ICU "Enable icu" PUBLIC OFF)
@@ -903,6 +903,143 @@ TEST(dvobjs, dvobjs_math_assignment)
     purc_cleanup ();
 }
 
+struct test_reduce {
+    const char      *func;
+    const char      *arg1;
+    const char      *arg2;
+    double           result;
+};
+
+TEST(dvobjs, dvobjs_math_reduce)
+{
+    static const struct test_reduce cases[] = {
+        { "sum", "[1, 2, 3, 4, 5]", NULL, 15.0 },
+        { "sum", "[]", NULL, 0.0 },
+        { "min", "[3, -2.5, 7, 1]", NULL, -2.5 },
+        { "max", "[3, -2.5, 7, 1]", NULL, 7.0 },
+        { "avg", "[1, 2, 3, 4]", NULL, 2.5 },
+        { "dot", "[1, 2, 3]", "[4, 5, 6]", 32.0 },
+        { "min", "[]", NULL, NAN },
+        { "dot", "[1, 2]", "[1, 2, 3]", NAN },
+    };
+
+    purc_instance_extra_info info = {};
+    int ret = purc_init_ex(PURC_MODULE_EJSON, "cn.fmsoft.hvml.test",
+            "dvobjs", &info);
+    ASSERT_EQ (ret, PURC_ERROR_OK);
+
+    setenv(PURC_ENVV_DVOBJS_PATH, SOPATH, 1);
+    purc_variant_t math = purc_variant_load_dvobj_from_so (NULL, "MATH");
+    ASSERT_NE(math, nullptr);
+
+    for (size_t i = 0; i < PCA_TABLESIZE(cases); i++) {
+        purc_variant_t dynamic;
+        dynamic = purc_variant_object_get_by_ckey (math, cases[i].func);
+        ASSERT_NE(dynamic, nullptr);
+
+        purc_dvariant_method func = purc_variant_dynamic_get_getter (dynamic);
+        ASSERT_NE(func, nullptr);
+
+        purc_variant_t param[2];
+        size_t nr_params = cases[i].arg2 ? 2 : 1;
+        param[0] = purc_variant_make_from_json_string(cases[i].arg1,
+                strlen(cases[i].arg1));
+        param[1] = cases[i].arg2 ? purc_variant_make_from_json_string(
+                cases[i].arg2, strlen(cases[i].arg2)) : PURC_VARIANT_INVALID;
+
+        purc_variant_t ret_var = func(NULL, nr_params, param, 0);
+        if (isnan(cases[i].result)) {
+            ASSERT_EQ(ret_var, nullptr) << cases[i].func << cases[i].arg1;
+        }
+        else {
+            double d;
+            ASSERT_NE(ret_var, nullptr) << cases[i].func << cases[i].arg1;
+            ASSERT_TRUE(purc_variant_cast_to_number(ret_var, &d, false));
+            ASSERT_EQ(d, cases[i].result) << cases[i].func << cases[i].arg1;
+            purc_variant_unref(ret_var);
+        }
+
+        for (size_t j = 0; j < nr_params; j++)
+            purc_variant_unref(param[j]);
+    }
+
+    purc_variant_unload_dvobj (math);
+    purc_cleanup ();
+}
+
+TEST(dvobjs, dvobjs_math_packed)
+{
+    purc_instance_extra_info info = {};
+    int ret = purc_init_ex(PURC_MODULE_EJSON, "cn.fmsoft.hvml.test",
+            "dvobjs", &info);
+    ASSERT_EQ (ret, PURC_ERROR_OK);
+
+    setenv(PURC_ENVV_DVOBJS_PATH, SOPATH, 1);
+    purc_variant_t math = purc_variant_load_dvobj_from_so (NULL, "MATH");
+    ASSERT_NE(math, nullptr);
+
+    const char *json = "[1, 2, 3, 4]";
+    purc_variant_t arr = purc_variant_make_from_json_string(json,
+            strlen(json));
+    purc_variant_t f64s = purc_variant_make_packed_array(
+            PCVRNT_PACKED_TYPE_F64, arr);
+    purc_variant_t i64s = purc_variant_make_packed_array(
+            PCVRNT_PACKED_TYPE_I64, arr);
+    purc_variant_t i64 = purc_variant_make_string("i64", false);
+    ASSERT_NE(f64s, nullptr);
+    ASSERT_NE(i64s, nullptr);
+
+    purc_variant_t dynamic;
+    purc_dvariant_method func;
+    purc_variant_t param[3];
+    purc_variant_t ret_var;
+    double d;
+
+    /* the numbers are packed as doubles by default */
+    dynamic = purc_variant_object_get_by_ckey (math, "sum");
+    func = purc_variant_dynamic_get_getter (dynamic);
+    param[0] = f64s;
+    ret_var = func(NULL, 1, param, 0);
+    ASSERT_NE(ret_var, nullptr);
+    ASSERT_TRUE(purc_variant_cast_to_number(ret_var, &d, false));
+    ASSERT_EQ(d, 10.0);
+    purc_variant_unref(ret_var);
+
+    dynamic = purc_variant_object_get_by_ckey (math, "avg");
+    func = purc_variant_dynamic_get_getter (dynamic);
+    param[0] = i64s;
+    param[1] = i64;
+    ret_var = func(NULL, 2, param, 0);
+    ASSERT_NE(ret_var, nullptr);
+    ASSERT_TRUE(purc_variant_cast_to_number(ret_var, &d, false));
+    ASSERT_EQ(d, 2.5);
+    purc_variant_unref(ret_var);
+
+    dynamic = purc_variant_object_get_by_ckey (math, "dot");
+    func = purc_variant_dynamic_get_getter (dynamic);
+    param[0] = i64s;
+    param[1] = i64s;
+    param[2] = i64;
+    ret_var = func(NULL, 3, param, 0);
+    ASSERT_NE(ret_var, nullptr);
+    ASSERT_TRUE(purc_variant_cast_to_number(ret_var, &d, false));
+    ASSERT_EQ(d, 30.0);
+    purc_variant_unref(ret_var);
+
+    /* a packed array and a boxed array can not be mixed */
+    param[1] = arr;
+    ret_var = func(NULL, 3, param, 0);
+    ASSERT_EQ(ret_var, nullptr);
+
+    purc_variant_unref(i64);
+    purc_variant_unref(i64s);
+    purc_variant_unref(f64s);
+    purc_variant_unref(arr);
+
+    purc_variant_unload_dvobj (math);
+    purc_cleanup ();
+}
+
 struct test_sample {
     const char      *expr;
     const char      *result;
@@ -0,0 +1,169 @@
+/*
+** Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+**
+** This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * The benchmark of the message queue of coroutines: several producer
+ * threads append messages to one queue, and the main thread takes them
+ * away. It reports the number of messages per second and the latency
+ * from appending to taking a message.
+ *
+ * Build PurC with and without ENABLE_LOCKFREE_MSG_QUEUE to compare
+ * the lock-free and the locked implementations.
+ *
+ * Usage: bench_msg_queue [<producers> [<messages per producer>]]
+ */
+
+#include "purc/purc.h"
+#include "config.h"
+#include "private/msg-queue.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+
+#define DEF_NR_PRODUCERS    4
+#define DEF_NR_MSGS         200000
+
+#if ENABLE(LOCKFREE_MSG_QUEUE)
+#define IMPLEMENTATION      "lock-free"
+#else
+#define IMPLEMENTATION      "locked"
+#endif
+
+struct producer {
+    pthread_t                   thread;
+    struct pcinst_msg_queue    *queue;
+    pcrdr_msg                 **msgs;
+    size_t                      nr_msgs;
+};
+
+static uint64_t
+now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void *
+producer_entry(void *arg)
+{
+    struct producer *producer = arg;
+
+    for (size_t i = 0; i < producer->nr_msgs; i++) {
+        pcrdr_msg *msg = producer->msgs[i];
+        /* the void messages are not touched by the queue */
+        msg->resultValue = now_ns();
+        pcinst_msg_queue_append(producer->queue, msg);
+    }
+
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    size_t nr_producers = DEF_NR_PRODUCERS;
+    size_t nr_msgs = DEF_NR_MSGS;
+
+    if (argc > 1)
+        nr_producers = strtoul(argv[1], NULL, 10);
+    if (argc > 2)
+        nr_msgs = strtoul(argv[2], NULL, 10);
+    if (nr_producers == 0 || nr_msgs == 0) {
+        fprintf(stderr, "Usage: %s [<producers> [<messages>]]\n", argv[0]);
+        return 1;
+    }
+
+    int ret = purc_init_ex(PURC_MODULE_VARIANT, "cn.fmsoft.hvml.test",
+            "bench_msg_queue", NULL);
+    if (ret != PURC_ERROR_OK) {
+        fprintf(stderr, "Failed to initialize PurC: %d\n", ret);
+        return 1;
+    }
+
+    struct pcinst_msg_queue *queue = pcinst_msg_queue_create();
+    struct producer *producers = calloc(nr_producers, sizeof(*producers));
+    if (queue == NULL || producers == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    /* make the messages in advance to measure the queue only */
+    for (size_t i = 0; i < nr_producers; i++) {
+        producers[i].queue = queue;
+        producers[i].nr_msgs = nr_msgs;
+        producers[i].msgs = malloc(sizeof(pcrdr_msg *) * nr_msgs);
+        if (producers[i].msgs == NULL) {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+
+        for (size_t j = 0; j < nr_msgs; j++) {
+            producers[i].msgs[j] = pcrdr_make_void_message();
+            if (producers[i].msgs[j] == NULL) {
+                fprintf(stderr, "Failed to make message\n");
+                return 1;
+            }
+        }
+    }
+
+    size_t total = nr_producers * nr_msgs;
+    size_t nr_taken = 0;
+    uint64_t sum_latency = 0, max_latency = 0;
+
+    uint64_t begin = now_ns();
+    for (size_t i = 0; i < nr_producers; i++) {
+        pthread_create(&producers[i].thread, NULL, producer_entry,
+                producers + i);
+    }
+
+    while (nr_taken < total) {
+        pcrdr_msg *msg = pcinst_msg_queue_get_msg(queue);
+        if (msg == NULL)
+            continue;
+
+        uint64_t latency = now_ns() - msg->resultValue;
+        sum_latency += latency;
+        if (latency > max_latency)
+            max_latency = latency;
+        pcrdr_release_message(msg);
+        nr_taken++;
+    }
+    uint64_t elapsed = now_ns() - begin;
+
+    for (size_t i = 0; i < nr_producers; i++) {
+        pthread_join(producers[i].thread, NULL);
+        free(producers[i].msgs);
+    }
+
+    printf("implementation:   %s\n", IMPLEMENTATION);
+    printf("producers:        %zu\n", nr_producers);
+    printf("messages:         %zu\n", total);
+    printf("elapsed:          %.3f ms\n", elapsed / 1E6);
+    printf("throughput:       %.0f msgs/s\n", total / (elapsed / 1E9));
+    printf("average latency:  %.3f us\n", sum_latency / 1E3 / total);
+    printf("max latency:      %.3f us\n", max_latency / 1E3);
+
+    pcinst_msg_queue_destroy(queue);
+    free(producers);
+
+    purc_cleanup();
+    return 0;
+}
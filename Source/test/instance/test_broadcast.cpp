@@ -0,0 +1,248 @@
+/*
+** Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+**
+** This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "purc/purc.h"
+
+#include <stdio.h>
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <unistd.h>
+#include <fcntl.h>           /* For O_* constants */
+#include <gtest/gtest.h>
+#include <wtf/Compiler.h>
+
+#define NR_RECEIVERS        4
+#define NR_MEMBERS          3
+
+static volatile purc_atom_t receiver_inst[NR_RECEIVERS];
+static volatile purc_atom_t main_inst;
+static pthread_t receiver_threads[NR_RECEIVERS];
+
+/* the receivers other than the first one wait on this semaphore before
+   taking the broadcast message, so they take it after the first receiver
+   changed its payload */
+static sem_t *go;
+
+struct receiver_arg {
+    sem_t  *wait;
+    int     nr;
+};
+
+static pcrdr_msg *wait_for_message(void)
+{
+    size_t n;
+
+    do {
+        if (purc_inst_holding_messages_count(&n))
+            return NULL;
+        if (n > 0)
+            return purc_inst_take_away_message(0);
+        usleep(10000);  // 10ms
+    } while (true);
+
+    return NULL;
+}
+
+/* returns the number of members in the payload after the receiver is done
+   with it; 0 if the payload is not a mutable array. */
+static uint64_t check_payload(int nr, purc_variant_t data)
+{
+    if (data == PURC_VARIANT_INVALID || !purc_variant_is_array(data) ||
+            purc_variant_is_frozen(data))
+        return 0;
+
+    if (nr == 0) {
+        purc_variant_t v = purc_variant_make_ulongint(400);
+        bool ok = purc_variant_array_append(data, v);
+        purc_variant_unref(v);
+        if (!ok)
+            return 0;
+    }
+
+    return purc_variant_array_get_size(data);
+}
+
+static void* receiver_entry(void* arg)
+{
+    struct receiver_arg *my_arg = (struct receiver_arg *)arg;
+    char runner_name[32];
+    int nr = my_arg->nr;
+
+    snprintf(runner_name, sizeof(runner_name), "receiver%d", nr);
+
+    int ret = purc_init_ex(PURC_MODULE_VARIANT, "cn.fmsoft.purc.test",
+            runner_name, NULL);
+    if (ret == PURC_ERROR_OK) {
+        purc_enable_log(false, false);
+        receiver_inst[nr] =
+            purc_inst_create_move_buffer(PCINST_MOVE_BUFFER_BROADCAST, 16);
+    }
+    sem_post(my_arg->wait);
+    if (ret != PURC_ERROR_OK)
+        return NULL;
+
+    if (nr > 0)
+        sem_wait(go);
+
+    uint64_t size = 0;
+    pcrdr_msg *msg = wait_for_message();
+    if (msg) {
+        size = check_payload(nr, msg->data);
+        pcrdr_release_message(msg);
+    }
+
+    /* report the number of members seen by this receiver */
+    pcrdr_msg *reply = pcrdr_make_event_message(
+            PCRDR_MSG_TARGET_INSTANCE, nr,
+            "done", NULL,
+            PCRDR_MSG_ELEMENT_TYPE_VOID, NULL, NULL,
+            PCRDR_MSG_DATA_TYPE_VOID, NULL, 0);
+    reply->dataType = PCRDR_MSG_DATA_TYPE_JSON;
+    reply->data = purc_variant_make_ulongint(size);
+    purc_inst_move_message(main_inst, reply);
+    pcrdr_release_message(reply);
+
+    purc_inst_destroy_move_buffer();
+    purc_cleanup();
+    return NULL;
+}
+
+static int create_receiver(int nr)
+{
+    int ret;
+    struct receiver_arg arg;
+    pthread_t th;
+
+    arg.nr = nr;
+ALLOW_DEPRECATED_DECLARATIONS_BEGIN
+    sem_unlink("sync-broadcast");
+    arg.wait = sem_open("sync-broadcast", O_CREAT | O_EXCL, 0644, 0);
+    if (arg.wait == SEM_FAILED) {
+        purc_log_error("failed to create semaphore: %s\n", strerror(errno));
+        return -1;
+    }
+    ret = pthread_create(&th, NULL, receiver_entry, &arg);
+    if (ret) {
+        sem_close(arg.wait);
+        purc_log_error("failed to create thread: %d\n", nr);
+        return -1;
+    }
+
+    sem_wait(arg.wait);
+    sem_close(arg.wait);
+ALLOW_DEPRECATED_DECLARATIONS_END
+
+    receiver_threads[nr] = th;
+    return ret;
+}
+
+/* the frozen payload of a broadcast is shared by the receivers until
+   each of them takes the message away and gets a private mutable copy */
+TEST(instance, broadcast_payload)
+{
+    int ret;
+
+    ret = purc_init_ex(PURC_MODULE_VARIANT, "cn.fmsoft.purc.test",
+            "broadcast", NULL);
+    ASSERT_EQ(ret, PURC_ERROR_OK);
+
+    purc_enable_log(true, false);
+
+    /* not a broadcast receiver itself */
+    main_inst = purc_inst_create_move_buffer(0, 16);
+    ASSERT_NE(main_inst, 0);
+
+ALLOW_DEPRECATED_DECLARATIONS_BEGIN
+    sem_unlink("go-broadcast");
+    go = sem_open("go-broadcast", O_CREAT | O_EXCL, 0644, 0);
+    ASSERT_NE(go, SEM_FAILED);
+ALLOW_DEPRECATED_DECLARATIONS_END
+
+    for (int i = 0; i < NR_RECEIVERS; i++) {
+        ASSERT_EQ(create_receiver(i), 0);
+        ASSERT_NE(receiver_inst[i], 0);
+    }
+
+    purc_variant_t arr = purc_variant_make_array_0();
+    for (int i = 0; i < NR_MEMBERS; i++) {
+        purc_variant_t v = purc_variant_make_ulongint((i + 1) * 100);
+        purc_variant_array_append(arr, v);
+        purc_variant_unref(v);
+    }
+
+    /* keep a reference to the payload to check the receivers release it */
+    purc_variant_t payload = purc_variant_freeze(arr);
+    purc_variant_unref(arr);
+    ASSERT_NE(payload, PURC_VARIANT_INVALID);
+    ASSERT_EQ(purc_variant_ref_count(payload), 1U);
+
+    pcrdr_msg *event;
+    event = pcrdr_make_event_message(
+            PCRDR_MSG_TARGET_INSTANCE, 1,
+            "test", NULL,
+            PCRDR_MSG_ELEMENT_TYPE_VOID, NULL, NULL,
+            PCRDR_MSG_DATA_TYPE_VOID, NULL, 0);
+    event->dataType = PCRDR_MSG_DATA_TYPE_JSON;
+    event->data = purc_variant_ref(payload);
+
+    ASSERT_EQ(purc_inst_move_message(PURC_EVENT_TARGET_BROADCAST, event),
+            (size_t)NR_RECEIVERS);
+    pcrdr_release_message(event);
+
+    /* the first receiver changes its copy of the payload */
+    pcrdr_msg *msg = wait_for_message();
+    ASSERT_NE(msg, nullptr);
+    ASSERT_EQ(msg->targetValue, 0U);
+    uint64_t size = 0;
+    ASSERT_TRUE(purc_variant_cast_to_ulongint(msg->data, &size, false));
+    ASSERT_EQ(size, (uint64_t)NR_MEMBERS + 1);
+    pcrdr_release_message(msg);
+
+    /* the others still get the original payload */
+    for (int i = 1; i < NR_RECEIVERS; i++)
+        sem_post(go);
+
+    for (int i = 1; i < NR_RECEIVERS; i++) {
+        msg = wait_for_message();
+        ASSERT_NE(msg, nullptr);
+        ASSERT_TRUE(purc_variant_cast_to_ulongint(msg->data, &size, false));
+        ASSERT_EQ(size, (uint64_t)NR_MEMBERS);
+        pcrdr_release_message(msg);
+    }
+
+    for (int i = 0; i < NR_RECEIVERS; i++)
+        pthread_join(receiver_threads[i], NULL);
+
+    /* all receivers released the shared payload */
+    ASSERT_EQ(purc_variant_ref_count(payload), 1U);
+    ASSERT_TRUE(purc_variant_is_frozen(payload));
+    ASSERT_EQ(purc_variant_array_get_size(payload), (size_t)NR_MEMBERS);
+    purc_variant_unref(payload);
+
+ALLOW_DEPRECATED_DECLARATIONS_BEGIN
+    sem_close(go);
+    sem_unlink("go-broadcast");
+ALLOW_DEPRECATED_DECLARATIONS_END
+
+    purc_inst_destroy_move_buffer();
+    purc_cleanup();
+}
+
@@ -895,3 +895,36 @@ TEST(interpreter, basic)
     purc_run(NULL);
 }
 
+
+TEST(interpreter, alloc_stat)
+{
+    const char *hvml =
+        "<hvml target=\"void\">"
+        "  <body>"
+        "    <iterate on 0 onlyif $L.lt($0<, 10) "
+        "        with $DATA.arith('+', $0<, 1) nosetotail>"
+        "      <test with $L.eq($?, 5)>"
+        "        <init as 'found' with true temp />"
+        "      </test>"
+        "    </iterate>"
+        "  </body>"
+        "</hvml>";
+
+    PurCInstance purc("cn.fmsoft.hybridos.test", "interpreter", false);
+    ASSERT_TRUE(purc);
+
+    struct purc_intr_alloc_stat stat;
+    ASSERT_EQ(purc_get_intr_alloc_stat(nullptr), -1);
+
+    purc_vdom_t vdom = purc_load_hvml_from_string(hvml);
+    ASSERT_NE(vdom, nullptr);
+    purc_schedule_vdom_null(vdom);
+    purc_run(NULL);
+
+    ASSERT_EQ(purc_get_intr_alloc_stat(&stat), 0);
+    ASSERT_GT(stat.nr_frames_allocated, 0);
+    ASSERT_GT(stat.nr_ctxts_allocated, 0);
+    /* the frames and contexts of the loop body are reused */
+    ASSERT_GT(stat.nr_frames_reused, 0);
+    ASSERT_GT(stat.nr_ctxts_reused, 0);
+}
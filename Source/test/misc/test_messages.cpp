@@ -21,6 +21,11 @@
 
 #include <stdio.h>
 #include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 #include <gtest/gtest.h>
 
 #define ATOM_BITS_NR        (sizeof(purc_atom_t) << 3)
@@ -93,3 +98,172 @@ TEST(instance, messages)
     purc_cleanup();
 }
 
+TEST(instance, event_messages)
+{
+    int ret = purc_init_ex(PURC_MODULE_VARIANT, NULL, NULL, NULL);
+    ASSERT_EQ(ret, PURC_ERROR_OK);
+
+    pcrdr_msg *msg;
+    msg = pcrdr_make_event_message(PCRDR_MSG_TARGET_SESSION,
+            random(), "change:attached", NULL,
+            PCRDR_MSG_ELEMENT_TYPE_VOID, NULL, NULL,
+            PCRDR_MSG_DATA_TYPE_VOID, NULL, 0);
+    ASSERT_NE(msg, nullptr);
+    ASSERT_NE(msg->eventTypeAtom, 0);
+    ASSERT_STREQ(purc_atom_to_string(msg->eventTypeAtom), "change");
+    ASSERT_STREQ(purc_variant_get_string_const(msg->eventName) +
+            msg->eventSubTypeOffset, "attached");
+
+    pcrdr_msg *msg_parsed;
+    struct buff_info info_a = { buffer_a, sizeof (buffer_a), 0 };
+
+    pcrdr_serialize_message(msg, write_to_buf, &info_a);
+    buffer_a[info_a.pos] = '\0';
+
+    ret = pcrdr_parse_packet(buffer_a, info_a.pos, &msg_parsed);
+    ASSERT_EQ(ret, 0);
+    ASSERT_EQ(msg_parsed->eventTypeAtom, msg->eventTypeAtom);
+    ASSERT_EQ(msg_parsed->eventSubTypeOffset, msg->eventSubTypeOffset);
+
+    pcrdr_msg *msg_cloned = pcrdr_clone_message(msg);
+    ASSERT_EQ(msg_cloned->eventTypeAtom, msg->eventTypeAtom);
+    ASSERT_EQ(msg_cloned->eventSubTypeOffset, msg->eventSubTypeOffset);
+
+    pcrdr_release_message(msg_cloned);
+    pcrdr_release_message(msg_parsed);
+    pcrdr_release_message(msg);
+
+    /* no sub type */
+    msg = pcrdr_make_event_message(PCRDR_MSG_TARGET_SESSION,
+            random(), "expired", NULL,
+            PCRDR_MSG_ELEMENT_TYPE_VOID, NULL, NULL,
+            PCRDR_MSG_DATA_TYPE_VOID, NULL, 0);
+    ASSERT_NE(msg, nullptr);
+    ASSERT_STREQ(purc_atom_to_string(msg->eventTypeAtom), "expired");
+    ASSERT_EQ(msg->eventSubTypeOffset, 0);
+    pcrdr_release_message(msg);
+
+    purc_cleanup();
+}
+
+/* more frames than the scheduler dispatches per pass, and more bytes than
+   the read-ahead buffer of the connection holds */
+#define NR_BURST_FRAMES         100
+#define NR_MSGS_PER_PASS        64
+
+struct burst_renderer {
+    int         listen_fd;
+    const char *packet;
+    size_t      len;
+};
+
+static void *burst_renderer_entry(void *arg)
+{
+    struct burst_renderer *rdr = (struct burst_renderer *)arg;
+    int fd = accept(rdr->listen_fd, NULL, NULL);
+    if (fd < 0)
+        return NULL;
+
+    size_t sz_frame = sizeof(USFrameHeader) + rdr->len;
+    char *frames = (char *)malloc(sz_frame * (NR_BURST_FRAMES + 1));
+    for (size_t i = 0; i <= NR_BURST_FRAMES; i++) {
+        USFrameHeader *header = (USFrameHeader *)(frames + sz_frame * i);
+        header->op = US_OPCODE_TEXT;
+        header->fragmented = 0;
+        header->sz_payload = rdr->len;
+        memcpy(header->payload, rdr->packet, rdr->len);
+    }
+
+    /* the initial response, then all events in one write */
+    if (write(fd, frames, sz_frame) == (ssize_t)sz_frame) {
+        ssize_t n = write(fd, frames + sz_frame, sz_frame * NR_BURST_FRAMES);
+        (void)n;
+    }
+    free(frames);
+
+    /* wait for the client to disconnect */
+    char c;
+    while (read(fd, &c, 1) > 0);
+    close(fd);
+    return NULL;
+}
+
+static void count_event(pcrdr_conn* conn, const pcrdr_msg *msg)
+{
+    (void)msg;
+    size_t *nr_events = (size_t *)pcrdr_conn_get_user_data(conn);
+    (*nr_events)++;
+}
+
+TEST(instance, drain_burst_of_frames)
+{
+    int ret = purc_init_ex(PURC_MODULE_VARIANT, "cn.fmsoft.hvml.test",
+            "messages", NULL);
+    ASSERT_EQ(ret, PURC_ERROR_OK);
+
+    pcrdr_msg *msg;
+    msg = pcrdr_make_event_message(PCRDR_MSG_TARGET_SESSION,
+            0, "change:attached", NULL,
+            PCRDR_MSG_ELEMENT_TYPE_VOID, NULL, NULL,
+            PCRDR_MSG_DATA_TYPE_VOID, NULL, 0);
+    ASSERT_NE(msg, nullptr);
+
+    struct buff_info info = { buffer_a, sizeof (buffer_a), 0 };
+    pcrdr_serialize_message(msg, write_to_buf, &info);
+    pcrdr_release_message(msg);
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path),
+            "/var/tmp/purc-test-burst-%d.sock", getpid());
+    unlink(addr.sun_path);
+
+    struct burst_renderer rdr = { -1, buffer_a, (size_t)info.pos };
+    rdr.listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(rdr.listen_fd, 0);
+    ASSERT_EQ(bind(rdr.listen_fd, (struct sockaddr *)&addr, sizeof(addr)), 0);
+    ASSERT_EQ(listen(rdr.listen_fd, 1), 0);
+
+    pthread_t thread;
+    ASSERT_EQ(pthread_create(&thread, NULL, burst_renderer_entry, &rdr), 0);
+
+    char uri[sizeof(addr.sun_path) + 8];
+    snprintf(uri, sizeof(uri), "unix://%s", addr.sun_path);
+
+    pcrdr_conn *conn = NULL;
+    msg = pcrdr_socket_connect(uri, "cn.fmsoft.hvml.test", "messages", &conn);
+    ASSERT_NE(msg, nullptr);
+    pcrdr_release_message(msg);
+
+    size_t nr_events = 0;
+    pcrdr_conn_set_user_data(conn, &nr_events);
+    pcrdr_conn_set_event_handler(conn, count_event);
+
+    /* dispatch the burst the way the scheduler does: wait on the fd only
+       if there is no buffered input, otherwise the frames left in the
+       read-ahead buffer would never be dispatched */
+    int nr_passes = 0;
+    while (nr_events < NR_BURST_FRAMES) {
+        if (!pcrdr_conn_has_buffered_input(conn)) {
+            struct pollfd pfd = { pcrdr_conn_fd(conn), POLLIN, 0 };
+            ASSERT_EQ(poll(&pfd, 1, 1000), 1);
+        }
+
+        ret = pcrdr_drain_and_dispatch_messages(conn, NR_MSGS_PER_PASS);
+        ASSERT_GT(ret, 0);
+        ASSERT_LE(ret, NR_MSGS_PER_PASS);
+        nr_passes++;
+    }
+
+    ASSERT_EQ(nr_events, NR_BURST_FRAMES);
+    ASSERT_GE(nr_passes, 2);
+    ASSERT_FALSE(pcrdr_conn_has_buffered_input(conn));
+
+    pcrdr_disconnect(conn);
+    pthread_join(thread, NULL);
+    close(rdr.listen_fd);
+    unlink(addr.sun_path);
+
+    purc_cleanup();
+}
@@ -27,6 +27,7 @@
 #include "private/rbtree.h"
 #include "private/atom-buckets.h"
 #include "private/sorted-array.h"
+#include "private/timer-wheel.h"
 #include "private/url.h"
 
 #include "../helpers.h"
@@ -473,6 +474,78 @@ TEST(utils, pcutils_sorted_array_desc)
     pcutils_sorted_array_destroy(sa);
 }
 
+struct twheel_item {
+    struct pcutils_twheel_node  node;
+    uint64_t                    expires;
+    int                         nr_fired;
+};
+
+static uint64_t twheel_now;
+
+static void
+twheel_on_expired(struct pcutils_twheel_node *node)
+{
+    struct twheel_item *item = (struct twheel_item *)node;
+    ASSERT_GE(twheel_now, item->expires);
+    item->nr_fired++;
+}
+
+TEST(utils, pcutils_twheel)
+{
+    static struct twheel_item items[1000];
+    static struct pcutils_twheel wheel;
+    size_t nr_items = PCA_TABLESIZE(items);
+
+    twheel_now = 1000;
+    pcutils_twheel_init(&wheel, twheel_now);
+    ASSERT_EQ(pcutils_twheel_next_expiry(&wheel), -1);
+
+    for (size_t i = 0; i < nr_items; i++) {
+        pcutils_twheel_node_init(&items[i].node, twheel_on_expired);
+        items[i].nr_fired = 0;
+        /* from 0ms to about 58 days, beyond the span of the wheel */
+        items[i].expires = twheel_now + i * i * i * 5;
+        pcutils_twheel_add(&wheel, &items[i].node, items[i].expires);
+    }
+    ASSERT_EQ(pcutils_twheel_count(&wheel), nr_items);
+
+    /* cancel every third one */
+    for (size_t i = 0; i < nr_items; i += 3) {
+        pcutils_twheel_remove(&wheel, &items[i].node);
+        ASSERT_FALSE(pcutils_twheel_node_is_pending(&items[i].node));
+    }
+
+    /* sleeping until the next expiry fires every node on time */
+    while (pcutils_twheel_count(&wheel) > 0) {
+        int64_t next = pcutils_twheel_next_expiry(&wheel);
+        ASSERT_GE(next, (int64_t)twheel_now);
+        twheel_now = next;
+        pcutils_twheel_expire(&wheel, twheel_now);
+    }
+
+    for (size_t i = 0; i < nr_items; i++) {
+        if (i % 3 == 0) {
+            ASSERT_EQ(items[i].nr_fired, 0);
+        }
+        else {
+            ASSERT_EQ(items[i].nr_fired, 1);
+        }
+    }
+
+    /* the nodes having the same deadline fire in one batch */
+    for (size_t i = 0; i < 10; i++) {
+        items[i].nr_fired = 0;
+        items[i].expires = twheel_now + 100000;
+        pcutils_twheel_add(&wheel, &items[i].node, items[i].expires);
+    }
+
+    twheel_now += 99999;
+    ASSERT_EQ(pcutils_twheel_expire(&wheel, twheel_now), 0);
+    twheel_now += 1;
+    ASSERT_EQ(pcutils_twheel_expire(&wheel, twheel_now), 10);
+    ASSERT_EQ(pcutils_twheel_count(&wheel), 0);
+}
+
 struct node
 {
     struct list_head          node;
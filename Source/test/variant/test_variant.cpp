@@ -25,6 +25,7 @@
 #include <stdio.h>
 #include <errno.h>
 #include <gtest/gtest.h>
+#include <algorithm>
 
 #ifndef MAX
 #define MAX(a, b)   (a) > (b)? (a) : (b)
@@ -65,12 +66,105 @@ TEST(variant, pcvariant_init_once)
     EXPECT_EQ (stat->sz_total_mem, 4 * size);
     EXPECT_EQ (stat->nr_reserved, 0);
     EXPECT_EQ (stat->nr_max_reserved, MAX_RESERVED_VARIANTS);
+    EXPECT_EQ (stat->nr_blocks_cached, 0);
+    EXPECT_EQ (stat->sz_blocks_cached, 0);
+    EXPECT_EQ (stat->nr_max_blocks_cached,
+            MAX_CACHED_BLOCKS * CACHE_NR_CLASSES);
 
 
     cleanup = purc_cleanup ();
     ASSERT_EQ (cleanup, true);
 }
 
+TEST(variant, pcvariant_cache_block_size)
+{
+    // a block is allocated in the full size of its class
+    EXPECT_EQ (pcvariant_cache_block_size (1), 16);
+    EXPECT_EQ (pcvariant_cache_block_size (16), 16);
+    EXPECT_EQ (pcvariant_cache_block_size (17), 32);
+    EXPECT_EQ (pcvariant_cache_block_size (sizeof(purc_variant)),
+            ((sizeof(purc_variant) + 15) / 16) * 16);
+    EXPECT_EQ (pcvariant_cache_block_size (CACHE_MAX_BLOCK_SIZE),
+            CACHE_MAX_BLOCK_SIZE);
+
+    // the others bypass the cache
+    EXPECT_EQ (pcvariant_cache_block_size (0), 0);
+    EXPECT_EQ (pcvariant_cache_block_size (CACHE_MAX_BLOCK_SIZE + 1),
+            CACHE_MAX_BLOCK_SIZE + 1);
+}
+
+TEST(variant, pcvariant_cache)
+{
+    purc_instance_extra_info info = {};
+    int ret = purc_init_ex (PURC_MODULE_VARIANT, "cn.fmsfot.hvml.test",
+            "variant", &info);
+    ASSERT_EQ (ret, PURC_ERROR_OK);
+
+    const struct purc_variant_stat * stat = purc_variant_usage_stat ();
+    ASSERT_NE(stat, nullptr);
+    ASSERT_EQ (stat->nr_max_blocks_cached,
+            MAX_CACHED_BLOCKS * CACHE_NR_CLASSES);
+
+    size_t nr_strings_before = stat->nr_values[PURC_VARIANT_TYPE_STRING];
+    size_t sz_strings_before = stat->sz_mem[PURC_VARIANT_TYPE_STRING];
+    size_t nr_reserved_before = stat->nr_reserved;
+
+    // the payloads of these strings are allocated from the cache
+    static const char str[] = "a string which is longer than the variant";
+    const size_t nr_strings = 8;
+    purc_variant_t arr = purc_variant_make_array (0, PURC_VARIANT_INVALID);
+    ASSERT_NE(arr, nullptr);
+    for (size_t i = 0; i < nr_strings; i++) {
+        purc_variant_t v = purc_variant_make_string (str, false);
+        ASSERT_NE(v, nullptr);
+        ASSERT_TRUE (v->flags & PCVRNT_FLAG_EXTRA_CACHED);
+        ASSERT_EQ (v->sz_ptr[0], sizeof(str));
+        ASSERT_TRUE (purc_variant_array_append (arr, v));
+        purc_variant_unref (v);
+    }
+
+    // a payload moved to another heap is not from the cache any more
+    purc_variant_t v = purc_variant_make_string (str, false);
+    purc_variant_t copy = purc_variant_ref (v);
+    purc_variant_t moved = pcvariant_move_heap_in (copy);
+    ASSERT_NE(moved, v);
+    ASSERT_FALSE (moved->flags & PCVRNT_FLAG_EXTRA_CACHED);
+    moved = pcvariant_move_heap_out (moved);
+    ASSERT_STREQ (purc_variant_get_string_const (moved), str);
+    purc_variant_unref (moved);
+    purc_variant_unref (v);
+
+    size_t nr_cached = stat->nr_blocks_cached;
+    purc_variant_unref (arr);
+
+    // the payloads are given back through the cache; only the reserved
+    // variants are still accounted in the memory used by strings
+    EXPECT_EQ (stat->nr_values[PURC_VARIANT_TYPE_STRING], nr_strings_before);
+    size_t sz_strings_left =
+        stat->sz_mem[PURC_VARIANT_TYPE_STRING] - sz_strings_before;
+    EXPECT_EQ (sz_strings_left % sizeof(purc_variant), 0U);
+    EXPECT_LE (sz_strings_left,
+            (stat->nr_reserved - nr_reserved_before) * sizeof(purc_variant));
+
+    // and kept up to the limit of the size class
+    size_t nr_expected = std::min(nr_strings, (size_t)MAX_CACHED_BLOCKS);
+    EXPECT_GE (stat->nr_blocks_cached, nr_cached + nr_expected);
+    EXPECT_LE (stat->nr_blocks_cached, stat->nr_max_blocks_cached);
+    EXPECT_GE (stat->sz_blocks_cached,
+            stat->nr_blocks_cached << CACHE_CLASS_SHIFT);
+
+    // a cached block is reused for a payload in the same size class
+    if (MAX_CACHED_BLOCKS > 0) {
+        nr_cached = stat->nr_blocks_cached;
+        v = purc_variant_make_string (str, false);
+        EXPECT_EQ (stat->nr_blocks_cached, nr_cached - 1);
+        purc_variant_unref (v);
+        EXPECT_EQ (stat->nr_blocks_cached, nr_cached);
+    }
+
+    ASSERT_TRUE (purc_cleanup ());
+}
+
 TEST(variant, pcvariant_init_10_times)
 {
     purc_instance_extra_info info = {};
@@ -1589,3 +1683,219 @@ TEST(variant, reuse_buff)
     purc_cleanup ();
 }
 
+
+TEST(variant, freeze)
+{
+    purc_instance_extra_info info = {};
+    int ret = purc_init_ex(PURC_MODULE_EJSON, "cn.fmsfot.hvml.test",
+            "variant", &info);
+    ASSERT_EQ (ret, PURC_ERROR_OK);
+
+    const struct purc_variant_stat *stat = purc_variant_usage_stat();
+    size_t nr_values = stat->nr_total_values;
+
+    const char *json =
+        "{ \"name\": \"a long string which is not a short one\", "
+        "\"list\": [1, 2.0, true, null, { \"k\": \"v\" }] }";
+    purc_variant_t v = purc_variant_make_from_json_string(json, strlen(json));
+    ASSERT_NE(v, PURC_VARIANT_INVALID);
+    ASSERT_FALSE(purc_variant_is_frozen(v));
+
+    purc_variant_t frozen = purc_variant_freeze(v);
+    ASSERT_NE(frozen, PURC_VARIANT_INVALID);
+    ASSERT_NE(frozen, v);
+    ASSERT_TRUE(purc_variant_is_frozen(frozen));
+    ASSERT_TRUE(purc_variant_is_equal_to(frozen, v));
+
+    purc_variant_t list = purc_variant_object_get_by_ckey(frozen, "list");
+    ASSERT_NE(list, PURC_VARIANT_INVALID);
+    ASSERT_TRUE(purc_variant_is_frozen(list));
+
+    /* frozen variants can not be changed */
+    purc_variant_t n = purc_variant_make_number(3.0);
+    ASSERT_FALSE(purc_variant_array_append(list, n));
+    ASSERT_FALSE(purc_variant_object_set_by_static_ckey(frozen, "n", n));
+    purc_variant_unref(n);
+
+    /* freezing a frozen variant gives a new reference */
+    purc_variant_t again = purc_variant_freeze(frozen);
+    ASSERT_EQ(again, frozen);
+    ASSERT_EQ(purc_variant_ref_count(frozen), 2);
+    purc_variant_unref(again);
+
+    /* frozen variants are accounted in the move heap */
+    purc_variant_unref(v);
+    ASSERT_EQ(purc_variant_usage_stat()->nr_total_values, nr_values);
+    purc_variant_unref(frozen);
+
+    purc_cleanup ();
+}
+
+TEST(variant, freeze_sort_shuffle)
+{
+    purc_instance_extra_info info = {};
+    int ret = purc_init_ex(PURC_MODULE_EJSON, "cn.fmsfot.hvml.test",
+            "variant", &info);
+    ASSERT_EQ (ret, PURC_ERROR_OK);
+
+    const char *json = "[3, 1, 2, [5, 4], { \"k\": \"v\" }]";
+    purc_variant_t v = purc_variant_make_from_json_string(json, strlen(json));
+    ASSERT_NE(v, PURC_VARIANT_INVALID);
+    purc_variant_t arr = purc_variant_freeze(v);
+    ASSERT_NE(arr, PURC_VARIANT_INVALID);
+
+    /* neither sorting nor shuffling changes a frozen array */
+    purc_clr_error();
+    ASSERT_EQ(pcvariant_array_sort(arr, NULL, NULL), -1);
+    ASSERT_EQ(purc_get_last_error(), PURC_ERROR_ACCESS_DENIED);
+
+    purc_clr_error();
+    ASSERT_EQ(pcvariant_array_swap(arr, 0, 1), -1);
+    ASSERT_EQ(purc_get_last_error(), PURC_ERROR_ACCESS_DENIED);
+
+    ASSERT_TRUE(purc_variant_is_equal_to(arr, v));
+    purc_variant_unref(v);
+
+    /* the members are frozen as well */
+    purc_clr_error();
+    ASSERT_EQ(pcvariant_array_sort(purc_variant_array_get(arr, 3),
+                NULL, NULL), -1);
+    ASSERT_EQ(purc_get_last_error(), PURC_ERROR_ACCESS_DENIED);
+    purc_variant_unref(arr);
+
+    purc_variant_t one = purc_variant_make_ulongint(1);
+    purc_variant_t two = purc_variant_make_ulongint(2);
+    v = purc_variant_make_tuple(2, NULL);
+    ASSERT_NE(v, PURC_VARIANT_INVALID);
+    ASSERT_TRUE(purc_variant_tuple_set(v, 0, one));
+    ASSERT_TRUE(purc_variant_tuple_set(v, 1, one));
+    purc_variant_t tuple = purc_variant_freeze(v);
+    ASSERT_NE(tuple, PURC_VARIANT_INVALID);
+    purc_variant_unref(v);
+
+    /* a frozen tuple can not be set, even with the same value */
+    purc_clr_error();
+    ASSERT_FALSE(purc_variant_tuple_set(tuple, 1, two));
+    ASSERT_EQ(purc_get_last_error(), PURC_ERROR_ACCESS_DENIED);
+    ASSERT_TRUE(purc_variant_is_equal_to(purc_variant_tuple_get(tuple, 1),
+                one));
+
+    purc_clr_error();
+    ASSERT_FALSE(purc_variant_tuple_set(tuple, 0,
+                purc_variant_tuple_get(tuple, 0)));
+    ASSERT_EQ(purc_get_last_error(), PURC_ERROR_ACCESS_DENIED);
+
+    purc_variant_unref(tuple);
+    purc_variant_unref(one);
+    purc_variant_unref(two);
+
+    purc_cleanup ();
+}
+
+TEST(variant, packed_array)
+{
+    purc_instance_extra_info info = {};
+    int ret = purc_init_ex(PURC_MODULE_EJSON, "cn.fmsfot.hvml.test",
+            "variant", &info);
+    ASSERT_EQ (ret, PURC_ERROR_OK);
+
+    /* more numbers than a block of the kernels */
+    purc_variant_t arr = purc_variant_make_array_0();
+    double sum = 0.0, dot = 0.0;
+    for (int i = 0; i < 100; i++) {
+        purc_variant_t v = purc_variant_make_number(i - 50);
+        ASSERT_TRUE(purc_variant_array_append(arr, v));
+        purc_variant_unref(v);
+        sum += i - 50;
+        dot += (i - 50) * (i - 50);
+    }
+
+    purc_variant_t packed;
+    packed = purc_variant_make_packed_array(PCVRNT_PACKED_TYPE_F64, arr);
+    ASSERT_NE(packed, PURC_VARIANT_INVALID);
+    ASSERT_TRUE(purc_variant_is_bsequence(packed));
+    size_t nr_bytes;
+    ASSERT_NE(purc_variant_get_bytes_const(packed, &nr_bytes), nullptr);
+    ASSERT_EQ(nr_bytes, 100 * sizeof(double));
+
+    double d;
+    ASSERT_TRUE(purc_variant_packed_reduce(packed, PCVRNT_PACKED_TYPE_F64,
+                PCVRNT_REDUCE_OP_SUM, &d));
+    ASSERT_EQ(d, sum);
+    ASSERT_TRUE(purc_variant_packed_reduce(packed, PCVRNT_PACKED_TYPE_F64,
+                PCVRNT_REDUCE_OP_MIN, &d));
+    ASSERT_EQ(d, -50.0);
+    ASSERT_TRUE(purc_variant_packed_reduce(packed, PCVRNT_PACKED_TYPE_F64,
+                PCVRNT_REDUCE_OP_MAX, &d));
+    ASSERT_EQ(d, 49.0);
+    ASSERT_TRUE(purc_variant_packed_dot(packed, packed,
+                PCVRNT_PACKED_TYPE_F64, &d));
+    ASSERT_EQ(d, dot);
+
+    /* the same results as the boxed members give */
+    double boxed;
+    ASSERT_TRUE(purc_variant_numeric_reduce(arr, PCVRNT_REDUCE_OP_MEAN,
+                &boxed));
+    ASSERT_TRUE(purc_variant_packed_reduce(packed, PCVRNT_PACKED_TYPE_F64,
+                PCVRNT_REDUCE_OP_MEAN, &d));
+    ASSERT_EQ(d, boxed);
+
+    /* a number is boxed only when fetched */
+    purc_variant_t v = purc_variant_packed_array_get(packed,
+            PCVRNT_PACKED_TYPE_F64, 7);
+    ASSERT_NE(v, PURC_VARIANT_INVALID);
+    ASSERT_TRUE(purc_variant_is_number(v));
+    ASSERT_TRUE(purc_variant_cast_to_number(v, &d, false));
+    ASSERT_EQ(d, -43.0);
+    purc_variant_unref(v);
+
+    purc_clr_error();
+    ASSERT_EQ(purc_variant_packed_array_get(packed,
+                PCVRNT_PACKED_TYPE_F64, 100), PURC_VARIANT_INVALID);
+    ASSERT_EQ(purc_get_last_error(), PURC_ERROR_OVERFLOW);
+    purc_variant_unref(packed);
+
+    /* longints; the element-wise arithmetic keeps them packed */
+    packed = purc_variant_make_packed_array(PCVRNT_PACKED_TYPE_I64, arr);
+    ASSERT_NE(packed, PURC_VARIANT_INVALID);
+    purc_variant_t ten = purc_variant_make_longint(10);
+    purc_variant_t result = pcvariant_numeric_arith('*', packed, ten);
+    purc_variant_unref(ten);
+    ASSERT_NE(result, PURC_VARIANT_INVALID);
+    ASSERT_TRUE(purc_variant_is_bsequence(result));
+    ASSERT_TRUE(purc_variant_packed_reduce(result, PCVRNT_PACKED_TYPE_I64,
+                PCVRNT_REDUCE_OP_SUM, &d));
+    ASSERT_EQ(d, sum * 10);
+
+    v = purc_variant_packed_array_get(result, PCVRNT_PACKED_TYPE_I64, 99);
+    ASSERT_NE(v, PURC_VARIANT_INVALID);
+    ASSERT_TRUE(purc_variant_is_longint(v));
+    int64_t i64;
+    ASSERT_TRUE(purc_variant_cast_to_longint(v, &i64, false));
+    ASSERT_EQ(i64, 490);
+    purc_variant_unref(v);
+    purc_variant_unref(result);
+
+    /* the sizes must match */
+    purc_variant_t empty = purc_variant_make_byte_sequence_empty();
+    purc_clr_error();
+    ASSERT_FALSE(purc_variant_packed_dot(packed, empty,
+                PCVRNT_PACKED_TYPE_I64, &d));
+    ASSERT_EQ(purc_get_last_error(), PURC_ERROR_INVALID_VALUE);
+    ASSERT_TRUE(purc_variant_packed_reduce(empty, PCVRNT_PACKED_TYPE_I64,
+                PCVRNT_REDUCE_OP_SUM, &d));
+    ASSERT_EQ(d, 0.0);
+    purc_variant_unref(empty);
+    purc_variant_unref(packed);
+
+    /* not a multiple of the size of the numbers */
+    packed = purc_variant_make_byte_sequence("abc", 3);
+    purc_clr_error();
+    ASSERT_FALSE(purc_variant_packed_reduce(packed, PCVRNT_PACKED_TYPE_U64,
+                PCVRNT_REDUCE_OP_SUM, &d));
+    ASSERT_EQ(purc_get_last_error(), PURC_ERROR_INVALID_VALUE);
+    purc_variant_unref(packed);
+
+    purc_variant_unref(arr);
+    purc_cleanup ();
+}
@@ -605,7 +605,9 @@ TEST(variant_set, generic)
     cleanup = purc_cleanup ();
     ASSERT_EQ (cleanup, true);
 
-    ASSERT_STREQ(inbuf, outbuf);
+    // members of objects are stringified in the order of insertion
+    ASSERT_STREQ(inbuf, "id:1\nname:foo\n\n");
+    ASSERT_STREQ(outbuf, "name:foo\nid:1\n\n");
 }
 
 TEST(variant_set, constraint_mutable_keyval)
@@ -1109,3 +1111,178 @@ TEST(variant, set)
     }
 }
 
+
+TEST(variant_set, index_remove)
+{
+    PurCInstance purc;
+
+    purc_variant_t set = purc_variant_make_set_by_ckey(0, NULL,
+            PURC_VARIANT_INVALID);
+    ASSERT_NE(set, nullptr);
+
+    char buf[32];
+    const int nr = 256;
+    for (int i = 0; i < nr; i++) {
+        snprintf(buf, sizeof(buf), "item-%d", i);
+        purc_variant_t v = purc_variant_make_string(buf, false);
+        ASSERT_EQ(purc_variant_set_add(set, v, PCVRNT_CR_METHOD_IGNORE), 1);
+        purc_variant_unref(v);
+    }
+
+    /* removing every other member shifts the probed entries back */
+    for (int i = 0; i < nr; i += 2) {
+        snprintf(buf, sizeof(buf), "item-%d", i);
+        purc_variant_t v = purc_variant_make_string(buf, false);
+        ASSERT_EQ(purc_variant_set_remove(set, v, PCVRNT_NR_METHOD_IGNORE), 1);
+        purc_variant_unref(v);
+    }
+    ASSERT_EQ(purc_variant_set_get_size(set), nr / 2);
+
+    /* the remaining members are still found, the removed ones are not */
+    for (int i = 0; i < nr; i++) {
+        snprintf(buf, sizeof(buf), "item-%d", i);
+        purc_variant_t v = purc_variant_make_string(buf, false);
+        ssize_t n = purc_variant_set_add(set, v, PCVRNT_CR_METHOD_IGNORE);
+        ASSERT_EQ(n, (i % 2) ? 0 : 1) << buf;
+        purc_variant_unref(v);
+    }
+    ASSERT_EQ(purc_variant_set_get_size(set), nr);
+    ASSERT_TRUE(sanity_check(set));
+
+    purc_variant_unref(set);
+}
+
+TEST(variant_set, index_order)
+{
+    PurCInstance purc;
+
+    purc_variant_t asc = purc_variant_make_set_by_ckey(0, NULL,
+            PURC_VARIANT_INVALID);
+    ASSERT_NE(asc, nullptr);
+    purc_variant_t desc = purc_variant_make_set_by_ckey(0, NULL,
+            PURC_VARIANT_INVALID);
+    ASSERT_NE(desc, nullptr);
+
+    char buf[32];
+    const int nr = 256;
+    for (int i = 0; i < nr; i++) {
+        snprintf(buf, sizeof(buf), "item-%03d", i);
+        purc_variant_t v = purc_variant_make_string(buf, false);
+        ASSERT_EQ(purc_variant_set_add(asc, v, PCVRNT_CR_METHOD_IGNORE), 1);
+        purc_variant_unref(v);
+
+        snprintf(buf, sizeof(buf), "item-%03d", nr - 1 - i);
+        v = purc_variant_make_string(buf, false);
+        ASSERT_EQ(purc_variant_set_add(desc, v, PCVRNT_CR_METHOD_IGNORE), 1);
+        purc_variant_unref(v);
+    }
+
+    /* the members are iterated in the order of the values, whatever the
+       order of insertion and the hashes are */
+    purc_variant_t sets[] = { asc, desc };
+    for (size_t n = 0; n < PCA_TABLESIZE(sets); n++) {
+        struct pcvrnt_set_iterator *it;
+        it = pcvrnt_set_iterator_create_begin(sets[n]);
+        ASSERT_NE(it, nullptr);
+        int i = 0;
+        do {
+            purc_variant_t v = pcvrnt_set_iterator_get_value(it);
+            snprintf(buf, sizeof(buf), "item-%03d", i++);
+            ASSERT_STREQ(purc_variant_get_string_const(v), buf);
+        } while (pcvrnt_set_iterator_next(it));
+        pcvrnt_set_iterator_release(it);
+        ASSERT_EQ(i, nr);
+    }
+
+    ASSERT_EQ(purc_variant_compare_ex(asc, desc,
+                PCVRNT_COMPARE_METHOD_AUTO), 0);
+
+    /* the sets compare by the members in order */
+    purc_variant_t v = purc_variant_make_string("item-000", false);
+    ASSERT_EQ(purc_variant_set_remove(desc, v, PCVRNT_NR_METHOD_IGNORE), 1);
+    purc_variant_unref(v);
+    ASSERT_LT(purc_variant_compare_ex(asc, desc,
+                PCVRNT_COMPARE_METHOD_AUTO), 0);
+    ASSERT_GT(purc_variant_compare_ex(desc, asc,
+                PCVRNT_COMPARE_METHOD_AUTO), 0);
+
+    purc_variant_unref(asc);
+    purc_variant_unref(desc);
+}
+
+TEST(variant_set, index_readjust)
+{
+    PurCInstance purc;
+
+    purc_variant_t set = purc_variant_make_set_by_ckey(0, "name",
+            PURC_VARIANT_INVALID);
+    ASSERT_NE(set, nullptr);
+
+    char buf[32];
+    const int nr = 64;
+    for (int i = 0; i < nr; i++) {
+        snprintf(buf, sizeof(buf), "{name:'m-%d', count:%d}", i, i);
+        purc_variant_t v = pcejson_parser_parse_string(buf, 0, 0);
+        ASSERT_NE(v, nullptr);
+        ASSERT_EQ(purc_variant_set_add(set, v, PCVRNT_CR_METHOD_COMPLAIN), 1);
+        purc_variant_unref(v);
+    }
+
+    /* renaming a member in place hashes it again */
+    for (int i = 0; i < nr; i++) {
+        snprintf(buf, sizeof(buf), "m-%d", i);
+        purc_variant_t k = purc_variant_make_string(buf, false);
+        purc_variant_t v = purc_variant_set_get_member_by_key_values(set, k);
+        purc_variant_unref(k);
+        ASSERT_NE(v, nullptr) << buf;
+
+        snprintf(buf, sizeof(buf), "n-%d", i);
+        k = purc_variant_make_string(buf, false);
+        ASSERT_TRUE(purc_variant_object_set_by_static_ckey(v, "name", k));
+        purc_variant_unref(k);
+    }
+
+    for (int i = 0; i < nr; i++) {
+        snprintf(buf, sizeof(buf), "m-%d", i);
+        purc_variant_t k = purc_variant_make_string(buf, false);
+        purc_variant_t v = purc_variant_set_get_member_by_key_values(set, k);
+        purc_variant_unref(k);
+        ASSERT_EQ(v, nullptr) << buf;
+        purc_clr_error();
+
+        snprintf(buf, sizeof(buf), "n-%d", i);
+        k = purc_variant_make_string(buf, false);
+        v = purc_variant_set_get_member_by_key_values(set, k);
+        purc_variant_unref(k);
+        ASSERT_NE(v, nullptr) << buf;
+
+        purc_variant_t c = purc_variant_object_get_by_ckey(v, "count");
+        int64_t i64;
+        ASSERT_TRUE(purc_variant_cast_to_longint(c, &i64, false));
+        ASSERT_EQ(i64, i);
+    }
+    ASSERT_EQ(purc_variant_set_get_size(set), nr);
+
+    purc_variant_unref(set);
+}
+
+TEST(variant_set, index_caseless)
+{
+    PurCInstance purc;
+
+    purc_variant_t set = purc_variant_make_set_by_ckey_ex(0, NULL, true,
+            PURC_VARIANT_INVALID);
+    ASSERT_NE(set, nullptr);
+
+    const char *strs[] = { "Hello", "hELLO", "Grüße", "GRüßE", "Grüsse" };
+    const ssize_t added[] = { 1, 0, 1, 0, 1 };
+    for (size_t i = 0; i < PCA_TABLESIZE(strs); i++) {
+        purc_variant_t v = purc_variant_make_string(strs[i], false);
+        ASSERT_EQ(purc_variant_set_add(set, v, PCVRNT_CR_METHOD_IGNORE),
+                added[i]) << strs[i];
+        purc_variant_unref(v);
+    }
+    ASSERT_EQ(purc_variant_set_get_size(set), 3);
+
+    purc_variant_unref(set);
+}
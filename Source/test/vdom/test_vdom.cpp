@@ -143,3 +143,42 @@ TEST(vdom, fragment)
     }
 }
 
+
+TEST(vdom, clone)
+{
+    PurCInstance purc("cn.fmsoft.hybridos.test", "test_init", false);
+
+    struct pcvdom_element *elem = pcvdom_element_create_c("define");
+    ASSERT_NE(elem, nullptr);
+
+    struct pcvdom_attr *attr;
+    attr = pcvdom_attr_create("as", PCHVML_ATTRIBUTE_OPERATOR, NULL);
+    ASSERT_NE(attr, nullptr);
+    ASSERT_EQ(0, pcvdom_element_append_attr(elem, attr));
+
+    struct pcvdom_element *child = pcvdom_element_create_c("init");
+    ASSERT_NE(child, nullptr);
+    EXPECT_EQ(0, pcvdom_element_append_element(elem, child));
+
+    struct pcvdom_comment *comment = pcvdom_comment_create("hello world");
+    ASSERT_NE(comment, nullptr);
+    EXPECT_EQ(0, pcvdom_element_append_comment(child, comment));
+
+    struct pcvdom_node *cloned;
+    cloned = pcvdom_node_clone(pcvdom_node_from_element(elem));
+    ASSERT_NE(cloned, nullptr);
+    EXPECT_NE(cloned, pcvdom_node_from_element(elem));
+    EXPECT_EQ(cloned->type, PCVDOM_NODE_ELEMENT);
+
+    struct pcvdom_element *elem_cloned;
+    elem_cloned = container_of(cloned, struct pcvdom_element, node);
+    EXPECT_EQ(pcvdom_element_parent(elem_cloned), nullptr);
+    EXPECT_NE(pcvdom_element_find_attr(elem_cloned, "as"), nullptr);
+
+    int nodes = 0;
+    EXPECT_EQ(0, pcvdom_node_traverse(cloned, &nodes, _node_count));
+    EXPECT_EQ(nodes, 3);
+
+    pcvdom_node_destroy(pcvdom_node_from_element(elem));
+    pcvdom_node_destroy(cloned);
+}